@@ -0,0 +1,63 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace fianchetto {
+
+// Finished search result for one position
+struct Analysis {
+    Move best_move;
+    int score = 0;         // side to move's point of view
+    int depth = 0;         // last completed iteration
+    std::vector<Move> pv;
+};
+
+struct AnalysisCacheStats {
+    uint64_t hits;    // answered from the cache
+    uint64_t resumed; // cached, but deepened further
+    uint64_t misses;
+    uint64_t entries;
+};
+
+// Results of earlier searches keyed by position hash, so repeated queries
+// (page reloads, browsing back through a game) cost nothing: a lookup is
+// answered outright when the cached depth is enough, and otherwise gives
+// the line to seed the table with before deepening from depth + 1.
+// Bounded (0 entries disables it); the least recently used entry is
+// evicted. Thread-safe.
+class AnalysisCache {
+public:
+    explicit AnalysisCache(size_t max_entries = 100000);
+
+    // Result for `hash` if one exists. Counts a hit when it reaches
+    // `depth`, a resume when it is shallower.
+    bool probe(uint64_t hash, int depth, Analysis& analysis);
+
+    // Keep `analysis` unless a deeper result is already cached
+    void store(uint64_t hash, const Analysis& analysis);
+
+    void clear();
+    AnalysisCacheStats stats();
+
+private:
+    struct Entry {
+        uint64_t hash;
+        Analysis analysis;
+    };
+
+    size_t max_entries_;
+    std::mutex mutex_;
+    std::list<Entry> lru_; // most recent first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+    uint64_t hits_;
+    uint64_t resumed_;
+    uint64_t misses_;
+};
+
+} // namespace fianchetto
@@ -1,21 +1,53 @@
 #pragma once
 
 #include "types.hpp"
-#include <string>
+#include "nnue.hpp"
 #include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
 #include <vector>
 
 
 namespace fianchetto {
 
+// Why a FEN (or the position part of an EPD line) was rejected
+enum class FenError {
+    NONE,
+    PLACEMENT,   // Bad piece letter, or a rank that does not hold 8 squares
+    KINGS,       // A side without exactly one king
+    PAWN_RANK,   // Pawn on the first or last rank
+    SIDE,        // Side to move not "w" or "b"
+    CASTLING,    // Not "-" or a set of distinct letters from "KQkq"
+    EN_PASSANT,  // Not "-" or an empty square on the 3rd/6th rank behind the pawn that moved
+    CLOCKS,      // Move counters that are not numbers
+    OPERATION,   // EPD: unterminated or malformed operation
+    MOVE,        // EPD: "bm"/"am" move that is not legal in the position
+};
+
+const char* fen_error_string(FenError error);
+
+// Longest FEN write_fen produces, with its terminating NUL
+constexpr size_t FEN_BUFFER_SIZE = 128;
+
 class Board {
 public:
     Board();
-    Board(const std::string& fen);
-
-    // FEN operations
-    void set_fen(const std::string& fen);
+    Board(std::string_view fen);
+
+    // FEN operations. parse_fen validates and leaves the board unchanged on
+    // error; the move counters are optional and default to "0 1". Parsing
+    // stops after the last field it reads, and `consumed` (if given)
+    // receives that offset, e.g. where the operations of an EPD line start.
+    // Castling rights whose king or rook is not on its home square are
+    // dropped. set_fen is parse_fen without the error.
+    FenError parse_fen(std::string_view fen, size_t* consumed = nullptr);
+    void set_fen(std::string_view fen);
     std::string get_fen() const;
+    // FEN into `out` with a terminating NUL, without the move counters if
+    // `counters` is false (the EPD position fields). Returns the length, or
+    // 0 if it does not fit; FEN_BUFFER_SIZE always does.
+    size_t write_fen(char* out, size_t size, bool counters = true) const;
 
     // Piece operations
     PieceType piece_on(Square sq) const;
@@ -51,14 +83,36 @@ public:
     // Make/unmake moves
     void make_move(Move move);
     void unmake_move(Move move);
+    void make_null_move();
+    void unmake_null_move();
 
     // Check detection
     bool in_check(Color color) const;
+    bool is_square_attacked(Square sq, Color by) const;
     bool is_legal_move(Move move) const;
 
     // Zobrist hashing
     uint64_t hash() const { return hash_key_; }
     void update_hash();
+    // Digest of every Zobrist key; differs whenever hashes would (used to
+    // reject transposition table snapshots from another key set)
+    static uint64_t zobrist_fingerprint();
+
+    // NNUE: attach a network (nullptr detaches) to keep its accumulator
+    // updated incrementally in make_move/unmake_move
+    void set_network(const nnue::Network* net);
+    const nnue::Network* network() const { return nnue_; }
+    const nnue::Accumulator& accumulator() const { return nnue_stack_.back(); }
+
+    // Draw detection. `ply` is the distance from the search root: a position
+    // repeated inside the search counts as a draw on its first repetition,
+    // one repeated only in the game history needs the full threefold.
+    bool is_draw(int ply) const;
+    bool is_repetition(int ply) const;
+
+    // True if the side to move has a reversible move that reaches a position
+    // already on the search path (detected via the cuckoo tables)
+    bool has_game_cycle(int ply) const;
 
 private:
     // Bitboards: [color][piece_type]
@@ -74,6 +128,7 @@ private:
     Square ep_square_;
     int halfmove_clock_;
     int fullmove_number_;
+    int plies_from_null_; // Repetitions cannot span a null move
 
     // Zobrist hash
     uint64_t hash_key_;
@@ -86,9 +141,14 @@ private:
         bool castle_queenside[2];
         Square ep_square;
         int halfmove_clock;
-        uint64_t hash_key;
+        int plies_from_null;
+        uint64_t hash_key; // Hash of the position before the move
     };
-    std::vector<MoveInfo> history_;
+    std::vector<MoveInfo> history_; // Spans the game moves and the current search path
+
+    // NNUE accumulators, one per position on history_ plus the current one
+    const nnue::Network* nnue_;
+    std::vector<nnue::Accumulator> nnue_stack_;
 
 
     // Zobrist keys
@@ -97,8 +157,18 @@ private:
     static std::array<uint64_t, 8> zobrist_en_passant_;
     static uint64_t zobrist_side_;
 
+    // Cuckoo tables of reversible piece moves, keyed by the Zobrist difference
+    // between the positions before and after the move
+    static std::array<uint64_t, 8192> cuckoo_keys_;
+    static std::array<Move, 8192> cuckoo_moves_;
+    static std::array<std::array<Bitboard, 64>, 64> between_;
+
+    static int cuckoo_h1(uint64_t key) { return key & 0x1FFF; }
+    static int cuckoo_h2(uint64_t key) { return (key >> 16) & 0x1FFF; }
+
     static void init_zobrist();
-    static bool zobrist_initialized_;
+    static void generate_zobrist();
+    static void init_cuckoo();
 };
 
 } // namespace fianchetto
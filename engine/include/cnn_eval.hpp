@@ -0,0 +1,68 @@
+#pragma once
+
+#include "board.hpp"
+#include <span>
+#include <string>
+#include <vector>
+
+namespace fianchetto {
+namespace cnn {
+
+// Native CPU inference of ChessEvalModel (neural/src/model.py):
+// three 3x3 convolutions (12 -> 64 -> 128 -> 128, ReLU) followed by
+// fc 8192 -> hidden -> hidden -> 1. Convolutions run as im2col + GEMM over
+// whole batches of positions.
+constexpr int PLANES = 12;
+constexpr int CONV1 = 64;
+constexpr int CONV2 = 128;
+constexpr int CONV3 = 128;
+
+// Weight file format (little endian float32), see neural/src/export_native.py:
+//   char[4]  magic "FCNN"
+//   uint32   version, hidden_dim
+//   float32  conv1.weight[64][12][3][3], conv1.bias[64]
+//   float32  conv2.weight[128][64][3][3], conv2.bias[128]
+//   float32  conv3.weight[128][128][3][3], conv3.bias[128]
+//   float32  fc1.weight[hidden][128 * 8 * 8], fc1.bias[hidden]
+//   float32  fc2.weight[hidden][hidden], fc2.bias[hidden]
+//   float32  fc3.weight[1][hidden], fc3.bias[1]
+// i.e. the PyTorch state_dict tensors in declaration order.
+constexpr char FILE_MAGIC[4] = {'F', 'C', 'N', 'N'};
+constexpr uint32_t FILE_VERSION = 1;
+
+// Write the 12x8x8 planes of neural/src/encode.py (plane = color * 6 +
+// piece - 1, row 0 = rank 8) into `out` (768 floats)
+void encode_planes(const Board& board, float* out);
+
+class Model {
+public:
+    Model();
+
+    // Returns false (and keeps the previous weights) on a missing or malformed file
+    bool load(const std::string& path);
+    bool loaded() const { return loaded_; }
+
+    // Centipawn scores from white's perspective, same scale as the neural
+    // service's /evaluate endpoint. Thread-safe.
+    std::vector<int> evaluate(std::span<const Board* const> boards) const;
+    int evaluate(const Board& board) const;
+
+private:
+    // Dense layer with weights stored transposed ([in][out]) for the GEMM kernel
+    struct Layer {
+        int in = 0;
+        int out = 0;
+        std::vector<float> weights;
+        std::vector<float> bias;
+    };
+
+    bool loaded_;
+    int hidden_;
+    Layer conv1_, conv2_, conv3_;
+    Layer fc1_, fc2_, fc3_;
+
+    void forward(const Board* const* boards, int count, int* scores) const;
+};
+
+} // namespace cnn
+} // namespace fianchetto
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "analysis_cache.hpp"
+#include "board.hpp"
+#include "http_server.hpp"
+#include "nnue.hpp"
+#include "search.hpp"
+#include "search_scheduler.hpp"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace fianchetto {
+
+struct EngineServerOptions {
+    int workers = 4;            // Search threads shared by all requests
+    int max_requests = 64;      // Requests handled at once (waiting on or running a search)
+    size_t hash_mb = 16;        // Transposition table per session (and per running anonymous search)
+    size_t max_sessions = 64;   // Least recently used sessions are dropped beyond this
+    size_t analysis_cache_entries = 100000; // Finished results kept for repeated queries
+    int default_depth = 6;
+    int max_depth = 20;
+    int max_movetime_ms = 60000;
+    int max_priority = 8;
+    int max_multipv = 16;       // Lines a /analyse request may ask for
+    int max_game_plies = 1000;  // Moves an /analysegame request may carry
+    int game_tasks = 2;         // Positions of one /analysegame request queued at once (at most workers)
+    bool pin_threads = false;   // Spread search threads over the NUMA nodes
+    std::string hash_file;      // Transposition table snapshot: loaded into new tables, written by /hash/save
+};
+
+// HTTP/JSON front end for the web app (fianchetto_server):
+//   POST /move     {"fen", "depth"?, "movetime"?, "nodes"?, "priority"?, "session"?} -> best move
+//   POST /analyse  same body -> best move, score, depth, nodes and PV
+//   POST /analysegame {"pgn"} or {"fen", "moves"}, plus "depth"?, "movetime"?,
+//                 "blunder"?, "session"? -> score, best move and loss per move
+//   GET  /health
+//   POST /hash/save {"session"} -> write that session's table to hash_file
+// HTTP workers only parse and wait: the searches themselves share the
+// SearchScheduler's fixed thread pool, with movetime as the deadline,
+// nodes as the budget and priority (1..max_priority) deciding who goes
+// first under time pressure. Requests that carry a session id reuse that
+// session's transposition table, so consecutive moves of one game start
+// from a warm table; requests for the same session are searched one at a
+// time. Requests without a session borrow a pooled table.
+// Every result is kept in an AnalysisCache shared by all sessions: a
+// repeated position is answered without searching when the cached depth
+// is enough, and otherwise deepened from where the last search stopped.
+class EngineServer {
+public:
+    EngineServer(const EngineServerOptions& options, const nnue::Network* network = nullptr);
+
+    bool listen(const std::string& host, int port) { return http_.listen(host, port); }
+    int port() const { return http_.port(); }
+    void run() { http_.run(); }
+    void stop() { http_.stop(); }
+
+    HttpResponse handle(const HttpRequest& request);
+
+    size_t session_count();
+
+private:
+    struct Session {
+        std::mutex mutex;
+        std::unique_ptr<TranspositionTable> tt;
+        uint64_t last_used = 0;
+
+        Session(size_t hash_mb, const std::string& hash_file)
+            : tt(hash_file.empty() ? std::make_unique<TranspositionTable>(hash_mb)
+                                   : TranspositionTable::open_snapshot(hash_file, hash_mb)) {}
+    };
+
+    EngineServerOptions options_;
+    const nnue::Network* network_;
+
+    std::mutex sessions_mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Session>> sessions_;
+    uint64_t clock_;
+
+    AnalysisCache analysis_cache_;
+    SearchScheduler scheduler_;
+    HttpServer http_;
+
+    std::shared_ptr<Session> acquire_session(const std::string& id);
+    HttpResponse search(const HttpRequest& request, bool analyse);
+    HttpResponse review_game(const HttpRequest& request);
+    HttpResponse save_hash(const HttpRequest& request);
+};
+
+} // namespace fianchetto
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "board.hpp"
+#include "types.hpp"
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace fianchetto {
+namespace epd {
+
+// One "opcode operand;" operation. Both point into the parsed line (or
+// into caller-owned text when building a record to write); string
+// operands ("id", "c0".."c9") are stored without their quotes.
+struct Operation {
+    std::string_view opcode;
+    std::string_view operand;
+};
+
+// The operations of an EPD line, held in fixed arrays so records can be
+// parsed in a loop without allocating. Operations beyond the capacity are
+// dropped, as are "bm"/"am" moves beyond MAX_MOVES.
+struct Record {
+    static constexpr size_t MAX_OPERATIONS = 16;
+    static constexpr size_t MAX_MOVES = 8;
+
+    std::array<Operation, MAX_OPERATIONS> operations;
+    size_t operation_count = 0;
+
+    // Decoded "bm" (best moves) and "am" (avoid moves)
+    std::array<Move, MAX_MOVES> best_moves;
+    size_t best_move_count = 0;
+    std::array<Move, MAX_MOVES> avoid_moves;
+    size_t avoid_move_count = 0;
+
+    std::string_view id;      // "id", empty if absent
+    std::string_view comment; // "c0", empty if absent
+
+    // First operation with `opcode`, nullptr if absent
+    const Operation* find(std::string_view opcode) const;
+    // Append an operation; false if the record is full
+    bool add(std::string_view opcode, std::string_view operand);
+};
+
+// Parse an EPD line: the four position fields into `board` and the
+// operations into `record`. A full FEN (with move counters) is accepted
+// too, and "hmvc"/"fmvn" operations set the counters. "bm"/"am" moves are
+// SAN, as in the standard test suites. `record` refers into `line`, which
+// must outlive it. On an operation error `board` already holds the
+// position.
+FenError parse(std::string_view line, Board& board, Record& record);
+
+// Position fields of `board` followed by the record's operations, in
+// order, with a terminating NUL. Returns the length, or 0 if it does not
+// fit in `size`.
+size_t write(const Board& board, const Record& record, char* out, size_t size);
+
+} // namespace epd
+} // namespace fianchetto
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "platform.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace fianchetto {
+
+// Cache statistics (counters are approximate under concurrent use)
+struct EvalCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t stores;
+    uint64_t entries;  // occupied slots
+    uint64_t capacity; // total slots
+
+    double hit_rate() const {
+        uint64_t probes = hits + misses;
+        return probes ? static_cast<double>(hits) / probes : 0.0;
+    }
+    double occupancy() const {
+        return capacity ? static_cast<double>(entries) / capacity : 0.0;
+    }
+};
+
+// Fixed-capacity, set-associative cache of evaluation scores keyed by
+// position hash. Safe to share between search threads without locks:
+// each slot stores (key ^ data, data) and a read only counts as a hit when
+// the two words verify against the probed key, so a torn write is seen as
+// a miss. Replacement evicts the slot with the oldest generation.
+class EvalCache {
+public:
+    static constexpr int BUCKET_SIZE = 4; // slots per 64-byte bucket
+    static constexpr int SHARDS = 16;     // independent generations and counters
+
+    EvalCache(size_t size_mb = 16);
+
+    bool probe(uint64_t hash, int& score);
+    void store(uint64_t hash, int score);
+    void clear();
+
+    EvalCacheStats stats() const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> key_xor_data;
+        std::atomic<uint64_t> data; // [32 score][8 generation][1 valid]
+    };
+
+    struct alignas(64) Bucket {
+        Slot slots[BUCKET_SIZE];
+    };
+
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> hits;
+        std::atomic<uint64_t> misses;
+        std::atomic<uint64_t> stores;
+        std::atomic<uint64_t> entries;
+        std::atomic<uint8_t> generation;
+    };
+
+    platform::LargeBuffer memory_;
+    Bucket* buckets_;
+    Shard shards_[SHARDS];
+    size_t shard_buckets_; // buckets per shard (power of two)
+
+    Bucket& bucket_for(uint64_t hash, Shard*& shard);
+};
+
+} // namespace fianchetto
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "board.hpp"
+#include "eval_cache.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace fianchetto {
+
+// Binary position encoding shared with the neural service's /evaluate_batch:
+// 12 little-endian bitboards (white P, N, B, R, Q, K, then black) followed
+// by a state byte (bit 0: black to move, bits 1-4: castling rights K, Q, k, q)
+constexpr size_t BINARY_POSITION_SIZE = 12 * 8 + 1;
+
+void encode_binary_position(const Board& board, uint8_t* out);
+
+// Pipeline statistics
+struct EvalPipelineStats {
+    uint64_t submitted; // positions accepted into the queue
+    uint64_t dropped;   // prefetches rejected because the queue was full
+    uint64_t batches;   // requests sent to the backend
+    uint64_t evaluated; // positions scored by the backend
+    uint64_t failures;  // failed backend requests
+    uint64_t expired;   // requests whose deadline passed before they were sent
+};
+
+// Asynchronous leaf evaluation: callers queue positions without blocking,
+// a dedicated I/O thread groups them into batches for the backend and
+// publishes the scores to an EvalCache (and to any waiting futures).
+// Scores are centipawns from white's perspective.
+class EvalPipeline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Scores `count` encoded positions within `timeout_ms` (0 = backend
+    // default); returns false on failure
+    using BatchFn = std::function<bool(const uint8_t* positions, size_t count, int* scores, long timeout_ms)>;
+
+    EvalPipeline(BatchFn backend, EvalCache& cache, size_t max_batch = 64,
+                 size_t max_queue = 4096, int max_wait_us = 500);
+    ~EvalPipeline();
+
+    EvalPipeline(const EvalPipeline&) = delete;
+    EvalPipeline& operator=(const EvalPipeline&) = delete;
+
+    // Score for `board` when it is ready; the classical evaluation if the
+    // backend fails or `deadline` passes first
+    std::future<int> submit(const Board& board, Clock::time_point deadline = Clock::time_point::max());
+
+    // Fire-and-forget request whose result only lands in the cache.
+    // Positions already cached or in flight are skipped; non-urgent
+    // prefetches are dropped while the queue is full, and requests still
+    // queued at their deadline are discarded.
+    void prefetch(const Board& board, bool urgent = false,
+                  Clock::time_point deadline = Clock::time_point::max());
+
+    // Non-blocking lookup of a finished result
+    bool probe(const Board& board, int& score) { return cache_.probe(board.hash(), score); }
+
+    EvalPipelineStats stats() const;
+
+private:
+    struct Request {
+        uint64_t hash;
+        uint8_t position[BINARY_POSITION_SIZE];
+        Clock::time_point deadline;
+        std::optional<std::promise<int>> promise;
+        int fallback; // classical score for the promise, white's perspective
+    };
+
+    BatchFn backend_;
+    EvalCache& cache_;
+    size_t max_batch_;
+    size_t max_queue_;
+    int max_wait_us_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Request> queue_;
+    std::unordered_set<uint64_t> in_flight_;
+    bool stop_;
+
+    std::atomic<uint64_t> submitted_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> batches_;
+    std::atomic<uint64_t> evaluated_;
+    std::atomic<uint64_t> failures_;
+    std::atomic<uint64_t> expired_;
+
+    std::thread worker_;
+
+    void run();
+};
+
+} // namespace fianchetto
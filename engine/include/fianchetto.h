@@ -0,0 +1,119 @@
+#ifndef FIANCHETTO_H
+#define FIANCHETTO_H
+
+/*
+ * C API of libfianchetto, for embedding the engine in another runtime
+ * (e.g. a Node N-API addon) without a network or process hop.
+ *
+ * An engine handle owns a position, a transposition table and at most one
+ * running search. The table carries over from one search to the next, so
+ * consecutive moves of a game start warm. Every function may be called
+ * from any thread; calls on one handle are serialized internally. Searches
+ * run on a thread owned by the handle and report through callbacks invoked
+ * on that thread.
+ *
+ * Squares and moves use UCI coordinate notation ("e2e4", "e7e8q").
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#define FIANCHETTO_API __declspec(dllexport)
+#else
+#define FIANCHETTO_API __attribute__((visibility("default")))
+#endif
+
+/* Bumped whenever a declaration below changes incompatibly */
+#define FIANCHETTO_API_VERSION 1
+
+typedef enum fianchetto_status {
+    FIANCHETTO_OK = 0,
+    FIANCHETTO_INVALID_ARGUMENT = 1, /* NULL handle or pointer, or a buffer too small */
+    FIANCHETTO_INVALID_POSITION = 2, /* FEN rejected by the parser */
+    FIANCHETTO_ILLEGAL_MOVE = 3,     /* A move of the list is not legal; the position is unchanged */
+    FIANCHETTO_BUSY = 4,             /* A search is running on the handle */
+    FIANCHETTO_NO_RESOURCES = 5      /* The search thread could not be started */
+} fianchetto_status;
+
+typedef struct fianchetto_engine fianchetto_engine;
+
+/* Search limits; 0 means no limit. With no limit at all the search stops
+ * at depth 8. */
+typedef struct fianchetto_limits {
+    int depth;
+    int movetime_ms;
+    uint64_t nodes;
+} fianchetto_limits;
+
+/* Progress (after each completed iteration) or final result of a search.
+ * The strings are owned by the engine and valid during the callback only. */
+typedef struct fianchetto_info {
+    int depth;
+    int score;         /* Centipawns for the side to move */
+    int mate;          /* Moves to mate (negative when mated), 0 if none */
+    uint64_t nodes;
+    uint64_t time_ms;
+    uint64_t nps;
+    const char* bestmove; /* Empty when the side to move has no legal move */
+    const char* pv;       /* Space-separated moves */
+} fianchetto_info;
+
+typedef void (*fianchetto_callback)(const fianchetto_info* info, void* user_data);
+
+/* Totals over the handle's lifetime */
+typedef struct fianchetto_stats {
+    uint64_t searches;
+    uint64_t nodes;
+    uint64_t time_ms;
+    int searching; /* 1 while a search is running */
+} fianchetto_stats;
+
+FIANCHETTO_API int fianchetto_api_version(void);
+
+/* New engine at the start position with a `hash_mb` table (0 = 16 MB);
+ * NULL if the table cannot be allocated */
+FIANCHETTO_API fianchetto_engine* fianchetto_create(size_t hash_mb);
+
+/* Stops a running search (its completion callback still runs) and frees
+ * the handle */
+FIANCHETTO_API void fianchetto_destroy(fianchetto_engine* engine);
+
+/* Position from `fen` (NULL or "startpos" for the start position) followed
+ * by `moves`, a space-separated list (may be NULL) */
+FIANCHETTO_API fianchetto_status fianchetto_set_position(fianchetto_engine* engine, const char* fen,
+                                                         const char* moves);
+
+/* Current position as FEN into `out` (NUL-terminated) */
+FIANCHETTO_API fianchetto_status fianchetto_get_fen(fianchetto_engine* engine, char* out, size_t size);
+
+/* Start searching the current position and return immediately.
+ * `on_progress` (may be NULL) runs after each iteration and `on_done`
+ * (may be NULL) exactly once with the result, both on the search thread
+ * and with `user_data`. The handle stays busy until `on_done` returns, so
+ * the callbacks must not call fianchetto_wait or fianchetto_destroy on
+ * it. Other handles may be searching at the same time. */
+FIANCHETTO_API fianchetto_status fianchetto_search(fianchetto_engine* engine, const fianchetto_limits* limits,
+                                                   fianchetto_callback on_progress, fianchetto_callback on_done,
+                                                   void* user_data);
+
+/* Ask a running search to finish early; it reports its best move so far */
+FIANCHETTO_API void fianchetto_stop(fianchetto_engine* engine);
+
+/* Block until the running search (if any) has called `on_done` */
+FIANCHETTO_API void fianchetto_wait(fianchetto_engine* engine);
+
+/* Forget the transposition table contents (FIANCHETTO_BUSY while searching) */
+FIANCHETTO_API fianchetto_status fianchetto_clear_hash(fianchetto_engine* engine);
+
+FIANCHETTO_API fianchetto_status fianchetto_get_stats(fianchetto_engine* engine, fianchetto_stats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FIANCHETTO_H */
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "board.hpp"
+#include "transposition_table.hpp"
+#include "types.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fianchetto {
+
+struct GameAnalysisOptions {
+    int depth = 12;        // Depth limit per position
+    int time_ms = 0;       // Budget for the whole game, split over its positions (0 = none)
+    int threads = 1;       // Positions searched at once, all sharing the table
+    int blunder_cp = 200;  // Loss that flags a move as a blunder
+};
+
+// Search result for one position of the game
+struct PositionAnalysis {
+    Move best_move;        // Move() when the side to move has no legal move
+    int score = 0;         // Side to move's point of view
+    int depth = 0;
+    uint64_t nodes = 0;
+    bool white_to_move = true;
+    bool scored = false;   // False if the search ran out of time before scoring any move
+};
+
+// One move of the game, judged from the position it was played in
+struct PlyAnalysis {
+    Move played;
+    Move best_move;
+    int score;             // Before the move, white's point of view
+    int depth;
+    int loss;              // Centipawns the move gave away, mover's point of view (0 for the best move or an unscored position)
+    bool blunder;          // loss >= blunder_cp
+};
+
+struct GameAnalysis {
+    std::vector<PlyAnalysis> plies;
+    int final_score = 0;   // Position after the last move, white's point of view
+    uint64_t nodes = 0;
+    long time_ms = 0;
+};
+
+// Analyse every position of a game (`moves` played from `start`, all
+// legal). Positions are claimed from the end of the game backwards, so
+// the table already holds the later positions' subtrees when the earlier
+// ones are searched; `threads` workers share it and each walks its own
+// board back with unmake_move. A time budget is divided over the
+// positions still to search, so early finishers leave more for the rest.
+// The table is used as it is, never aged, so a session's, shared or
+// snapshot table keeps its entries.
+GameAnalysis analyse_game(const Board& start, const std::vector<Move>& moves, TranspositionTable& tt,
+                          const GameAnalysisOptions& options, const std::atomic<bool>* stop = nullptr);
+
+// Per-move verdicts from the results for positions 0..moves.size()
+// (position i is the one moves[i] is played from)
+GameAnalysis summarize_game(const std::vector<Move>& moves, const std::vector<PositionAnalysis>& positions,
+                            int blunder_cp);
+
+// {"plies": [{"ply", "move", "score", "bestmove", "depth", "loss",
+// "blunder"}, ...], "final_score", "nodes", "time_ms"}
+std::string game_analysis_json(const GameAnalysis& analysis);
+
+} // namespace fianchetto
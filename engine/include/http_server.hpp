@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace fianchetto {
+
+struct HttpRequest {
+    std::string method;
+    std::string path;
+    std::string body;
+};
+
+struct HttpResponse {
+    int status = 200;
+    std::string content_type = "application/json";
+    std::string body;
+};
+
+// Small HTTP/1.1 server: one epoll event loop thread owns every socket
+// (accept, keep-alive reads, request parsing, buffered writes) and hands
+// complete requests to a fixed pool of worker threads. Workers post their
+// responses back to the loop through an eventfd, so a slow handler never
+// blocks other connections. Requests on one connection are answered in
+// order (no pipelining).
+class HttpServer {
+public:
+    using Handler = std::function<HttpResponse(const HttpRequest&)>;
+
+    static constexpr size_t MAX_HEADER_SIZE = 16 * 1024;
+    static constexpr size_t MAX_BODY_SIZE = 1024 * 1024;
+
+    HttpServer(Handler handler, int workers);
+    ~HttpServer();
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    // Bind to host:port (port 0 picks a free port); returns false on failure
+    bool listen(const std::string& host, int port);
+    int port() const { return port_; }
+
+    // Serve until stop() is called
+    void run();
+    // Make run() return; thread- and async-signal-safe
+    void stop();
+
+private:
+    struct Connection {
+        int fd;
+        std::string in;
+        std::string out;
+        size_t out_sent = 0;
+        bool busy = false;       // A worker owns the current request
+        bool keep_alive = true;
+        bool want_write = false; // Registered for EPOLLOUT
+    };
+
+    struct Job {
+        uint64_t connection;
+        HttpRequest request;
+    };
+
+    struct Completion {
+        uint64_t connection;
+        HttpResponse response;
+    };
+
+    Handler handler_;
+    int listen_fd_;
+    int epoll_fd_;
+    int event_fd_;
+    int port_;
+    std::atomic<bool> stopping_;
+
+    // Event loop state (loop thread only)
+    std::unordered_map<uint64_t, Connection> connections_;
+    uint64_t next_connection_;
+
+    std::mutex job_mutex_;
+    std::condition_variable job_cv_;
+    std::deque<Job> jobs_;
+
+    std::mutex completion_mutex_;
+    std::vector<Completion> completions_;
+
+    std::vector<std::thread> workers_;
+
+    void worker_loop();
+    void accept_connections();
+    void read_connection(uint64_t id);
+    void write_connection(uint64_t id);
+    void dispatch(uint64_t id);
+    void drain_completions();
+    void close_connection(uint64_t id);
+    void queue_response(uint64_t id, const HttpResponse& response);
+};
+
+} // namespace fianchetto
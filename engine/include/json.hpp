@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fianchetto {
+namespace json {
+
+// Minimal JSON support for the engine's HTTP endpoints: request bodies are
+// flat objects, responses are built with ObjectWriter.
+
+// Parse a flat JSON object into field -> value. String values are
+// unescaped; numbers, literals and nested arrays/objects are kept as raw
+// text. Returns false on malformed input.
+bool parse_object(std::string_view text, std::unordered_map<std::string, std::string>& fields);
+
+// Field accessors returning false when the field is missing or has the wrong type
+bool get_int(const std::unordered_map<std::string, std::string>& fields, const std::string& key, long& out);
+bool get_string(const std::unordered_map<std::string, std::string>& fields, const std::string& key, std::string& out);
+
+// Quote and escape a string
+std::string quote(std::string_view text);
+
+class ObjectWriter {
+public:
+    ObjectWriter& add(std::string_view key, std::string_view value);
+    ObjectWriter& add(std::string_view key, const char* value) { return add(key, std::string_view(value)); }
+    ObjectWriter& add(std::string_view key, long value);
+    ObjectWriter& add(std::string_view key, int value) { return add(key, static_cast<long>(value)); }
+    ObjectWriter& add(std::string_view key, unsigned long value);
+    ObjectWriter& add(std::string_view key, bool value);
+    ObjectWriter& add(std::string_view key, const std::vector<std::string>& values);
+    ObjectWriter& add_null(std::string_view key);
+    // Value already serialized as JSON (nested object or array)
+    ObjectWriter& add_raw(std::string_view key, std::string_view json);
+
+    std::string str() const { return "{" + body_ + "}"; }
+
+private:
+    std::string body_;
+
+    void key(std::string_view key);
+};
+
+} // namespace json
+} // namespace fianchetto
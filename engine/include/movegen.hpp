@@ -2,6 +2,7 @@
 
 #include "types.hpp"
 #include "board.hpp"
+#include <string_view>
 #include <vector>
 
 namespace fianchetto {
@@ -19,6 +20,11 @@ Bitboard king_attacks(Square sq);
 std::vector<Move> generate_moves(const Board& board);
 std::vector<Move> generate_legal_moves(const Board& board);
 
+// Legal move from UCI notation ("e2e4", "e7e8q"), or Move() if the text is
+// malformed or the move is not legal. Only the pseudo-legal move with the
+// same squares and promotion gets the legality test.
+Move parse_move(const Board& board, std::string_view uci);
+
 // Perft
 uint64_t perft(Board& board, int depth);
 
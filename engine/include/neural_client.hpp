@@ -3,31 +3,66 @@
 #ifdef USE_NEURAL
 
 #include "board.hpp"
+#include "eval_cache.hpp"
+#include "eval_pipeline.hpp"
+#include "service_health.hpp"
+#include <atomic>
+#include <span>
 #include <string>
-#include <unordered_map>
-#include <mutex>
+#include <vector>
 
 namespace fianchetto {
 
+struct NeuralClientOptions {
+    long connect_timeout_ms = 200;
+    long request_timeout_ms = 1000; // Deadline when the caller gives none
+    long hedge_after_ms = 0;        // Send a second copy of a slower request (0 = off)
+    int breaker_failures = 5;       // Consecutive failures that open the breaker
+    int breaker_cooldown_ms = 2000; // Time the breaker stays open before probing
+    size_t cache_mb = 16;
+};
+
 class NeuralClient {
 public:
-    NeuralClient(const std::string& url = "http://neural:8000/evaluate");
-    
-    // Evaluate position and return centipawn score
-    int evaluate(const Board& board);
-    
+    NeuralClient(const std::string& url = "http://neural:8000/evaluate",
+                 const NeuralClientOptions& options = NeuralClientOptions());
+
+    // Evaluate position and return centipawn score (white's perspective).
+    // Falls back to the classical evaluation when the service fails, misses
+    // the deadline or the circuit breaker is open; fallbacks are not cached.
+    int evaluate(const Board& board, long timeout_ms = 0);
+
+    // Evaluate many positions with a single request (cache hits are not sent)
+    std::vector<int> evaluate_batch(std::span<const Board* const> boards, long timeout_ms = 0);
+
     // Clear cache
     void clear_cache();
+    EvalCacheStats cache_stats() const { return cache_.stats(); }
+
+    // POST `count` positions in the binary encoding (see eval_pipeline.hpp)
+    // to /evaluate_batch without touching the cache; fills `scores` and
+    // returns false on any transport or protocol error, after `timeout_ms`
+    // (0 = request_timeout_ms), or at once while the breaker is open.
+    // Usable as an EvalPipeline backend.
+    bool evaluate_encoded(const uint8_t* positions, size_t count, int* scores, long timeout_ms = 0);
+
+    const LatencyHistogram& latency() const { return latency_; }
+    const CircuitBreaker& breaker() const { return breaker_; }
+    uint64_t hedged_requests() const { return hedged_.load(std::memory_order_relaxed); }
 
 private:
     std::string url_;
-    std::unordered_map<uint64_t, int> cache_;
-    std::mutex cache_mutex_;
-    
-    int http_evaluate(const std::string& fen);
+    std::string batch_url_;
+    NeuralClientOptions options_;
+    EvalCache cache_;
+    CircuitBreaker breaker_;
+    LatencyHistogram latency_;
+    std::atomic<uint64_t> hedged_;
+
+    bool perform(const uint8_t* positions, size_t count, int* scores, long timeout_ms);
+    bool perform_hedged(const uint8_t* positions, size_t count, int* scores, long timeout_ms);
 };
 
 } // namespace fianchetto
 
 #endif // USE_NEURAL
-
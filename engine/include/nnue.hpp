@@ -0,0 +1,97 @@
+#pragma once
+
+#include "types.hpp"
+#include <array>
+#include <string>
+#include <vector>
+
+namespace fianchetto {
+
+class Board;
+
+namespace nnue {
+
+// Network topology: 768 piece-square features per perspective -> 2 x 256
+// accumulator -> 32 -> 32 -> 1. The accumulator halves are always ordered
+// [white, black] and the output is from white's point of view, matching the
+// training data in neural/src/dataset.py.
+constexpr int INPUTS = 768;
+constexpr int HIDDEN = 256;
+constexpr int L1 = 32;
+constexpr int L2 = 32;
+
+// Quantization: activations are clipped to [0, ACTIVATION_MAX] (float 1.0),
+// hidden layer weights are scaled by WEIGHT_SCALE (float 1.0 == 64)
+constexpr int ACTIVATION_MAX = 127;
+constexpr int WEIGHT_SHIFT = 6;
+constexpr int WEIGHT_SCALE = 1 << WEIGHT_SHIFT;
+
+// Weight file format (little endian), see neural/src/export_nnue.py:
+//   char[4]  magic "FNNU"
+//   uint32   version
+//   uint32   inputs, hidden, l1, l2
+//   int32    output_scale (centipawns per float unit)
+//   int16    ft_weights[INPUTS][HIDDEN], ft_bias[HIDDEN]
+//   int8     l1_weights[L1][2 * HIDDEN], int32 l1_bias[L1]
+//   int8     l2_weights[L2][L1],         int32 l2_bias[L2]
+//   int8     out_weights[L2],            int32 out_bias
+constexpr char FILE_MAGIC[4] = {'F', 'N', 'N', 'U'};
+constexpr uint32_t FILE_VERSION = 1;
+
+// Feature transformer output for both perspectives
+struct alignas(64) Accumulator {
+    std::array<std::array<int16_t, HIDDEN>, 2> values; // [perspective][neuron]
+};
+
+// Pieces added or removed by a single move (at most: capture, moving piece
+// twice and the castling rook twice)
+struct DirtyPieces {
+    struct Entry {
+        PieceType piece;
+        Color color;
+        Square sq;
+        bool added;
+    };
+    std::array<Entry, 6> entries;
+    int count = 0;
+
+    void add(PieceType piece, Color color, Square sq) { entries[count++] = {piece, color, sq, true}; }
+    void remove(PieceType piece, Color color, Square sq) { entries[count++] = {piece, color, sq, false}; }
+};
+
+class Network {
+public:
+    Network();
+
+    // Load a quantized network; returns false (and keeps the previous
+    // weights) if the file is missing or has the wrong format
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+    bool loaded() const { return loaded_; }
+
+    // Full recomputation from the board
+    void refresh(Accumulator& acc, const Board& board) const;
+    // Incremental update for one move
+    void update(Accumulator& acc, const DirtyPieces& dirty) const;
+
+    // Centipawn score from the side to move's point of view
+    int evaluate(const Accumulator& acc, Color stm) const;
+
+    static int feature_index(Color perspective, PieceType piece, Color color, Square sq);
+
+private:
+    bool loaded_;
+    int32_t output_scale_;
+
+    std::vector<int16_t> ft_weights_;  // [INPUTS][HIDDEN]
+    std::vector<int16_t> ft_bias_;     // [HIDDEN]
+    std::vector<int8_t> l1_weights_;   // [L1][2 * HIDDEN]
+    std::vector<int32_t> l1_bias_;     // [L1]
+    std::vector<int8_t> l2_weights_;   // [L2][L1]
+    std::vector<int32_t> l2_bias_;     // [L2]
+    std::vector<int8_t> out_weights_;  // [L2]
+    int32_t out_bias_;
+};
+
+} // namespace nnue
+} // namespace fianchetto
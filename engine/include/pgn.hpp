@@ -0,0 +1,72 @@
+#pragma once
+
+#include "board.hpp"
+#include "types.hpp"
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace fianchetto {
+namespace pgn {
+
+// Move in standard algebraic notation ("Nbd7", "exd6", "e8=Q+", "O-O"),
+// matched against the legal moves of `board`. Check and annotation
+// suffixes are ignored. Returns Move() if no legal move, or more than
+// one, matches.
+Move parse_san(const Board& board, std::string_view san);
+
+// SAN of a legal move, with "+" or "#" when it gives check or mate
+std::string move_to_san(Board& board, Move move);
+
+constexpr int RESULT_UNKNOWN = 2;
+
+struct Game {
+    std::vector<std::pair<std::string, std::string>> tags;
+    std::string fen;         // Start position: the FEN tag, or the standard start
+    std::vector<Move> moves; // Main line; side variations and comments are skipped
+    int result;              // For white: 1, 0, -1, or RESULT_UNKNOWN ("*" or missing)
+    bool complete;           // False if a move (or the FEN tag) could not be read; `moves` stops before it
+
+    // Value of tag `name`, empty if absent
+    std::string_view tag(std::string_view name) const;
+};
+
+// Reads games one at a time, either in place from memory (e.g. a
+// platform::MappedFile) or from a stream, buffering one game at a time.
+// Moves are decoded as they are read, so a game comes back as a start
+// position plus legal moves.
+class Reader {
+public:
+    explicit Reader(std::string_view text);
+    explicit Reader(std::istream& in);
+
+    // Next game; false at the end of the input
+    bool next(Game& game);
+
+private:
+    std::string_view text_;
+    std::istream* in_;
+    std::string buffer_;  // Stream input: the game being parsed
+    std::string pending_; // Stream input: first line of the next game
+    Board board_;
+
+    bool fill_from_stream();
+};
+
+// Parse every game in `text` on `threads` threads (0 = one per core).
+// The text is split at game boundaries and `visit(game, thread)` is called
+// from the worker threads concurrently. Returns the number of games.
+size_t parse_parallel(std::string_view text, int threads,
+                      const std::function<void(const Game&, int)>& visit);
+
+// Call `visit(board, move)` for each position of the game with the move
+// played from it, then once more for the final position with Move().
+// Nothing is visited for a game whose FEN tag is invalid.
+void replay(const Game& game, const std::function<void(const Board&, Move)>& visit);
+
+} // namespace pgn
+} // namespace fianchetto
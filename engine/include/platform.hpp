@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fianchetto::platform {
+
+// How a LargeBuffer's memory is backed
+enum class PageKind {
+    HUGETLB,     // explicit huge pages (MAP_HUGETLB, needs vm.nr_hugepages)
+    TRANSPARENT, // normal mapping aligned to 2 MB with MADV_HUGEPAGE
+    NORMAL
+};
+
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// Zero-initialised anonymous mapping for large hash tables. Buffers of at
+// least one huge page try explicit huge pages first, then a 2 MB aligned
+// mapping advised for transparent huge pages, so random probes into a
+// large table cost far fewer TLB misses. Pages are only placed in memory
+// when first touched; see parallel_clear. Throws std::bad_alloc like new.
+class LargeBuffer {
+public:
+    LargeBuffer() = default;
+    explicit LargeBuffer(size_t bytes);
+    ~LargeBuffer();
+
+    LargeBuffer(LargeBuffer&& other) noexcept;
+    LargeBuffer& operator=(LargeBuffer&& other) noexcept;
+    LargeBuffer(const LargeBuffer&) = delete;
+    LargeBuffer& operator=(const LargeBuffer&) = delete;
+
+    void* data() const { return data_; }
+    size_t size() const { return size_; }
+    PageKind pages() const { return pages_; }
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+    void* mapping_ = nullptr; // Includes the alignment slack
+    size_t mapping_size_ = 0;
+    PageKind pages_ = PageKind::NORMAL;
+};
+
+// Read-only mapping of a whole file, for parsing large inputs in place
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // False (leaving the mapping as it was) if the file cannot be mapped;
+    // an empty file maps to empty text
+    bool open(const std::string& path);
+
+    std::string_view text() const { return {static_cast<const char*>(data_), size_}; }
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Zero `bytes` at `data`. Large regions are split over `threads` threads
+// (0 = one per core), each bound to a NUMA node in turn, so first touch
+// spreads the pages across nodes instead of onto the caller's node.
+void parallel_clear(void* data, size_t bytes, int threads = 0);
+
+// CPUs of each NUMA node (from sysfs; one node with every CPU otherwise)
+const std::vector<std::vector<int>>& numa_nodes();
+
+// Bind the calling thread to the CPUs of node `index % node count`;
+// returns false if the affinity could not be set
+bool pin_current_thread(int index);
+
+} // namespace fianchetto::platform
@@ -1,35 +1,38 @@
 #pragma once
 
 #include "board.hpp"
+#include "transposition_table.hpp"
 #include "types.hpp"
 #include <vector>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <unordered_map>
 
 namespace fianchetto {
 
-// Transposition table entry
-struct TTEntry {
-    uint64_t hash;
-    int depth;
-    int score;
-    Move best_move;
-    uint8_t flag; // 0 = exact, 1 = lower bound, 2 = upper bound
-    uint8_t age;
-};
+class EvalPipeline;
 
-// Transposition table
-class TranspositionTable {
-public:
-    TranspositionTable(size_t size_mb = 16);
-    void store(uint64_t hash, int depth, int score, Move best_move, uint8_t flag);
-    TTEntry* probe(uint64_t hash);
-    void clear();
-    void age();
+// Score bounds
+constexpr int SCORE_INFINITE = 32000;
+constexpr int SCORE_MATE = 30000;
+constexpr int MAX_PLY = 128;
 
-private:
-    std::vector<TTEntry> table_;
-    size_t size_;
-    uint8_t current_age_;
+// Scores within MAX_PLY of SCORE_MATE announce a forced mate
+constexpr bool is_mate_score(int score) {
+    return score >= SCORE_MATE - MAX_PLY || score <= -(SCORE_MATE - MAX_PLY);
+}
+
+// Moves to mate for a mate score, negative when getting mated
+constexpr int mate_in_moves(int score) {
+    return score > 0 ? (SCORE_MATE - score + 1) / 2 : -((SCORE_MATE + score + 1) / 2);
+}
+
+// One root move with its principal variation
+struct PVLine {
+    Move move;
+    int score; // Side to move's point of view
+    std::vector<Move> pv;
 };
 
 // Search statistics
@@ -40,49 +43,197 @@ struct SearchStats {
     int depth;
     Move best_move;
     int best_score;
+    std::vector<PVLine> lines; // Last completed iteration, best first (multi_pv of them)
 };
 
 // Search parameters
 struct SearchParams {
     int depth = 6;
+    int start_depth = 1;     // First iteration; a resumed search skips the depths it already has
     int time_limit_ms = 0;
+    uint64_t node_limit = 0; // Stop once this many nodes are searched (0 = no limit)
     bool use_neural = false;
     std::string neural_url = "http://neural:8000/evaluate";
+    EvalPipeline* neural_pipeline = nullptr; // Async leaf evaluation when use_neural is set
+    const std::atomic<bool>* stop = nullptr; // Set by another thread to end the search early
+    int multi_pv = 1;                        // Best root moves to search to full lines
+    std::vector<Move> search_moves;          // Root moves to consider, as generated (empty = all)
 };
 
-// Killer moves (moves that caused beta cutoffs)
+// Bound for all history tables; the gravity update keeps |entry| <= HISTORY_MAX
+constexpr int HISTORY_MAX = 16384;
+
+// Killer moves (quiet moves that caused beta cutoffs at the same ply)
 class KillerMoves {
 public:
-    void add(int depth, Move move);
-    bool is_killer(int depth, Move move) const;
+    void add(int ply, Move move);
+    bool is_killer(int ply, Move move) const;
     void clear();
 
 private:
-    std::array<std::array<Move, 2>, 64> killers_;
+    std::array<std::array<Move, 2>, MAX_PLY> killers_;
 };
 
-// History heuristic (move ordering)
+// Butterfly history heuristic (move ordering)
 class HistoryHeuristic {
 public:
-    void update(Color color, Move move, int depth);
+    // Positive bonus for cutoff moves, negative (malus) for moves that failed
+    void update(Color color, Move move, int bonus);
     int get_score(Color color, Move move) const;
     void clear();
 
 private:
-    std::array<std::array<int, 64>, 64> history_; // [from][to]
+    std::array<std::array<std::array<int, 64>, 64>, 2> history_; // [color][from][to]
+};
+
+// Counter moves: the quiet reply that refuted the opponent's previous move
+class CounterMoves {
+public:
+    void set(Color color, Move prev, Move move);
+    Move get(Color color, Move prev) const;
+    void clear();
+
+private:
+    std::array<std::array<std::array<Move, 64>, 7>, 2> counters_; // [color][prev piece][prev to]
+};
+
+// Continuation history: quiet move scores conditioned on an earlier move in
+// the line (the previous ply for counter-move history, two plies back for
+// follow-up history). Both moves are keyed by colored piece, so white and
+// black continuations never share an entry.
+class ContinuationHistory {
+public:
+    ContinuationHistory();
+    void update(Color prev_color, Move prev, Color color, Move move, int bonus);
+    int get_score(Color prev_color, Move prev, Color color, Move move) const;
+    void clear();
+
+private:
+    // [prev colored piece][prev to][colored piece][to], heap allocated
+    // (~1.2 MB); gravity keeps entries within int16_t
+    std::vector<int16_t> table_;
+
+    static size_t piece_index(Color color, Move move) {
+        return static_cast<size_t>(color) * 6 + static_cast<size_t>(move.piece()) - 1;
+    }
+    static size_t index(Color prev_color, Move prev, Color color, Move move) {
+        return ((piece_index(prev_color, prev) * 64 + prev.to()) * 12 + piece_index(color, move)) * 64 + move.to();
+    }
 };
 
 // Evaluation function
 int evaluate(const Board& board);
 
-// Search functions
-int negamax(Board& board, int depth, int alpha, int beta, SearchStats& stats, 
-            TranspositionTable& tt, KillerMoves& killers, HistoryHeuristic& history,
-            const SearchParams& params);
+// One evaluation term, or measurement, for each side
+struct EvalTerm {
+    const char* name;
+    int white;
+    int black;
+};
+
+// Breakdown of the classical evaluation. `terms` are in centipawns from
+// each side's own point of view (penalties negative) and add up to
+// `classical` = sum(white) - sum(black). `features` are measurements the
+// evaluation does not score (counts, for explanations). With an NNUE
+// attached, evaluate() returns the network score `nnue` instead.
+struct EvalTrace {
+    std::vector<EvalTerm> terms;
+    int classical; // White's point of view
+    bool has_nnue;
+    int nnue;      // White's point of view
+    std::vector<EvalTerm> features;
+};
+
+EvalTrace trace_evaluation(const Board& board);
+
+// Node types for compile-time specialization of the search
+enum class NodeType : uint8_t {
+    ROOT,   // Root of the tree: no TT cutoffs, records the best root move
+    PV,     // Open window: exact scores, re-searches on fail-high
+    NON_PV  // Null window: TT cutoffs and pruning allowed
+};
+
+// Per-thread search state. Everything the recursive search touches lives
+// here, so the hot path only passes depth and the window.
+class SearchThread {
+public:
+    SearchThread(Board& board, TranspositionTable& tt, const SearchParams& params);
+
+    // Iterative deepening driver
+    Move iterative_deepening();
 
-int quiescence(Board& board, int alpha, int beta, SearchStats& stats);
+    // One root iteration at `depth`; returns false if it was interrupted.
+    // Killers, histories and the TT carry over between calls, so a caller
+    // can interleave the iterations of several searches. With multi_pv
+    // above 1 the iteration keeps that many best root moves with full
+    // lines.
+    bool search_iteration(int depth);
+
+    // Replace the time and node budget given by the parameters
+    void set_limits(std::chrono::steady_clock::time_point deadline, uint64_t node_limit) {
+        deadline_ = deadline;
+        node_limit_ = node_limit;
+    }
+
+    template <NodeType NT>
+    int negamax(int depth, int alpha, int beta);
+    int quiescence(int alpha, int beta);
+
+    const SearchStats& stats() const { return stats_; }
+
+private:
+    Board& board_;
+    TranspositionTable& tt_;
+    const SearchParams& params_;
+    EvalPipeline* pipeline_;
+
+    SearchStats stats_;
+    KillerMoves killers_;
+    HistoryHeuristic history_;
+    CounterMoves counter_moves_;
+    ContinuationHistory counter_history_;  // Conditioned on the move one ply back
+    ContinuationHistory followup_history_; // Conditioned on our own move two plies back
+
+    int ply_;
+    std::array<Move, MAX_PLY> move_stack_; // Move played at each ply (null move = Move())
+    Move root_best_;
+
+    // Triangular PV table: pv_table_[ply] holds the line from that ply,
+    // plies ply..pv_length_[ply]-1; written at PV nodes only
+    std::array<std::array<Move, MAX_PLY + 1>, MAX_PLY + 1> pv_table_;
+    std::array<int, MAX_PLY + 1> pv_length_;
+
+    std::vector<Move> root_moves_; // Legal root moves allowed by search_moves
+    bool root_restricted_;         // search_moves leaves out some legal moves; the root is not stored in the TT
+
+    bool stopped_;
+    std::chrono::steady_clock::time_point start_time_;
+    std::chrono::steady_clock::time_point deadline_; // End of the time budget (max() if none)
+    uint64_t node_limit_;                             // 0 if none
+
+    int search_line(int depth, int previous);
+    int search_root_move(int depth, int previous, int floor);
+    bool search_multipv(int depth, size_t count);
+    void check_time();
+    bool should_stop();
+    int evaluate_leaf();
+    void order_moves(std::vector<Move>& moves, Move hash_move);
+    void update_quiet_stats(Move best, const Move* quiets, int quiet_count, int depth);
+};
 
 Move search_root(Board& board, const SearchParams& params, SearchStats& stats);
 
-} // namespace fianchetto
+// Search with a caller-owned transposition table, which stays warm for the
+// next search of the same game or session
+Move search_root(Board& board, TranspositionTable& tt, const SearchParams& params, SearchStats& stats);
+
+// Principal variation from the transposition table's best moves (stops at
+// an illegal or missing move, or when the line repeats)
+std::vector<Move> extract_pv(Board& board, TranspositionTable& tt, int max_length = MAX_PLY);
 
+// The inverse of extract_pv: store a line searched to `depth` with root
+// score `score` (side to move's view) back into the table, so a deeper
+// search resumes with that line ordered first
+void seed_pv(Board& board, TranspositionTable& tt, const std::vector<Move>& pv, int depth, int score);
+
+} // namespace fianchetto
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "board.hpp"
+#include "search.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fianchetto {
+
+struct SearchSchedulerOptions {
+    int threads = 4;       // Searches running at once
+    size_t hash_mb = 16;   // Pooled tables for tasks that bring none (emptied between tasks)
+    int pressure_ms = 50;  // A task this close to its deadline is under time pressure
+    bool pin_threads = false; // Bind search thread i to NUMA node i % nodes
+    std::string hash_file;    // Snapshot that pooled tables start from (see TranspositionTable::load)
+};
+
+// One search to schedule
+struct SearchTask {
+    SearchParams params;              // depth, start_depth, node_limit; time_limit_ms counts from submission
+    int priority = 1;                 // >= 1: share of the pool, and precedence under time pressure
+    TranspositionTable* tt = nullptr; // Caller's table (lock-free, so tasks may share it), or a pooled one
+
+    // Line already searched to params.start_depth - 1, seeded into the
+    // table before the first slice (see seed_pv)
+    std::vector<Move> seed_pv;
+    int seed_score = 0;
+};
+
+struct SearchOutcome {
+    Move best_move;
+    SearchStats stats;
+    std::vector<Move> pv; // from the task's table, taken before a pooled table is reused
+    long queued_ms;       // from submission to the first slice
+    bool deadline_missed; // finished after its deadline
+};
+
+struct SearchSchedulerStats {
+    uint64_t submitted;
+    uint64_t completed;
+    uint64_t slices;          // iterations run
+    uint64_t pressured;       // slices given to a task under time pressure
+    uint64_t deadline_misses;
+};
+
+// Runs many searches on a fixed pool of threads instead of one thread per
+// search. Tasks are time-sliced at iterative-deepening granularity: a
+// slice is one root iteration, and the task's SearchThread (killers,
+// histories) and table carry over to its next slice, so switching costs
+// nothing but cache warmth. The next slice goes to
+//   1. the highest-priority task under time pressure (earliest deadline
+//      breaks ties), otherwise
+//   2. the task with the least weighted work (nodes / priority), so
+//      throughput is shared in proportion to priority.
+// A task finishes at its depth, node budget or deadline, or early when its
+// next iteration is not expected to complete in the time left. The first
+// iteration always runs to completion so every task returns a move
+// (a resumed task starts deeper and may return none if it runs out of
+// budget first; the caller still has the line it resumed from).
+class SearchScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit SearchScheduler(const SearchSchedulerOptions& options = {});
+    ~SearchScheduler();
+
+    SearchScheduler(const SearchScheduler&) = delete;
+    SearchScheduler& operator=(const SearchScheduler&) = delete;
+
+    // Queue a search of (a copy of) `board`
+    std::future<SearchOutcome> submit(const Board& board, const SearchTask& task);
+
+    int threads() const { return options_.threads; }
+    size_t active();
+    SearchSchedulerStats stats();
+
+private:
+    struct Job {
+        Board board;
+        SearchParams params;
+        int priority;
+        TranspositionTable* tt;
+        std::unique_ptr<TranspositionTable> pooled_tt;
+        std::unique_ptr<SearchThread> thread; // Created on the first slice
+
+        Clock::time_point submitted;
+        Clock::time_point deadline;      // max() if none
+        Clock::time_point first_slice;
+        Clock::duration last_iteration{};
+        int next_depth;
+        double virtual_time;             // nodes / priority, offset by the start clock
+        std::promise<SearchOutcome> promise;
+
+        std::vector<Move> seed_pv;
+        int seed_score;
+
+        Job(const Board& b, const SearchTask& task)
+            : board(b), params(task.params), priority(task.priority), tt(task.tt),
+              next_depth(std::max(1, task.params.start_depth)), seed_pv(task.seed_pv), seed_score(task.seed_score) {}
+    };
+
+    SearchSchedulerOptions options_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::unique_ptr<Job>> ready_;
+    std::vector<std::unique_ptr<TranspositionTable>> free_tables_;
+    size_t running_;
+    double virtual_clock_; // Virtual time of the last task picked; new tasks start here
+    bool stop_;
+    SearchSchedulerStats stats_;
+
+    std::vector<std::thread> workers_;
+
+    void worker_loop();
+    std::unique_ptr<Job> pick(Clock::time_point now);
+    bool run_slice(Job& job);
+    void finish(std::unique_ptr<Job> job);
+};
+
+} // namespace fianchetto
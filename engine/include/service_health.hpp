@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace fianchetto {
+
+// Circuit breaker for a remote evaluation service. After `failure_threshold`
+// consecutive failures it opens and rejects calls for `cooldown_ms`; then a
+// single probe call is let through (half-open) and its outcome either
+// closes the breaker or opens it for another cooldown. Thread-safe.
+class CircuitBreaker {
+public:
+    CircuitBreaker(int failure_threshold = 5, int cooldown_ms = 2000);
+
+    // Whether a call may be attempted now
+    bool allow();
+    void record_success();
+    void record_failure();
+
+    bool is_open() const { return open_until_ns_.load(std::memory_order_relaxed) != 0; }
+    uint64_t trips() const { return trips_.load(std::memory_order_relaxed); }
+
+private:
+    int failure_threshold_;
+    int64_t cooldown_ns_;
+    std::atomic<int> consecutive_failures_;
+    std::atomic<int64_t> open_until_ns_; // 0 while closed
+    std::atomic<bool> probe_in_flight_;
+    std::atomic<uint64_t> trips_;
+
+    void trip();
+};
+
+// Lock-free latency histogram with power-of-two microsecond buckets:
+// bucket 0 holds [0, 1us], bucket i holds (2^(i-1), 2^i] us
+class LatencyHistogram {
+public:
+    static constexpr int BUCKETS = 32;
+
+    LatencyHistogram();
+
+    void record(uint64_t us);
+    void clear();
+
+    uint64_t count() const;
+    uint64_t bucket(int i) const { return buckets_[i].load(std::memory_order_relaxed); }
+    double mean_us() const;
+
+    // Upper bound of the bucket containing the p-th quantile (p in [0, 1])
+    uint64_t percentile_us(double p) const;
+
+private:
+    std::atomic<uint64_t> buckets_[BUCKETS];
+    std::atomic<uint64_t> total_us_;
+};
+
+} // namespace fianchetto
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "board.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fianchetto {
+
+// One training position in 32 bytes, stored as raw little-endian bytes.
+// Pieces are listed in the order of the occupied squares (a1 first), one
+// 4-bit code each, two per byte with the first in the low nibble.
+struct PackedPosition {
+    uint64_t occupancy;  // Occupied squares, a1 = bit 0
+    uint8_t pieces[16];  // Code = color * 6 + piece type - 1 (white pawn 0 .. black king 11)
+    int16_t score;       // Search score in centipawns, white's point of view
+    uint16_t fullmove;
+    uint8_t halfmove;    // Fifty-move clock, saturating at 255
+    uint8_t ep_square;   // 64 if none
+    uint8_t flags;       // Bit 0: black to move; bits 1-4: castling WK, WQ, BK, BQ
+    int8_t result;       // Game result for white: 1 win, 0 draw, -1 loss
+};
+
+static_assert(sizeof(PackedPosition) == 32, "PackedPosition is a 32-byte file record");
+
+constexpr uint8_t PACKED_NO_EP = 64;
+
+// `score` and `result` are from white's point of view
+PackedPosition pack_position(const Board& board, int score, int result);
+
+// FEN of a record; empty if the record is not a valid position (an empty
+// board, more than 32 pieces or an unknown piece code)
+std::string packed_to_fen(const PackedPosition& packed);
+
+// Set `board` to the record's position; false (board unchanged) if invalid
+bool unpack_position(const PackedPosition& packed, Board& board);
+
+// Appends PackedPosition records to a file from many threads without a
+// lock. Each thread fills its own Buffer; a full buffer reserves its byte
+// range with one atomic add and writes it there with pwrite, so threads
+// never wait on each other. Records from one buffer stay contiguous, but
+// buffers from different threads interleave.
+class TrainingWriter {
+public:
+    // Creates or truncates `path`; check is_open()
+    explicit TrainingWriter(const std::string& path);
+    ~TrainingWriter();
+
+    TrainingWriter(const TrainingWriter&) = delete;
+    TrainingWriter& operator=(const TrainingWriter&) = delete;
+
+    bool is_open() const { return fd_ >= 0; }
+    // False once any write has failed
+    bool ok() const { return !failed_.load(std::memory_order_relaxed); }
+    uint64_t records() const { return offset_.load(std::memory_order_relaxed) / sizeof(PackedPosition); }
+
+    // Per-thread batch of records; flushed when full and on destruction
+    class Buffer {
+    public:
+        explicit Buffer(TrainingWriter& writer, size_t capacity = 4096);
+        ~Buffer() { flush(); }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+
+        void add(const PackedPosition& record);
+        bool flush();
+
+    private:
+        TrainingWriter& writer_;
+        std::vector<PackedPosition> records_;
+        size_t capacity_;
+    };
+
+private:
+    int fd_;
+    std::atomic<uint64_t> offset_;
+    std::atomic<bool> failed_;
+
+    bool write(const PackedPosition* records, size_t count);
+};
+
+// Read-only memory mapping of a file of PackedPosition records, so a
+// dataset of any size is iterated straight from the page cache
+class TrainingReader {
+public:
+    TrainingReader() = default;
+    ~TrainingReader();
+
+    TrainingReader(const TrainingReader&) = delete;
+    TrainingReader& operator=(const TrainingReader&) = delete;
+
+    // Map `path`; false (leaving the reader as it was) if the file cannot
+    // be mapped or is not a whole number of records
+    bool open(const std::string& path);
+
+    size_t size() const { return size_; }
+    const PackedPosition& operator[](size_t index) const { return records_[index]; }
+    const PackedPosition* begin() const { return records_; }
+    const PackedPosition* end() const { return records_ + size_; }
+
+private:
+    const PackedPosition* records_ = nullptr;
+    size_t size_ = 0;
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+};
+
+} // namespace fianchetto
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "platform.hpp"
+#include "types.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace fianchetto {
+
+// Transposition table bound flags
+constexpr uint8_t TT_EXACT = 0;
+constexpr uint8_t TT_LOWER = 1;
+constexpr uint8_t TT_UPPER = 2;
+
+// Transposition table entry (a copy; the table stores entries packed)
+struct TTEntry {
+    uint64_t hash;
+    int depth;
+    int score;
+    Move best_move;
+    uint8_t flag; // TT_EXACT, TT_LOWER or TT_UPPER
+    uint8_t age;
+};
+
+// Transposition table. Each slot is two 64-bit words, (key ^ data, data),
+// written without locks: a probe only accepts a slot whose words verify
+// against the key, so a torn write from a concurrent writer (another
+// thread, or another process sharing the table) is read as a miss.
+//
+// The table lives either in private memory or, when given a name, in a
+// POSIX shared-memory segment (shm_open) that every process opening the
+// same name attaches to. The first process creates and sizes the segment;
+// later ones use its existing size, so the memory per host stays fixed.
+// The generation (age) is kept in the segment and shared as well.
+//
+// A private table is a platform::LargeBuffer (huge pages when available)
+// whose pages are first touched in parallel, spreading them over the
+// NUMA nodes.
+//
+// save() writes a snapshot file (header with format version, size and
+// Zobrist fingerprint, then the raw slots); load() maps one back
+// copy-on-write instead of reading it, so a warm start costs nothing until
+// the pages are probed.
+class TranspositionTable {
+public:
+    TranspositionTable(size_t size_mb = 16);
+
+    // Shared table in segment `shm_name` (e.g. "/fianchetto-tt"); falls
+    // back to a private table if the segment cannot be created or mapped
+    TranspositionTable(size_t size_mb, const std::string& shm_name);
+
+    ~TranspositionTable();
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    void store(uint64_t hash, int depth, int score, Move best_move, uint8_t flag);
+    bool probe(uint64_t hash, TTEntry& entry) const;
+    void clear();
+    void age();
+
+    size_t size() const { return size_; }
+    size_t size_mb() const { return size_ * sizeof(Slot) / (1024 * 1024); }
+    // Backing of a private table (shared segments and snapshots use normal pages)
+    platform::PageKind pages() const { return buffer_.pages(); }
+    bool shared() const { return backing_ == Backing::SHARED; }
+    bool from_snapshot() const { return backing_ == Backing::SNAPSHOT; }
+
+    // Write the table to `path` (via a temporary file and rename). Safe
+    // while searches write to it: a torn slot fails verification on load.
+    bool save(const std::string& path) const;
+
+    // Replace a private table with a copy-on-write mapping of the snapshot
+    // at `path`; the table takes the snapshot's size. Fails, leaving the
+    // table as it was, for a shared table or a missing, truncated or
+    // incompatible file.
+    bool load(const std::string& path);
+
+    // Table loaded from `path`, or a fresh one of `size_mb` if that fails
+    static std::unique_ptr<TranspositionTable> open_snapshot(const std::string& path, size_t size_mb);
+
+    // Remove a named segment; processes still attached keep their mapping
+    static bool unlink_shared(const std::string& shm_name);
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> key_xor_data;
+        std::atomic<uint64_t> data; // [32 move][16 score][8 depth][2 flag][6 age]
+    };
+
+    // Start of a shared segment; slots follow at SLOTS_OFFSET
+    struct SharedHeader {
+        std::atomic<uint32_t> magic; // Set last by the creator, once the segment is ready
+        uint32_t version;
+        uint64_t slot_count;
+        std::atomic<uint8_t> generation;
+    };
+
+    // Start of a snapshot file; slots follow at SLOTS_OFFSET
+    struct SnapshotHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t slot_size;
+        uint64_t slot_count;
+        uint64_t zobrist;    // Board::zobrist_fingerprint() of the writer
+        uint8_t generation;
+    };
+
+    enum class Backing { PRIVATE, SHARED, SNAPSHOT };
+
+    static constexpr uint32_t SHARED_MAGIC = 0x46545454; // "FTTT"
+    static constexpr uint32_t SHARED_VERSION = 1;
+    static constexpr char SNAPSHOT_MAGIC[8] = {'F', 'I', 'A', 'N', 'C', 'T', 'T', '\0'};
+    static constexpr uint32_t SNAPSHOT_VERSION = 1;
+    static constexpr size_t SLOTS_OFFSET = 64;
+
+    Slot* slots_;
+    size_t size_;
+    platform::LargeBuffer buffer_;          // Private table
+    Backing backing_;
+    void* mapping_;                         // Shared segment or snapshot file
+    size_t mapping_size_;
+    std::atomic<uint8_t> local_generation_; // Private table's generation
+    std::atomic<uint8_t>* generation_;
+
+    void allocate_private(size_t size_mb);
+    bool attach_shared(size_t size_mb, const std::string& shm_name);
+};
+
+} // namespace fianchetto
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <string_view>
 
 namespace fianchetto {
 
@@ -28,8 +30,14 @@ using Square = uint8_t;
 // Bitboard type
 using Bitboard = uint64_t;
 
+// Move flags
+constexpr uint16_t MOVE_FLAG_CASTLE_KINGSIDE = 0x1;
+constexpr uint16_t MOVE_FLAG_CASTLE_QUEENSIDE = 0x2;
+constexpr uint16_t MOVE_FLAG_EN_PASSANT = 0x4;
+constexpr uint16_t MOVE_FLAG_PROMOTION = 0x8;
+
 // Move representation (32-bit packed)
-// Format: [6 bits: from][6 bits: to][3 bits: piece][3 bits: captured][2 bits: promotion][12 bits: flags]
+// Format: [6 bits: from][6 bits: to][3 bits: piece][3 bits: captured][3 bits: promotion][11 bits: flags]
 struct Move {
     uint32_t data;
 
@@ -39,7 +47,7 @@ struct Move {
          PieceType promotion = PieceType::NONE, uint16_t flags = 0) {
         data = (from) | (to << 6) | (static_cast<uint32_t>(piece) << 12) |
                (static_cast<uint32_t>(captured) << 15) | (static_cast<uint32_t>(promotion) << 18) |
-               (flags << 20);
+               (static_cast<uint32_t>(flags) << 21);
     }
 
     Square from() const { return data & 0x3F; }
@@ -47,22 +55,16 @@ struct Move {
     PieceType piece() const { return static_cast<PieceType>((data >> 12) & 0x7); }
     PieceType captured() const { return static_cast<PieceType>((data >> 15) & 0x7); }
     PieceType promotion() const { return static_cast<PieceType>((data >> 18) & 0x7); }
-    uint16_t flags() const { return (data >> 20) & 0xFFF; }
+    uint16_t flags() const { return (data >> 21) & 0x7FF; }
     bool is_capture() const { return captured() != PieceType::NONE; }
     bool is_promotion() const { return promotion() != PieceType::NONE; }
-    bool is_castling() const { return (flags() & 0x1) != 0; }
-    bool is_en_passant() const { return (flags() & 0x2) != 0; }
+    bool is_castling() const { return (flags() & (MOVE_FLAG_CASTLE_KINGSIDE | MOVE_FLAG_CASTLE_QUEENSIDE)) != 0; }
+    bool is_en_passant() const { return (flags() & MOVE_FLAG_EN_PASSANT) != 0; }
 
     bool operator==(const Move& other) const { return data == other.data; }
     bool operator!=(const Move& other) const { return data != other.data; }
 };
 
-// Move flags
-constexpr uint16_t MOVE_FLAG_CASTLE_KINGSIDE = 0x1;
-constexpr uint16_t MOVE_FLAG_CASTLE_QUEENSIDE = 0x2;
-constexpr uint16_t MOVE_FLAG_EN_PASSANT = 0x4;
-constexpr uint16_t MOVE_FLAG_PROMOTION = 0x8;
-
 // Square helpers
 inline Square square(int file, int rank) {
     return static_cast<Square>(rank * 8 + file);
@@ -74,7 +76,10 @@ inline int rank_of(Square sq) { return sq / 8; }
 // String conversion
 std::string square_to_string(Square sq);
 std::string move_to_string(Move move);
-Move string_to_move(const std::string& str);
+// Coordinate notation ("e7e8q") into `out`, which needs room for 5 chars;
+// returns the length (no terminating NUL)
+size_t write_move(Move move, char* out);
+Move string_to_move(std::string_view str);
 
 } // namespace fianchetto
 
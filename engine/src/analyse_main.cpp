@@ -0,0 +1,236 @@
+#include "board.hpp"
+#include "epd.hpp"
+#include "json.hpp"
+#include "movegen.hpp"
+#include "nnue.hpp"
+#include "platform.hpp"
+#include "search.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Batch labeling: reads FEN or EPD lines from a file or stdin, searches
+// each on a pool of worker threads and writes one JSON object per line as
+// soon as its search finishes (so output order follows completion, and
+// "line" gives the input line number).
+//
+// Memory stays constant whatever the input size: the reader blocks once a
+// bounded queue of pending lines is full, and each worker owns one board
+// and one transposition table for its whole lifetime.
+
+namespace {
+
+using namespace fianchetto;
+
+void usage() {
+    std::cerr << "Usage: fianchetto_analyse [--input PATH] [--output PATH] [--depth N] [--nodes N]\n"
+                 "                          [--threads N] [--hash MB] [--pin-threads 0|1] [--eval-file PATH]\n";
+}
+
+struct Job {
+    uint64_t line;
+    std::string text;
+};
+
+// Lines read but not yet taken by a worker
+class JobQueue {
+public:
+    explicit JobQueue(size_t capacity) : capacity_(capacity), closed_(false) {}
+
+    void push(Job job) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return jobs_.size() < capacity_; });
+        jobs_.push_back(std::move(job));
+        not_empty_.notify_one();
+    }
+
+    // False once the queue is closed and drained
+    bool pop(Job& job) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return !jobs_.empty() || closed_; });
+        if (jobs_.empty()) return false;
+        job = std::move(jobs_.front());
+        jobs_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<Job> jobs_;
+    size_t capacity_;
+    bool closed_;
+};
+
+struct Options {
+    SearchParams params;
+    int threads = 1;
+    size_t hash_mb = 16;
+    bool pin_threads = false;
+};
+
+class Writer {
+public:
+    explicit Writer(std::ostream& out) : out_(out) {}
+
+    void write(const std::string& line) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out_ << line << '\n';
+        out_.flush();
+    }
+
+private:
+    std::mutex mutex_;
+    std::ostream& out_;
+};
+
+std::string analyse(Board& board, TranspositionTable& tt, const SearchParams& params, const Job& job,
+                    const epd::Record& record) {
+    char fen[FEN_BUFFER_SIZE];
+    size_t fen_length = board.write_fen(fen, sizeof(fen));
+    json::ObjectWriter out;
+    out.add("line", static_cast<unsigned long>(job.line)).add("fen", std::string_view(fen, fen_length));
+    if (!record.id.empty()) out.add("id", record.id);
+
+    // Positions are independent: a new generation hides the previous
+    // position's entries without clearing the table
+    tt.age();
+
+    if (movegen::generate_legal_moves(board).empty()) {
+        bool mated = board.in_check(board.side_to_move());
+        out.add_null("bestmove").add("score", mated ? -SCORE_MATE : 0);
+        if (mated) out.add("mate", 0);
+        return out.add("depth", 0).add("nodes", 0UL).add_raw("pv", "[]").str();
+    }
+
+    SearchStats stats;
+    Move best = search_root(board, tt, params, stats);
+    std::string move = move_to_string(best);
+
+    // Score from the side to move's point of view, plus moves to mate
+    out.add("bestmove", move).add("score", stats.best_score);
+    if (is_mate_score(stats.best_score)) out.add("mate", mate_in_moves(stats.best_score));
+    out.add("depth", stats.depth).add("nodes", static_cast<unsigned long>(stats.nodes + stats.qnodes));
+
+    std::vector<std::string> pv;
+    for (Move m : extract_pv(board, tt, stats.depth)) pv.push_back(move_to_string(m));
+    if (pv.empty() || pv.front() != move) pv.assign(1, move);
+    return out.add("pv", pv).str();
+}
+
+void worker(int index, const Options& options, const nnue::Network* network, JobQueue& queue, Writer& writer) {
+    if (options.pin_threads) platform::pin_current_thread(index);
+
+    Board board;
+    board.set_network(network);
+    TranspositionTable tt(options.hash_mb);
+
+    Job job;
+    epd::Record record;
+    while (queue.pop(job)) {
+        FenError error = epd::parse(job.text, board, record);
+        if (error != FenError::NONE) {
+            std::cerr << "line " << job.line << ": " << fen_error_string(error) << std::endl;
+            continue;
+        }
+        writer.write(analyse(board, tt, options.params, job, record));
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::ios::sync_with_stdio(false);
+
+    Options options;
+    options.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    options.params.depth = 0;
+    std::string input_path;
+    std::string output_path;
+    std::string eval_file;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--input") input_path = value;
+        else if (arg == "--output") output_path = value;
+        else if (arg == "--depth") options.params.depth = std::clamp(std::atoi(value.c_str()), 1, MAX_PLY - 1);
+        else if (arg == "--nodes") options.params.node_limit = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--threads") options.threads = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--hash") options.hash_mb = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--pin-threads") options.pin_threads = value == "1";
+        else if (arg == "--eval-file") eval_file = value;
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    // A node budget alone deepens until it runs out
+    if (options.params.depth == 0) options.params.depth = options.params.node_limit > 0 ? MAX_PLY - 1 : 8;
+
+    nnue::Network network;
+    if (!eval_file.empty() && !network.load(eval_file)) {
+        std::cerr << "Failed to load NNUE file " << eval_file << std::endl;
+        return 1;
+    }
+
+    std::ifstream input_file;
+    if (!input_path.empty() && input_path != "-") {
+        input_file.open(input_path);
+        if (!input_file) {
+            std::cerr << "Cannot open " << input_path << std::endl;
+            return 1;
+        }
+    }
+    std::istream& input = input_file.is_open() ? input_file : std::cin;
+
+    std::ofstream output_file;
+    if (!output_path.empty() && output_path != "-") {
+        output_file.open(output_path);
+        if (!output_file) {
+            std::cerr << "Cannot open " << output_path << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& output = output_file.is_open() ? output_file : std::cout;
+
+    JobQueue queue(static_cast<size_t>(options.threads) * 16);
+    Writer writer(output);
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < options.threads; i++) {
+        workers.emplace_back(worker, i, std::cref(options), network.loaded() ? &network : nullptr,
+                             std::ref(queue), std::ref(writer));
+    }
+
+    std::string line;
+    for (uint64_t number = 1; std::getline(input, line); number++) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') continue;
+        queue.push({number, line.substr(start)});
+    }
+    queue.close();
+
+    for (auto& thread : workers) thread.join();
+    return 0;
+}
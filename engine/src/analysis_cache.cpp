@@ -0,0 +1,52 @@
+#include "analysis_cache.hpp"
+
+namespace fianchetto {
+
+AnalysisCache::AnalysisCache(size_t max_entries)
+    : max_entries_(max_entries), hits_(0), resumed_(0), misses_(0) {}
+
+bool AnalysisCache::probe(uint64_t hash, int depth, Analysis& analysis) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(hash);
+    if (it == index_.end()) {
+        misses_++;
+        return false;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    analysis = it->second->analysis;
+    if (analysis.depth >= depth) hits_++;
+    else resumed_++;
+    return true;
+}
+
+void AnalysisCache::store(uint64_t hash, const Analysis& analysis) {
+    if (max_entries_ == 0 || analysis.best_move == Move() || analysis.depth <= 0) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(hash);
+    if (it != index_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        if (it->second->analysis.depth <= analysis.depth) it->second->analysis = analysis;
+        return;
+    }
+
+    if (index_.size() >= max_entries_) {
+        index_.erase(lru_.back().hash);
+        lru_.pop_back();
+    }
+    lru_.push_front(Entry{hash, analysis});
+    index_[hash] = lru_.begin();
+}
+
+void AnalysisCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+}
+
+AnalysisCacheStats AnalysisCache::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {hits_, resumed_, misses_, static_cast<uint64_t>(index_.size())};
+}
+
+} // namespace fianchetto
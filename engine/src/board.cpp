@@ -1,12 +1,16 @@
 #include "board.hpp"
 #include "types.hpp"
 #include "movegen.hpp"
+#include <mutex>
 #include <random>
-#include <sstream>
 #include <stdexcept>
 #include <cmath>
 #include <cstdlib>
 #include <vector>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string>
 
 namespace fianchetto {
 
@@ -15,11 +19,18 @@ std::array<std::array<std::array<uint64_t, 64>, 7>, 2> Board::zobrist_pieces_;
 std::array<uint64_t, 4> Board::zobrist_castling_;
 std::array<uint64_t, 8> Board::zobrist_en_passant_;
 uint64_t Board::zobrist_side_;
-bool Board::zobrist_initialized_ = false;
+std::array<uint64_t, 8192> Board::cuckoo_keys_;
+std::array<Move, 8192> Board::cuckoo_moves_;
+std::array<std::array<Bitboard, 64>, 64> Board::between_;
 
+// Boards may be constructed concurrently (one per worker thread), so the
+// tables are built exactly once
 void Board::init_zobrist() {
-    if (zobrist_initialized_) return;
+    static std::once_flag once;
+    std::call_once(once, generate_zobrist);
+}
 
+void Board::generate_zobrist() {
     std::mt19937_64 rng(12345); // Fixed seed for reproducibility
 
     for (int color = 0; color < 2; color++) {
@@ -39,7 +50,70 @@ void Board::init_zobrist() {
     }
 
     zobrist_side_ = rng();
-    zobrist_initialized_ = true;
+    init_cuckoo();
+}
+
+uint64_t Board::zobrist_fingerprint() {
+    init_zobrist();
+    uint64_t digest = 0;
+    auto mix = [&digest](uint64_t key) { digest = (digest ^ key) * 0x100000001B3ULL + (digest >> 29); };
+    for (const auto& by_piece : zobrist_pieces_) {
+        for (const auto& by_square : by_piece) {
+            for (uint64_t key : by_square) mix(key);
+        }
+    }
+    for (uint64_t key : zobrist_castling_) mix(key);
+    for (uint64_t key : zobrist_en_passant_) mix(key);
+    mix(zobrist_side_);
+    return digest;
+}
+
+void Board::init_cuckoo() {
+    cuckoo_keys_.fill(0);
+    cuckoo_moves_.fill(Move());
+
+    for (int a = 0; a < 64; a++) {
+        for (int b = 0; b < 64; b++) {
+            Bitboard line = 0;
+            if (movegen::rook_attacks(a, 0) & (1ULL << b)) {
+                line = movegen::rook_attacks(a, 1ULL << b) & movegen::rook_attacks(b, 1ULL << a);
+            } else if (movegen::bishop_attacks(a, 0) & (1ULL << b)) {
+                line = movegen::bishop_attacks(a, 1ULL << b) & movegen::bishop_attacks(b, 1ULL << a);
+            }
+            between_[a][b] = line;
+        }
+    }
+
+    // Every reversible (non-pawn) move on an empty board, stored once per
+    // square pair; 3668 entries in total
+    for (int color = 0; color < 2; color++) {
+        for (int pt = static_cast<int>(PieceType::KNIGHT); pt <= static_cast<int>(PieceType::KING); pt++) {
+            PieceType piece = static_cast<PieceType>(pt);
+            for (int s1 = 0; s1 < 64; s1++) {
+                Bitboard targets;
+                switch (piece) {
+                    case PieceType::KNIGHT: targets = movegen::knight_attacks(s1); break;
+                    case PieceType::BISHOP: targets = movegen::bishop_attacks(s1, 0); break;
+                    case PieceType::ROOK: targets = movegen::rook_attacks(s1, 0); break;
+                    case PieceType::QUEEN: targets = movegen::queen_attacks(s1, 0); break;
+                    default: targets = movegen::king_attacks(s1); break;
+                }
+                for (int s2 = s1 + 1; s2 < 64; s2++) {
+                    if (!(targets & (1ULL << s2))) continue;
+
+                    Move move(s1, s2, piece);
+                    uint64_t key = zobrist_pieces_[color][pt][s1] ^ zobrist_pieces_[color][pt][s2] ^ zobrist_side_;
+                    int i = cuckoo_h1(key);
+                    while (true) {
+                        std::swap(cuckoo_keys_[i], key);
+                        std::swap(cuckoo_moves_[i], move);
+                        if (move == Move()) break;
+                        i = (i == cuckoo_h1(key)) ? cuckoo_h2(key) : cuckoo_h1(key);
+                    }
+                }
+            }
+        }
+    }
 }
 
 Board::Board() {
@@ -52,143 +126,239 @@ Board::Board() {
     ep_square_ = 64; // Invalid square
     halfmove_clock_ = 0;
     fullmove_number_ = 1;
+    plies_from_null_ = 0;
     hash_key_ = 0;
+    nnue_ = nullptr;
     set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
 }
 
-Board::Board(const std::string& fen) : Board() {
+Board::Board(std::string_view fen) : Board() {
     set_fen(fen);
 }
 
-void Board::set_fen(const std::string& fen) {
-    // Clear board
-    for (int i = 0; i < 64; i++) {
-        pieces_[i] = PieceType::NONE;
+const char* fen_error_string(FenError error) {
+    switch (error) {
+        case FenError::NONE: return "no error";
+        case FenError::PLACEMENT: return "bad piece placement";
+        case FenError::KINGS: return "each side needs exactly one king";
+        case FenError::PAWN_RANK: return "pawn on the first or last rank";
+        case FenError::SIDE: return "bad side to move";
+        case FenError::CASTLING: return "bad castling rights";
+        case FenError::EN_PASSANT: return "bad en passant square";
+        case FenError::CLOCKS: return "bad move counters";
+        case FenError::OPERATION: return "malformed EPD operation";
+        case FenError::MOVE: return "illegal move in EPD operation";
     }
-    bitboards_.fill({});
+    return "unknown error";
+}
+
+namespace {
+
+// Next space-separated field of `text` from `pos`; empty at the end
+std::string_view next_field(std::string_view text, size_t& pos) {
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) pos++;
+    size_t start = pos;
+    while (pos < text.size() && text[pos] != ' ' && text[pos] != '\t' && text[pos] != '\r' &&
+           text[pos] != '\n') {
+        pos++;
+    }
+    return text.substr(start, pos - start);
+}
 
-    std::istringstream iss(fen);
-    std::string token;
+bool parse_counter(std::string_view field, int& value) {
+    if (field.empty() || field.size() > 9) return false;
+    value = 0;
+    for (char c : field) {
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+constexpr char PIECE_CHARS[2][8] = {" PNBRQK", " pnbrqk"};
 
-    // Parse piece placement
-    std::getline(iss, token, ' ');
-    int rank = 7, file = 0;
-    for (char c : token) {
+} // namespace
+
+FenError Board::parse_fen(std::string_view fen, size_t* consumed) {
+    std::array<PieceType, 64> pieces;
+    std::array<Color, 64> colors;
+    pieces.fill(PieceType::NONE);
+    colors.fill(Color::WHITE);
+
+    // Piece placement, rank 8 first
+    size_t pos = 0;
+    std::string_view field = next_field(fen, pos);
+    int rank = 7, file = 0, kings[2] = {0, 0};
+    for (char c : field) {
         if (c == '/') {
+            if (file != 8 || rank == 0) return FenError::PLACEMENT;
             rank--;
             file = 0;
         } else if (c >= '1' && c <= '8') {
             file += c - '0';
+            if (file > 8) return FenError::PLACEMENT;
         } else {
-            Square sq = square(file, rank);
             Color color = (c >= 'A' && c <= 'Z') ? Color::WHITE : Color::BLACK;
-            PieceType piece;
-            switch (std::tolower(c)) {
-                case 'p': piece = PieceType::PAWN; break;
-                case 'n': piece = PieceType::KNIGHT; break;
-                case 'b': piece = PieceType::BISHOP; break;
-                case 'r': piece = PieceType::ROOK; break;
-                case 'q': piece = PieceType::QUEEN; break;
-                case 'k': piece = PieceType::KING; break;
-                default: continue;
-            }
-            place_piece(sq, piece, color);
+            const char* found = std::char_traits<char>::find(PIECE_CHARS[static_cast<int>(color)] + 1, 6, c);
+            if (!found || file > 7) return FenError::PLACEMENT;
+            PieceType piece = static_cast<PieceType>(found - PIECE_CHARS[static_cast<int>(color)]);
+            if (piece == PieceType::PAWN && (rank == 0 || rank == 7)) return FenError::PAWN_RANK;
+            if (piece == PieceType::KING) kings[static_cast<int>(color)]++;
+            pieces[square(file, rank)] = piece;
+            colors[square(file, rank)] = color;
             file++;
         }
     }
+    if (rank != 0 || file != 8) return FenError::PLACEMENT;
+    if (kings[0] != 1 || kings[1] != 1) return FenError::KINGS;
+
+    field = next_field(fen, pos);
+    if (field != "w" && field != "b") return FenError::SIDE;
+    Color stm = field == "w" ? Color::WHITE : Color::BLACK;
+
+    field = next_field(fen, pos);
+    std::array<bool, 4> castling = {false, false, false, false};
+    if (field != "-") {
+        if (field.empty() || field.size() > 4) return FenError::CASTLING;
+        for (char c : field) {
+            size_t index = std::string_view("KQkq").find(c);
+            if (index == std::string_view::npos || castling[index]) return FenError::CASTLING;
+            castling[index] = true;
+        }
+    }
+    // Rights that movegen could not honour (king or rook moved) are dropped
+    for (int c = 0; c < 2; c++) {
+        int home = c == 0 ? 0 : 7;
+        Color color = static_cast<Color>(c);
+        auto has = [&](int f, PieceType piece) {
+            Square sq = square(f, home);
+            return pieces[sq] == piece && colors[sq] == color;
+        };
+        if (!has(4, PieceType::KING)) castling[c * 2] = castling[c * 2 + 1] = false;
+        if (!has(7, PieceType::ROOK)) castling[c * 2] = false;
+        if (!has(0, PieceType::ROOK)) castling[c * 2 + 1] = false;
+    }
 
-    // Parse side to move
-    std::getline(iss, token, ' ');
-    stm_ = (token == "w") ? Color::WHITE : Color::BLACK;
-
-    // Parse castling
-    std::getline(iss, token, ' ');
-    castling_.fill(false);
-    if (token != "-") {
-        if (token.find('K') != std::string::npos) castling_[0] = true;
-        if (token.find('Q') != std::string::npos) castling_[1] = true;
-        if (token.find('k') != std::string::npos) castling_[2] = true;
-        if (token.find('q') != std::string::npos) castling_[3] = true;
+    field = next_field(fen, pos);
+    Square ep_square = 64;
+    if (field != "-") {
+        int ep_rank = stm == Color::WHITE ? 5 : 2;
+        if (field.size() != 2 || field[0] < 'a' || field[0] > 'h' || field[1] - '1' != ep_rank) {
+            return FenError::EN_PASSANT;
+        }
+        ep_square = square(field[0] - 'a', ep_rank);
+        if (pieces[ep_square] != PieceType::NONE) return FenError::EN_PASSANT;
     }
 
-    // Parse en passant
-    std::getline(iss, token, ' ');
-    if (token == "-") {
-        ep_square_ = 64;
-    } else {
-        file = token[0] - 'a';
-        rank = token[1] - '1';
-        ep_square_ = square(file, rank);
+    // Optional move counters: both or neither, so an EPD operation
+    // starting after the position fields is left alone
+    int halfmove = 0, fullmove = 1;
+    size_t counters_pos = pos;
+    field = next_field(fen, counters_pos);
+    if (!field.empty() && is_digit(field[0])) {
+        if (!parse_counter(field, halfmove)) return FenError::CLOCKS;
+        if (!parse_counter(next_field(fen, counters_pos), fullmove)) return FenError::CLOCKS;
+        fullmove = std::max(fullmove, 1);
+        pos = counters_pos;
     }
+    if (consumed) *consumed = pos;
 
-    // Parse halfmove clock
-    std::getline(iss, token, ' ');
-    halfmove_clock_ = token.empty() ? 0 : std::stoi(token);
+    bitboards_.fill({});
+    pieces_.fill(PieceType::NONE);
+    colors_.fill(Color::WHITE);
+    for (int sq = 0; sq < 64; sq++) {
+        if (pieces[sq] != PieceType::NONE) place_piece(static_cast<Square>(sq), pieces[sq], colors[sq]);
+    }
+    stm_ = stm;
+    castling_ = castling;
+    ep_square_ = ep_square;
+    halfmove_clock_ = halfmove;
+    fullmove_number_ = fullmove;
 
-    // Parse fullmove number
-    std::getline(iss, token, ' ');
-    fullmove_number_ = token.empty() ? 1 : std::stoi(token);
+    // A new position starts a new game history
+    history_.clear();
+    plies_from_null_ = 0;
 
     update_hash();
+    set_network(nnue_);
+    return FenError::NONE;
+}
+
+void Board::set_fen(std::string_view fen) {
+    parse_fen(fen);
+}
+
+void Board::set_network(const nnue::Network* net) {
+    nnue_ = net;
+    nnue_stack_.clear();
+    if (nnue_) {
+        nnue_stack_.emplace_back();
+        nnue_->refresh(nnue_stack_.back(), *this);
+    }
 }
 
 std::string Board::get_fen() const {
-    std::ostringstream oss;
-    
+    char buffer[FEN_BUFFER_SIZE];
+    return std::string(buffer, write_fen(buffer, sizeof(buffer)));
+}
+
+size_t Board::write_fen(char* out, size_t size, bool counters) const {
+    char buffer[FEN_BUFFER_SIZE];
+    char* p = buffer;
+
     // Piece placement
     for (int rank = 7; rank >= 0; rank--) {
         int empty = 0;
         for (int file = 0; file < 8; file++) {
             Square sq = square(file, rank);
-            PieceType piece = pieces_[sq];
-            if (piece == PieceType::NONE) {
+            if (pieces_[sq] == PieceType::NONE) {
                 empty++;
-            } else {
-                if (empty > 0) {
-                    oss << empty;
-                    empty = 0;
-                }
-                char c;
-                switch (piece) {
-                    case PieceType::PAWN: c = 'p'; break;
-                    case PieceType::KNIGHT: c = 'n'; break;
-                    case PieceType::BISHOP: c = 'b'; break;
-                    case PieceType::ROOK: c = 'r'; break;
-                    case PieceType::QUEEN: c = 'q'; break;
-                    case PieceType::KING: c = 'k'; break;
-                    default: c = '?'; break;
-                }
-                if (colors_[sq] == Color::WHITE) c = std::toupper(c);
-                oss << c;
+                continue;
             }
+            if (empty > 0) *p++ = static_cast<char>('0' + empty);
+            empty = 0;
+            *p++ = PIECE_CHARS[static_cast<int>(colors_[sq])][static_cast<int>(pieces_[sq])];
         }
-        if (empty > 0) oss << empty;
-        if (rank > 0) oss << '/';
+        if (empty > 0) *p++ = static_cast<char>('0' + empty);
+        if (rank > 0) *p++ = '/';
     }
 
-    oss << ' ' << (stm_ == Color::WHITE ? 'w' : 'b') << ' ';
+    *p++ = ' ';
+    *p++ = stm_ == Color::WHITE ? 'w' : 'b';
+    *p++ = ' ';
 
     // Castling
-    bool any_castle = false;
-    if (castling_[0]) { oss << 'K'; any_castle = true; }
-    if (castling_[1]) { oss << 'Q'; any_castle = true; }
-    if (castling_[2]) { oss << 'k'; any_castle = true; }
-    if (castling_[3]) { oss << 'q'; any_castle = true; }
-    if (!any_castle) oss << '-';
-
-    oss << ' ';
+    char* rights = p;
+    for (int i = 0; i < 4; i++) {
+        if (castling_[i]) *p++ = "KQkq"[i];
+    }
+    if (p == rights) *p++ = '-';
+    *p++ = ' ';
 
     // En passant
     if (ep_square_ < 64) {
-        oss << static_cast<char>('a' + file_of(ep_square_));
-        oss << static_cast<char>('1' + rank_of(ep_square_));
+        *p++ = static_cast<char>('a' + file_of(ep_square_));
+        *p++ = static_cast<char>('1' + rank_of(ep_square_));
     } else {
-        oss << '-';
+        *p++ = '-';
     }
 
-    oss << ' ' << halfmove_clock_ << ' ' << fullmove_number_;
+    if (counters) {
+        // Two ints always fit after the 81 chars of the longest position fields
+        char* end = buffer + sizeof(buffer);
+        for (int counter : {halfmove_clock_, fullmove_number_}) {
+            *p++ = ' ';
+            p = std::to_chars(p, end - 1, counter).ptr;
+        }
+    }
 
-    return oss.str();
+    size_t length = static_cast<size_t>(p - buffer);
+    if (length + 1 > size) return 0;
+    std::memcpy(out, buffer, length);
+    out[length] = '\0';
+    return length;
 }
 
 PieceType Board::piece_on(Square sq) const {
@@ -242,62 +412,70 @@ void Board::make_move(Move move) {
     info.castle_queenside[1] = castling_[3];
     info.ep_square = ep_square_;
     info.halfmove_clock = halfmove_clock_;
+    info.plies_from_null = plies_from_null_;
     info.hash_key = hash_key_;
 
     Square from = move.from();
     Square to = move.to();
     PieceType piece = move.piece();
     Color color = stm_;
+    Color enemy = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    nnue::DirtyPieces dirty;
 
     // Remove captured piece
     if (info.captured != PieceType::NONE) {
+        dirty.remove(info.captured, enemy, to);
         remove_piece(to);
     }
 
     // Handle en passant
     if (move.is_en_passant()) {
         Square ep_capture = (color == Color::WHITE) ? to - 8 : to + 8;
+        dirty.remove(PieceType::PAWN, enemy, ep_capture);
         remove_piece(ep_capture);
     }
 
     // Move piece
+    PieceType placed = move.is_promotion() ? move.promotion() : piece;
+    dirty.remove(piece, color, from);
+    dirty.add(placed, color, to);
     remove_piece(from);
-    if (move.is_promotion()) {
-        place_piece(to, move.promotion(), color);
-    } else {
-        place_piece(to, piece, color);
-    }
+    place_piece(to, placed, color);
 
     // Handle castling
     if (move.is_castling()) {
+        Square rook_from = 64, rook_to = 64;
         if (to == square(6, rank_of(from))) { // Kingside
-            Square rook_from = square(7, rank_of(from));
-            Square rook_to = square(5, rank_of(from));
-            remove_piece(rook_from);
-            place_piece(rook_to, PieceType::ROOK, color);
+            rook_from = square(7, rank_of(from));
+            rook_to = square(5, rank_of(from));
         } else if (to == square(2, rank_of(from))) { // Queenside
-            Square rook_from = square(0, rank_of(from));
-            Square rook_to = square(3, rank_of(from));
+            rook_from = square(0, rank_of(from));
+            rook_to = square(3, rank_of(from));
+        }
+        if (rook_from < 64) {
+            dirty.remove(PieceType::ROOK, color, rook_from);
+            dirty.add(PieceType::ROOK, color, rook_to);
             remove_piece(rook_from);
             place_piece(rook_to, PieceType::ROOK, color);
         }
     }
 
-    // Update castling rights
+    if (nnue_) {
+        nnue_stack_.push_back(nnue_stack_.back());
+        nnue_->update(nnue_stack_.back(), dirty);
+    }
+
+    // Update castling rights: moving from or capturing on a corner loses that right
+    for (Square sq : {from, to}) {
+        if (sq == square(7, 0)) castling_[0] = false;
+        if (sq == square(0, 0)) castling_[1] = false;
+        if (sq == square(7, 7)) castling_[2] = false;
+        if (sq == square(0, 7)) castling_[3] = false;
+    }
     if (piece == PieceType::KING) {
         castling_[static_cast<int>(color) * 2] = false;
         castling_[static_cast<int>(color) * 2 + 1] = false;
     }
-    if (piece == PieceType::ROOK) {
-        if (from == square(0, rank_of(from))) castling_[static_cast<int>(color) * 2 + 1] = false;
-        if (from == square(7, rank_of(from))) castling_[static_cast<int>(color) * 2] = false;
-    }
-    if (to == square(0, rank_of(to)) && piece_on(to) == PieceType::ROOK) {
-        castling_[static_cast<int>(1 - static_cast<int>(color)) * 2 + 1] = false;
-    }
-    if (to == square(7, rank_of(to)) && piece_on(to) == PieceType::ROOK) {
-        castling_[static_cast<int>(1 - static_cast<int>(color)) * 2] = false;
-    }
 
     // Update en passant
     ep_square_ = 64;
@@ -314,6 +492,7 @@ void Board::make_move(Move move) {
     if (color == Color::BLACK) {
         fullmove_number_++;
     }
+    plies_from_null_++;
 
     stm_ = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
     history_.push_back(info);
@@ -326,6 +505,16 @@ void Board::unmake_move(Move move) {
     MoveInfo info = history_.back();
     history_.pop_back();
 
+    // A network attached mid-game has no accumulators for earlier positions
+    bool nnue_refresh = false;
+    if (nnue_) {
+        if (nnue_stack_.size() > 1) {
+            nnue_stack_.pop_back();
+        } else {
+            nnue_refresh = true;
+        }
+    }
+
     Square from = move.from();
     Square to = move.to();
     PieceType piece = move.piece();
@@ -373,39 +562,157 @@ void Board::unmake_move(Move move) {
                  info.castle_kingside[1], info.castle_queenside[1]};
     ep_square_ = info.ep_square;
     halfmove_clock_ = info.halfmove_clock;
+    plies_from_null_ = info.plies_from_null;
     if (color == Color::BLACK) {
         fullmove_number_--;
     }
     hash_key_ = info.hash_key;
+
+    if (nnue_refresh) {
+        nnue_->refresh(nnue_stack_.back(), *this);
+    }
+}
+
+void Board::make_null_move() {
+    MoveInfo info;
+    info.move = Move();
+    info.captured = PieceType::NONE;
+    info.castle_kingside[0] = castling_[0];
+    info.castle_kingside[1] = castling_[2];
+    info.castle_queenside[0] = castling_[1];
+    info.castle_queenside[1] = castling_[3];
+    info.ep_square = ep_square_;
+    info.halfmove_clock = halfmove_clock_;
+    info.plies_from_null = plies_from_null_;
+    info.hash_key = hash_key_;
+    history_.push_back(info);
+
+    // Only side to move and en passant change, so the hash is updated incrementally
+    if (ep_square_ < 64) {
+        hash_key_ ^= zobrist_en_passant_[file_of(ep_square_)];
+        ep_square_ = 64;
+    }
+    hash_key_ ^= zobrist_side_;
+    halfmove_clock_++;
+    plies_from_null_ = 0;
+    stm_ = (stm_ == Color::WHITE) ? Color::BLACK : Color::WHITE;
+}
+
+void Board::unmake_null_move() {
+    if (history_.empty()) return;
+
+    MoveInfo info = history_.back();
+    history_.pop_back();
+
+    stm_ = (stm_ == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    ep_square_ = info.ep_square;
+    halfmove_clock_ = info.halfmove_clock;
+    plies_from_null_ = info.plies_from_null;
+    hash_key_ = info.hash_key;
+}
+
+bool Board::is_draw(int ply) const {
+    // Fifty-move rule (a mate delivered on the hundredth ply is not detected here)
+    if (halfmove_clock_ >= 100) return true;
+    return is_repetition(ply);
+}
+
+bool Board::is_repetition(int ply) const {
+    // Only positions since the last irreversible move (or null move) with the
+    // same side to move can repeat
+    int end = std::min(halfmove_clock_, plies_from_null_);
+    int size = static_cast<int>(history_.size());
+    int count = 0;
+
+    for (int k = 4; k <= end && k <= size; k += 2) {
+        if (history_[size - k].hash_key == hash_key_) {
+            if (k < ply) return true;
+            if (++count >= 2) return true;
+        }
+    }
+    return false;
+}
+
+bool Board::has_game_cycle(int ply) const {
+    int end = std::min(halfmove_clock_, plies_from_null_);
+    int size = static_cast<int>(history_.size());
+    if (end < 3) return false;
+
+    Bitboard occupied = all_pieces();
+    for (int k = 3; k <= end && k <= size; k += 2) {
+        // The positions differ by exactly one reversible move if the key
+        // difference is in the cuckoo table
+        uint64_t move_key = hash_key_ ^ history_[size - k].hash_key;
+        int slot = cuckoo_h1(move_key);
+        if (cuckoo_keys_[slot] != move_key) {
+            slot = cuckoo_h2(move_key);
+            if (cuckoo_keys_[slot] != move_key) continue;
+        }
+
+        Move move = cuckoo_moves_[slot];
+        if (between_[move.from()][move.to()] & occupied) continue;
+
+        // Only cycles closed inside the search count; game history needs the full threefold
+        if (k < ply) return true;
+    }
+    return false;
 }
 
 bool Board::in_check(Color color) const {
-    Square king_sq = 64;
     Bitboard king_bb = pieces(PieceType::KING, color);
     if (king_bb == 0) return false;
-    
-    // Find king square
-    king_sq = __builtin_ctzll(king_bb);
 
     Color enemy = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
-    
-    // Check for attacks
-    Bitboard attacks = 0;
-    attacks |= movegen::pawn_attacks(king_sq, color);
-    attacks |= movegen::knight_attacks(king_sq);
-    attacks |= movegen::bishop_attacks(king_sq, all_pieces());
-    attacks |= movegen::rook_attacks(king_sq, all_pieces());
-    attacks |= movegen::queen_attacks(king_sq, all_pieces());
-    attacks |= movegen::king_attacks(king_sq);
+    return is_square_attacked(__builtin_ctzll(king_bb), enemy);
+}
 
-    return (attacks & all_pieces(enemy)) != 0;
+bool Board::is_square_attacked(Square sq, Color by) const {
+    Color defender = (by == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    Bitboard occupied = all_pieces();
+    Bitboard queens = pieces(PieceType::QUEEN, by);
+
+    // Each attack pattern must be matched against the piece type that produces it
+    if (movegen::pawn_attacks(sq, defender) & pieces(PieceType::PAWN, by)) return true;
+    if (movegen::knight_attacks(sq) & pieces(PieceType::KNIGHT, by)) return true;
+    if (movegen::king_attacks(sq) & pieces(PieceType::KING, by)) return true;
+    if (movegen::bishop_attacks(sq, occupied) & (pieces(PieceType::BISHOP, by) | queens)) return true;
+    if (movegen::rook_attacks(sq, occupied) & (pieces(PieceType::ROOK, by) | queens)) return true;
+    return false;
 }
 
 bool Board::is_legal_move(Move move) const {
-    // Make move and check if king is in check
-    Board temp = *this;
-    temp.make_move(move);
-    return !temp.in_check(stm_);
+    // Check the king against the post-move occupancy without making the move
+    Color us = stm_;
+    Color them = (us == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    Square from = move.from();
+    Square to = move.to();
+
+    Bitboard removed = 1ULL << to; // Enemy piece captured on this square, if any
+    if (move.is_en_passant()) {
+        removed = 1ULL << ((us == Color::WHITE) ? to - 8 : to + 8);
+    }
+
+    Bitboard occupied = (all_pieces() & ~(1ULL << from) & ~removed) | (1ULL << to);
+    if (move.is_castling()) {
+        int rank = rank_of(from);
+        Bitboard rook_path = (to > from) ? (1ULL << square(7, rank)) | (1ULL << square(5, rank))
+                                         : (1ULL << square(0, rank)) | (1ULL << square(3, rank));
+        occupied ^= rook_path;
+    }
+
+    Bitboard king_bb = pieces(PieceType::KING, us);
+    if (king_bb == 0) return true;
+    Square king_sq = (piece_on(from) == PieceType::KING) ? to : __builtin_ctzll(king_bb);
+
+    auto enemy = [&](PieceType pt) { return pieces(pt, them) & ~removed; };
+    Bitboard queens = enemy(PieceType::QUEEN);
+
+    if (movegen::pawn_attacks(king_sq, us) & enemy(PieceType::PAWN)) return false;
+    if (movegen::knight_attacks(king_sq) & enemy(PieceType::KNIGHT)) return false;
+    if (movegen::king_attacks(king_sq) & enemy(PieceType::KING)) return false;
+    if (movegen::bishop_attacks(king_sq, occupied) & (enemy(PieceType::BISHOP) | queens)) return false;
+    if (movegen::rook_attacks(king_sq, occupied) & (enemy(PieceType::ROOK) | queens)) return false;
+    return true;
 }
 
 void Board::update_hash() {
@@ -0,0 +1,291 @@
+#include "cnn_eval.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+namespace fianchetto {
+namespace cnn {
+
+namespace {
+
+// Boards per forward pass; bounds the im2col buffer (~300 KB per board for conv3)
+constexpr int BATCH_CHUNK = 16;
+
+// GEMM blocking: K is split so a block of the weight matrix stays in L2,
+// the microkernel computes up to MR x NR outputs in registers
+constexpr int KC = 128;
+constexpr int MR = 4;
+constexpr int NR = 16;
+
+// c[rows][NR] += a[rows][kc] * b[kc][NR], with leading dimensions lda/ldb/ldc
+template <int ROWS>
+void microkernel(const float* a, int lda, const float* b, int ldb, float* c, int ldc, int kc) {
+#if defined(__AVX2__) && defined(__FMA__)
+    __m256 acc[ROWS][2];
+    for (int r = 0; r < ROWS; r++) {
+        acc[r][0] = _mm256_loadu_ps(c + r * ldc);
+        acc[r][1] = _mm256_loadu_ps(c + r * ldc + 8);
+    }
+    for (int p = 0; p < kc; p++) {
+        __m256 b0 = _mm256_loadu_ps(b + p * ldb);
+        __m256 b1 = _mm256_loadu_ps(b + p * ldb + 8);
+        for (int r = 0; r < ROWS; r++) {
+            __m256 av = _mm256_broadcast_ss(a + r * lda + p);
+            acc[r][0] = _mm256_fmadd_ps(av, b0, acc[r][0]);
+            acc[r][1] = _mm256_fmadd_ps(av, b1, acc[r][1]);
+        }
+    }
+    for (int r = 0; r < ROWS; r++) {
+        _mm256_storeu_ps(c + r * ldc, acc[r][0]);
+        _mm256_storeu_ps(c + r * ldc + 8, acc[r][1]);
+    }
+#else
+    float acc[ROWS][NR];
+    for (int r = 0; r < ROWS; r++) {
+        std::memcpy(acc[r], c + r * ldc, sizeof(acc[r]));
+    }
+    for (int p = 0; p < kc; p++) {
+        const float* brow = b + p * ldb;
+        for (int r = 0; r < ROWS; r++) {
+            float av = a[r * lda + p];
+            for (int q = 0; q < NR; q++) {
+                acc[r][q] += av * brow[q];
+            }
+        }
+    }
+    for (int r = 0; r < ROWS; r++) {
+        std::memcpy(c + r * ldc, acc[r], sizeof(acc[r]));
+    }
+#endif
+}
+
+// c[m][n] = a[m][k] * b[k][n] + bias[n], optionally followed by ReLU
+void gemm(const float* a, int m, int k, const float* b, int n, const float* bias, float* c, bool relu) {
+    for (int i = 0; i < m; i++) {
+        std::memcpy(c + static_cast<size_t>(i) * n, bias, sizeof(float) * n);
+    }
+
+    int n_full = n - n % NR;
+    for (int k0 = 0; k0 < k; k0 += KC) {
+        int kc = std::min(KC, k - k0);
+        for (int i = 0; i < m; i += MR) {
+            int rows = std::min(MR, m - i);
+            const float* ablock = a + static_cast<size_t>(i) * k + k0;
+            float* cblock = c + static_cast<size_t>(i) * n;
+
+            for (int j = 0; j < n_full; j += NR) {
+                const float* bblock = b + static_cast<size_t>(k0) * n + j;
+                switch (rows) {
+                    case 4: microkernel<4>(ablock, k, bblock, n, cblock + j, n, kc); break;
+                    case 3: microkernel<3>(ablock, k, bblock, n, cblock + j, n, kc); break;
+                    case 2: microkernel<2>(ablock, k, bblock, n, cblock + j, n, kc); break;
+                    default: microkernel<1>(ablock, k, bblock, n, cblock + j, n, kc); break;
+                }
+            }
+
+            // Remaining columns (the final 1-wide layer)
+            for (int r = 0; r < rows; r++) {
+                for (int j = n_full; j < n; j++) {
+                    float sum = 0.0f;
+                    for (int p = 0; p < kc; p++) {
+                        sum += ablock[static_cast<size_t>(r) * k + p] * b[static_cast<size_t>(k0 + p) * n + j];
+                    }
+                    cblock[static_cast<size_t>(r) * n + j] += sum;
+                }
+            }
+        }
+    }
+
+    if (relu) {
+        size_t total = static_cast<size_t>(m) * n;
+        for (size_t i = 0; i < total; i++) {
+            c[i] = std::max(c[i], 0.0f);
+        }
+    }
+}
+
+// 3x3, padding 1 patches of an NHWC [count][8][8][channels] tensor; each
+// output row is [tap][channel] with tap = ky * 3 + kx
+void im2col(const float* src, int count, int channels, float* dst) {
+    size_t row_size = static_cast<size_t>(9) * channels;
+    for (int b = 0; b < count; b++) {
+        const float* board = src + static_cast<size_t>(b) * 64 * channels;
+        for (int y = 0; y < 8; y++) {
+            for (int x = 0; x < 8; x++) {
+                float* row = dst + (static_cast<size_t>(b) * 64 + y * 8 + x) * row_size;
+                for (int ky = 0; ky < 3; ky++) {
+                    for (int kx = 0; kx < 3; kx++) {
+                        float* out = row + (ky * 3 + kx) * channels;
+                        int sy = y + ky - 1;
+                        int sx = x + kx - 1;
+                        if (sy < 0 || sy > 7 || sx < 0 || sx > 7) {
+                            std::fill(out, out + channels, 0.0f);
+                        } else {
+                            std::memcpy(out, board + (sy * 8 + sx) * channels, sizeof(float) * channels);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool read_floats(std::ifstream& in, std::vector<float>& data, size_t count) {
+    data.resize(count);
+    in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(count * sizeof(float)));
+    return static_cast<bool>(in);
+}
+
+} // namespace
+
+void encode_planes(const Board& board, float* out) {
+    std::fill(out, out + PLANES * 64, 0.0f);
+    Bitboard occupied = board.all_pieces();
+    while (occupied) {
+        Square sq = __builtin_ctzll(occupied);
+        occupied &= occupied - 1;
+        int plane = static_cast<int>(board.color_on(sq)) * 6 + static_cast<int>(board.piece_on(sq)) - 1;
+        out[plane * 64 + (7 - rank_of(sq)) * 8 + file_of(sq)] = 1.0f;
+    }
+}
+
+Model::Model() : loaded_(false), hidden_(0) {}
+
+bool Model::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    char magic[4];
+    uint32_t header[2];
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 || header[0] != FILE_VERSION ||
+        header[1] == 0 || header[1] > 65536) {
+        return false;
+    }
+    int hidden = static_cast<int>(header[1]);
+
+    // Convolutions: [out][in][3][3] -> [tap][in][out]
+    auto read_conv = [&](Layer& layer, int in_channels, int out_channels) {
+        std::vector<float> raw, bias;
+        if (!read_floats(in, raw, static_cast<size_t>(out_channels) * in_channels * 9) ||
+            !read_floats(in, bias, out_channels)) {
+            return false;
+        }
+        layer.in = 9 * in_channels;
+        layer.out = out_channels;
+        layer.weights.assign(static_cast<size_t>(layer.in) * out_channels, 0.0f);
+        for (int o = 0; o < out_channels; o++) {
+            for (int c = 0; c < in_channels; c++) {
+                for (int tap = 0; tap < 9; tap++) {
+                    layer.weights[(static_cast<size_t>(tap) * in_channels + c) * out_channels + o] =
+                        raw[(static_cast<size_t>(o) * in_channels + c) * 9 + tap];
+                }
+            }
+        }
+        layer.bias = std::move(bias);
+        return true;
+    };
+
+    // Linear: [out][in] -> [in][out]; `permute` maps our input index to PyTorch's
+    auto read_linear = [&](Layer& layer, int in_features, int out_features, auto permute) {
+        std::vector<float> raw, bias;
+        if (!read_floats(in, raw, static_cast<size_t>(out_features) * in_features) ||
+            !read_floats(in, bias, out_features)) {
+            return false;
+        }
+        layer.in = in_features;
+        layer.out = out_features;
+        layer.weights.assign(static_cast<size_t>(in_features) * out_features, 0.0f);
+        for (int o = 0; o < out_features; o++) {
+            for (int i = 0; i < in_features; i++) {
+                layer.weights[static_cast<size_t>(i) * out_features + o] =
+                    raw[static_cast<size_t>(o) * in_features + permute(i)];
+            }
+        }
+        layer.bias = std::move(bias);
+        return true;
+    };
+    auto identity = [](int i) { return i; };
+    // conv3 output is NHWC ([square][channel]); PyTorch flattens NCHW ([channel][square])
+    auto nhwc_to_nchw = [](int i) { return (i % CONV3) * 64 + i / CONV3; };
+
+    Model model;
+    bool ok = read_conv(model.conv1_, PLANES, CONV1) &&
+              read_conv(model.conv2_, CONV1, CONV2) &&
+              read_conv(model.conv3_, CONV2, CONV3) &&
+              read_linear(model.fc1_, CONV3 * 64, hidden, nhwc_to_nchw) &&
+              read_linear(model.fc2_, hidden, hidden, identity) &&
+              read_linear(model.fc3_, hidden, 1, identity);
+    if (!ok) return false;
+
+    *this = std::move(model);
+    hidden_ = hidden;
+    loaded_ = true;
+    return true;
+}
+
+void Model::forward(const Board* const* boards, int count, int* scores) const {
+    // Per-thread scratch buffers so concurrent callers never share state
+    thread_local std::vector<float> input, cols, act1, act2, act3, h1, h2, out;
+    size_t squares = static_cast<size_t>(count) * 64;
+
+    input.assign(squares * PLANES, 0.0f);
+    for (int b = 0; b < count; b++) {
+        Bitboard occupied = boards[b]->all_pieces();
+        while (occupied) {
+            Square sq = __builtin_ctzll(occupied);
+            occupied &= occupied - 1;
+            int plane = static_cast<int>(boards[b]->color_on(sq)) * 6 + static_cast<int>(boards[b]->piece_on(sq)) - 1;
+            // NHWC with row 0 = rank 8, matching encode_planes
+            input[(static_cast<size_t>(b) * 64 + (sq ^ 56)) * PLANES + plane] = 1.0f;
+        }
+    }
+
+    cols.resize(squares * conv3_.in);
+    act1.resize(squares * CONV1);
+    act2.resize(squares * CONV2);
+    act3.resize(squares * CONV3);
+    h1.resize(static_cast<size_t>(count) * hidden_);
+    h2.resize(static_cast<size_t>(count) * hidden_);
+    out.resize(count);
+
+    im2col(input.data(), count, PLANES, cols.data());
+    gemm(cols.data(), static_cast<int>(squares), conv1_.in, conv1_.weights.data(), CONV1, conv1_.bias.data(), act1.data(), true);
+    im2col(act1.data(), count, CONV1, cols.data());
+    gemm(cols.data(), static_cast<int>(squares), conv2_.in, conv2_.weights.data(), CONV2, conv2_.bias.data(), act2.data(), true);
+    im2col(act2.data(), count, CONV2, cols.data());
+    gemm(cols.data(), static_cast<int>(squares), conv3_.in, conv3_.weights.data(), CONV3, conv3_.bias.data(), act3.data(), true);
+
+    // Dropout is inactive at inference time
+    gemm(act3.data(), count, fc1_.in, fc1_.weights.data(), hidden_, fc1_.bias.data(), h1.data(), true);
+    gemm(h1.data(), count, fc2_.in, fc2_.weights.data(), hidden_, fc2_.bias.data(), h2.data(), true);
+    gemm(h2.data(), count, fc3_.in, fc3_.weights.data(), 1, fc3_.bias.data(), out.data(), false);
+
+    for (int b = 0; b < count; b++) {
+        scores[b] = static_cast<int>(out[b] * 100.0f); // Same conversion as neural/src/api.py
+    }
+}
+
+std::vector<int> Model::evaluate(std::span<const Board* const> boards) const {
+    std::vector<int> scores(boards.size(), 0);
+    if (!loaded_) return scores;
+
+    for (size_t start = 0; start < boards.size(); start += BATCH_CHUNK) {
+        int count = static_cast<int>(std::min<size_t>(BATCH_CHUNK, boards.size() - start));
+        forward(boards.data() + start, count, scores.data() + start);
+    }
+    return scores;
+}
+
+int Model::evaluate(const Board& board) const {
+    const Board* boards[1] = {&board};
+    return evaluate(std::span<const Board* const>(boards, 1))[0];
+}
+
+} // namespace cnn
+} // namespace fianchetto
@@ -0,0 +1,362 @@
+#include "engine_server.hpp"
+#include "game_analysis.hpp"
+#include "json.hpp"
+#include "movegen.hpp"
+#include "pgn.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+
+namespace fianchetto {
+
+namespace {
+
+HttpResponse json_response(int status, const std::string& body) {
+    HttpResponse response;
+    response.status = status;
+    response.body = body;
+    return response;
+}
+
+HttpResponse error(int status, const std::string& message) {
+    return json_response(status, json::ObjectWriter().add("error", message).str());
+}
+
+SearchSchedulerOptions scheduler_options(const EngineServerOptions& options) {
+    SearchSchedulerOptions scheduler;
+    scheduler.threads = options.workers;
+    scheduler.hash_mb = options.hash_mb;
+    scheduler.pin_threads = options.pin_threads;
+    scheduler.hash_file = options.hash_file;
+    return scheduler;
+}
+
+} // namespace
+
+EngineServer::EngineServer(const EngineServerOptions& options, const nnue::Network* network)
+    : options_(options), network_(network), clock_(0),
+      analysis_cache_(options.analysis_cache_entries),
+      scheduler_(scheduler_options(options)),
+      http_([this](const HttpRequest& request) { return handle(request); },
+            std::max(options.workers, options.max_requests)) {}
+
+HttpResponse EngineServer::handle(const HttpRequest& request) {
+    if (request.path == "/health") {
+        if (request.method != "GET") return error(405, "use GET");
+        return json_response(200, json::ObjectWriter()
+                                      .add("status", "healthy")
+                                      .add("sessions", static_cast<unsigned long>(session_count()))
+                                      .add("workers", options_.workers)
+                                      .add("searches", static_cast<unsigned long>(scheduler_.active()))
+                                      .add("cached_positions", static_cast<unsigned long>(analysis_cache_.stats().entries))
+                                      .str());
+    }
+    if (request.path == "/move" || request.path == "/analyse") {
+        if (request.method != "POST") return error(405, "use POST");
+        return search(request, request.path == "/analyse");
+    }
+    if (request.path == "/analysegame") {
+        if (request.method != "POST") return error(405, "use POST");
+        return review_game(request);
+    }
+    if (request.path == "/hash/save") {
+        if (request.method != "POST") return error(405, "use POST");
+        return save_hash(request);
+    }
+    return error(404, "unknown endpoint");
+}
+
+HttpResponse EngineServer::save_hash(const HttpRequest& request) {
+    if (options_.hash_file.empty()) return error(409, "server has no hash file");
+
+    std::unordered_map<std::string, std::string> fields;
+    std::string session_id;
+    if (!json::parse_object(request.body, fields) || !json::get_string(fields, "session", session_id)) {
+        return error(400, "session required");
+    }
+
+    std::shared_ptr<Session> session;
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        auto it = sessions_.find(session_id);
+        if (it != sessions_.end()) session = it->second;
+    }
+    if (!session) return error(404, "unknown session");
+
+    std::lock_guard<std::mutex> lock(session->mutex);
+    if (!session->tt->save(options_.hash_file)) return error(500, "cannot write hash file");
+    return json_response(200, json::ObjectWriter()
+                                  .add("saved", options_.hash_file)
+                                  .add("size_mb", static_cast<unsigned long>(session->tt->size_mb()))
+                                  .str());
+}
+
+size_t EngineServer::session_count() {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    return sessions_.size();
+}
+
+std::shared_ptr<EngineServer::Session> EngineServer::acquire_session(const std::string& id) {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    auto it = sessions_.find(id);
+    if (it == sessions_.end()) {
+        // Drop the least recently used session; a search still running on
+        // it keeps its table alive until it finishes
+        if (sessions_.size() >= options_.max_sessions) {
+            auto oldest = std::min_element(sessions_.begin(), sessions_.end(), [](const auto& a, const auto& b) {
+                return a.second->last_used < b.second->last_used;
+            });
+            sessions_.erase(oldest);
+        }
+        it = sessions_.emplace(id, std::make_shared<Session>(options_.hash_mb, options_.hash_file)).first;
+    }
+    it->second->last_used = ++clock_;
+    return it->second;
+}
+
+HttpResponse EngineServer::search(const HttpRequest& request, bool analyse) {
+    std::unordered_map<std::string, std::string> fields;
+    if (!json::parse_object(request.body, fields)) return error(400, "body must be a JSON object");
+
+    std::string fen, session_id;
+    if (!json::get_string(fields, "fen", fen)) return error(400, "FEN string required");
+    if (fen == "startpos") fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    Board board;
+    FenError fen_error = board.parse_fen(fen);
+    if (fen_error != FenError::NONE) return error(400, std::string("invalid FEN: ") + fen_error_string(fen_error));
+    json::get_string(fields, "session", session_id);
+
+    long depth = options_.default_depth;
+    long movetime = 0, nodes = 0, priority = 1, multipv = 1;
+    if (fields.count("depth") && !json::get_int(fields, "depth", depth)) return error(400, "depth must be an integer");
+    if (fields.count("movetime") && !json::get_int(fields, "movetime", movetime)) {
+        return error(400, "movetime must be an integer");
+    }
+    if (fields.count("nodes") && !json::get_int(fields, "nodes", nodes)) return error(400, "nodes must be an integer");
+    if (fields.count("priority") && !json::get_int(fields, "priority", priority)) {
+        return error(400, "priority must be an integer");
+    }
+    if (fields.count("multipv") && !json::get_int(fields, "multipv", multipv)) {
+        return error(400, "multipv must be an integer");
+    }
+
+    SearchTask task;
+    task.params.depth = static_cast<int>(std::clamp<long>(depth, 1, options_.max_depth));
+    task.params.time_limit_ms = static_cast<int>(std::clamp<long>(movetime, 0, options_.max_movetime_ms));
+    task.params.node_limit = static_cast<uint64_t>(std::max<long>(nodes, 0));
+    task.priority = static_cast<int>(std::clamp<long>(priority, 1, options_.max_priority));
+    task.params.multi_pv = analyse ? static_cast<int>(std::clamp<long>(multipv, 1, options_.max_multipv)) : 1;
+
+    board.set_network(network_);
+
+    json::ObjectWriter out;
+    std::vector<Move> legal = movegen::generate_legal_moves(board);
+    if (legal.empty()) {
+        bool mated = board.in_check(board.side_to_move());
+        out.add_null(analyse ? "bestmove" : "move").add("result", mated ? "checkmate" : "stalemate");
+        return json_response(200, out.str());
+    }
+
+    // Earlier result for this position: answer from it when deep enough,
+    // otherwise resume deepening from it (the legality check guards
+    // against hash collisions)
+    auto start = std::chrono::steady_clock::now();
+    // (single-line results only)
+    Analysis cached;
+    bool have_cached = task.params.multi_pv == 1 && analysis_cache_.probe(board.hash(), task.params.depth, cached) &&
+                       std::find(legal.begin(), legal.end(), cached.best_move) != legal.end();
+    Analysis result = cached;
+    std::vector<PVLine> lines;
+    uint64_t searched = 0;
+
+    if (!have_cached || cached.depth < task.params.depth) {
+        if (have_cached) {
+            task.params.start_depth = cached.depth + 1;
+            task.seed_pv = cached.pv;
+            task.seed_score = cached.score;
+        }
+
+        // Session table, or a pooled one from the scheduler for anonymous requests
+        std::shared_ptr<Session> session;
+        std::unique_lock<std::mutex> session_lock;
+        if (!session_id.empty()) {
+            session = acquire_session(session_id);
+            session_lock = std::unique_lock<std::mutex>(session->mutex);
+            task.tt = session->tt.get();
+        }
+
+        SearchOutcome outcome = scheduler_.submit(board, task).get();
+        searched = outcome.stats.nodes + outcome.stats.qnodes;
+
+        // A resumed search that ran out of budget before finishing an
+        // iteration leaves the cached result standing
+        if (outcome.best_move != Move() && (!have_cached || outcome.stats.depth > cached.depth)) {
+            result.best_move = outcome.best_move;
+            result.score = outcome.stats.best_score;
+            result.depth = outcome.stats.depth;
+            result.pv = outcome.pv;
+            lines = outcome.stats.lines;
+            if (task.params.multi_pv == 1) analysis_cache_.store(board.hash(), result);
+        }
+    }
+    long elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::string move = move_to_string(result.best_move);
+    out.add(analyse ? "bestmove" : "move", move);
+
+    // Score from the side to move's point of view, plus moves to mate
+    out.add("score", result.score);
+    if (is_mate_score(result.score)) out.add("mate", mate_in_moves(result.score));
+    out.add("depth", result.depth)
+       .add("nodes", static_cast<unsigned long>(searched))
+       .add("time_ms", elapsed);
+    if (have_cached) out.add("cached", true);
+
+    if (analyse) {
+        std::vector<std::string> pv;
+        for (Move m : result.pv) pv.push_back(move_to_string(m));
+        if (pv.empty() || pv.front() != move) pv.assign(1, move);
+        out.add("pv", pv);
+
+        if (task.params.multi_pv > 1) {
+            std::string array = "[";
+            for (const PVLine& line : lines) {
+                std::vector<std::string> moves;
+                for (Move m : line.pv) moves.push_back(move_to_string(m));
+                if (array.size() > 1) array += ',';
+                array += json::ObjectWriter().add("score", line.score).add("pv", moves).str();
+            }
+            out.add_raw("lines", array + "]");
+        }
+    }
+    if (!session_id.empty()) out.add("session", session_id);
+
+    return json_response(200, out.str());
+}
+
+HttpResponse EngineServer::review_game(const HttpRequest& request) {
+    std::unordered_map<std::string, std::string> fields;
+    if (!json::parse_object(request.body, fields)) return error(400, "body must be a JSON object");
+
+    Board start;
+    std::vector<Move> moves;
+    std::string text, session_id;
+    if (json::get_string(fields, "pgn", text)) {
+        pgn::Reader reader(text);
+        pgn::Game game;
+        if (!reader.next(game) || !game.complete) return error(400, "unreadable PGN");
+        if (start.parse_fen(game.fen) != FenError::NONE) return error(400, "invalid FEN tag");
+        moves = std::move(game.moves);
+    } else {
+        std::string fen = "startpos";
+        if (fields.count("fen") && !json::get_string(fields, "fen", fen)) return error(400, "fen must be a string");
+        if (fen == "startpos") fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+        FenError fen_error = start.parse_fen(fen);
+        if (fen_error != FenError::NONE) return error(400, std::string("invalid FEN: ") + fen_error_string(fen_error));
+
+        if (!json::get_string(fields, "moves", text)) return error(400, "pgn or moves required");
+        Board board = start;
+        std::string_view list = text;
+        while (!list.empty()) {
+            size_t end = std::min(list.find(' '), list.size());
+            if (end > 0) {
+                Move move = movegen::parse_move(board, list.substr(0, end));
+                if (move == Move()) return error(400, "illegal move " + std::string(list.substr(0, end)));
+                board.make_move(move);
+                moves.push_back(move);
+            }
+            list.remove_prefix(std::min(end + 1, list.size()));
+        }
+    }
+    if (static_cast<long>(moves.size()) > options_.max_game_plies) return error(400, "game too long");
+    json::get_string(fields, "session", session_id);
+
+    long depth = options_.default_depth, movetime = 0, blunder = 200;
+    if (fields.count("depth") && !json::get_int(fields, "depth", depth)) return error(400, "depth must be an integer");
+    if (fields.count("movetime") && !json::get_int(fields, "movetime", movetime)) {
+        return error(400, "movetime must be an integer");
+    }
+    if (fields.count("blunder") && !json::get_int(fields, "blunder", blunder)) {
+        return error(400, "blunder must be an integer");
+    }
+    start.set_network(network_);
+
+    // Every position is a scheduler task, queued from the last move back so
+    // the later subtrees are in the table first. At most game_tasks of them
+    // are queued at once, so a long game takes a bounded share of the pool
+    // next to other requests, and they come from one board walked back with
+    // unmake_move. The table is lock-free, so all of the game's tasks share
+    // one: the session's, or one of its own. movetime is the budget for the
+    // whole game; each task gets its share of what is left when queued.
+    SearchTask task;
+    task.params.depth = static_cast<int>(std::clamp<long>(depth, 1, options_.max_depth));
+    const long budget = std::clamp<long>(movetime, 0, options_.max_movetime_ms);
+    const size_t in_flight = static_cast<size_t>(std::clamp(options_.game_tasks, 1, scheduler_.threads()));
+
+    auto started = std::chrono::steady_clock::now();
+    std::shared_ptr<Session> session;
+    std::unique_lock<std::mutex> session_lock;
+    std::unique_ptr<TranspositionTable> own_tt;
+    if (!session_id.empty()) {
+        session = acquire_session(session_id);
+        session_lock = std::unique_lock<std::mutex>(session->mutex);
+        task.tt = session->tt.get();
+    } else {
+        own_tt = std::make_unique<TranspositionTable>(options_.hash_mb);
+        task.tt = own_tt.get();
+    }
+
+    Board board = start;
+    for (Move move : moves) board.make_move(move);
+    const size_t count = moves.size() + 1;
+    std::vector<PositionAnalysis> positions(count);
+    std::deque<std::pair<size_t, std::future<SearchOutcome>>> pending;
+
+    auto collect = [&] {
+        auto& [index, future] = pending.front();
+        SearchOutcome outcome = future.get();
+        PositionAnalysis& position = positions[index];
+        position.nodes = outcome.stats.nodes + outcome.stats.qnodes;
+        // Out of time before any root move was searched: keep the legal move
+        if (outcome.best_move != Move()) {
+            position.best_move = outcome.best_move;
+            position.score = outcome.stats.best_score;
+            position.depth = outcome.stats.depth;
+            position.scored = true;
+        }
+        pending.pop_front();
+    };
+
+    for (size_t n = 0; n < count; n++) {
+        size_t index = count - 1 - n;
+        if (index < moves.size()) board.unmake_move(moves[index]);
+        PositionAnalysis& position = positions[index];
+        position.white_to_move = board.side_to_move() == Color::WHITE;
+        std::vector<Move> legal = movegen::generate_legal_moves(board);
+        if (legal.empty()) {
+            position.score = board.in_check(board.side_to_move()) ? -SCORE_MATE : 0;
+            position.scored = true;
+            continue;
+        }
+        position.best_move = legal.front();
+
+        if (pending.size() >= in_flight) collect();
+        if (budget > 0) {
+            long left = budget - std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     std::chrono::steady_clock::now() - started).count();
+            long share = left * static_cast<long>(in_flight) / static_cast<long>(count - n);
+            task.params.time_limit_ms = static_cast<int>(std::max(1L, share));
+        }
+        pending.emplace_back(index, scheduler_.submit(board, task));
+    }
+    while (!pending.empty()) collect();
+
+    GameAnalysis analysis = summarize_game(moves, positions, static_cast<int>(std::max<long>(blunder, 1)));
+    analysis.time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count();
+    return json_response(200, game_analysis_json(analysis));
+}
+
+} // namespace fianchetto
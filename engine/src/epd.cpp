@@ -0,0 +1,141 @@
+#include "epd.hpp"
+#include "pgn.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace fianchetto {
+namespace epd {
+
+namespace {
+
+bool is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+// "id" and the comments "c0".."c9" take a quoted string
+bool is_string_opcode(std::string_view opcode) {
+    return opcode == "id" || (opcode.size() == 2 && opcode[0] == 'c' && opcode[1] >= '0' && opcode[1] <= '9');
+}
+
+bool parse_number(std::string_view text, int& value) {
+    if (text.empty() || text.size() > 9) return false;
+    value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+// Decode the space-separated SAN moves of `operand`
+bool parse_moves(const Board& board, std::string_view operand, std::array<Move, Record::MAX_MOVES>& moves,
+                 size_t& count) {
+    size_t pos = 0;
+    while (pos < operand.size()) {
+        while (pos < operand.size() && is_space(operand[pos])) pos++;
+        size_t start = pos;
+        while (pos < operand.size() && !is_space(operand[pos])) pos++;
+        if (pos == start) break;
+        Move move = pgn::parse_san(board, operand.substr(start, pos - start));
+        if (move == Move()) return false;
+        if (count < moves.size()) moves[count++] = move;
+    }
+    return true;
+}
+
+} // namespace
+
+const Operation* Record::find(std::string_view opcode) const {
+    for (size_t i = 0; i < operation_count; i++) {
+        if (operations[i].opcode == opcode) return &operations[i];
+    }
+    return nullptr;
+}
+
+bool Record::add(std::string_view opcode, std::string_view operand) {
+    if (operation_count == operations.size()) return false;
+    operations[operation_count++] = {opcode, operand};
+    return true;
+}
+
+FenError parse(std::string_view line, Board& board, Record& record) {
+    record = Record();
+
+    size_t pos = 0;
+    FenError error = board.parse_fen(line, &pos);
+    if (error != FenError::NONE) return error;
+
+    // Operations: opcode, then operands up to an unquoted ';' (the last one
+    // may stop at the end of the line)
+    const size_t n = line.size();
+    while (true) {
+        while (pos < n && is_space(line[pos])) pos++;
+        if (pos == n) break;
+
+        size_t start = pos;
+        while (pos < n && !is_space(line[pos]) && line[pos] != ';') pos++;
+        std::string_view opcode = line.substr(start, pos - start);
+        char first = opcode.empty() ? ';' : opcode[0];
+        if (!((first >= 'a' && first <= 'z') || (first >= 'A' && first <= 'Z'))) return FenError::OPERATION;
+
+        while (pos < n && (line[pos] == ' ' || line[pos] == '\t')) pos++;
+        std::string_view operand;
+        if (pos < n && line[pos] == '"') {
+            size_t close = line.find('"', pos + 1);
+            if (close == std::string_view::npos) return FenError::OPERATION;
+            operand = line.substr(pos + 1, close - pos - 1);
+            pos = close + 1;
+            while (pos < n && is_space(line[pos])) pos++;
+            if (pos < n && line[pos] != ';') return FenError::OPERATION;
+        } else {
+            start = pos;
+            while (pos < n && line[pos] != ';' && line[pos] != '\n' && line[pos] != '\r') pos++;
+            operand = line.substr(start, pos - start);
+            while (!operand.empty() && is_space(operand.back())) operand.remove_suffix(1);
+        }
+        if (pos < n) pos++; // ';'
+
+        if (opcode == "bm" || opcode == "am") {
+            bool best = opcode == "bm";
+            if (!parse_moves(board, operand, best ? record.best_moves : record.avoid_moves,
+                             best ? record.best_move_count : record.avoid_move_count)) {
+                return FenError::MOVE;
+            }
+        } else if (opcode == "id") {
+            record.id = operand;
+        } else if (opcode == "c0") {
+            record.comment = operand;
+        } else if (opcode == "hmvc" || opcode == "fmvn") {
+            int value;
+            if (!parse_number(operand, value)) return FenError::CLOCKS;
+            if (opcode == "hmvc") board.set_halfmove_clock(value);
+            else board.set_fullmove_number(std::max(value, 1));
+        }
+        record.add(opcode, operand);
+    }
+    return FenError::NONE;
+}
+
+size_t write(const Board& board, const Record& record, char* out, size_t size) {
+    size_t length = board.write_fen(out, size, false);
+    if (length == 0) return 0;
+
+    auto append = [&](std::string_view text) {
+        if (length + text.size() + 1 > size) return false;
+        std::memcpy(out + length, text.data(), text.size());
+        length += text.size();
+        return true;
+    };
+    for (size_t i = 0; i < record.operation_count; i++) {
+        const Operation& op = record.operations[i];
+        bool quoted = is_string_opcode(op.opcode);
+        bool ok = append(" ") && append(op.opcode);
+        if (!op.operand.empty() || quoted) {
+            ok = ok && append(quoted ? " \"" : " ") && append(op.operand) && append(quoted ? "\"" : "");
+        }
+        if (!(ok && append(";"))) return 0;
+    }
+    out[length] = '\0';
+    return length;
+}
+
+} // namespace epd
+} // namespace fianchetto
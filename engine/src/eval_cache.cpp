@@ -0,0 +1,135 @@
+#include "eval_cache.hpp"
+#include <bit>
+
+namespace fianchetto {
+
+namespace {
+
+constexpr uint64_t VALID_BIT = 1ULL << 40;
+
+uint64_t pack(int score, uint8_t generation) {
+    return static_cast<uint32_t>(score) | (static_cast<uint64_t>(generation) << 32) | VALID_BIT;
+}
+
+int unpack_score(uint64_t data) {
+    return static_cast<int32_t>(static_cast<uint32_t>(data));
+}
+
+uint8_t unpack_generation(uint64_t data) {
+    return static_cast<uint8_t>(data >> 32);
+}
+
+} // namespace
+
+EvalCache::EvalCache(size_t size_mb) {
+    size_t total = (size_mb * 1024 * 1024) / sizeof(Bucket);
+    size_t per_shard = total / SHARDS;
+    shard_buckets_ = per_shard ? std::bit_floor(per_shard) : 1;
+    memory_ = platform::LargeBuffer(shard_buckets_ * SHARDS * sizeof(Bucket));
+    buckets_ = static_cast<Bucket*>(memory_.data());
+    clear();
+}
+
+EvalCache::Bucket& EvalCache::bucket_for(uint64_t hash, Shard*& shard) {
+    // Top bits pick the shard, low bits the bucket inside it
+    size_t shard_index = hash >> 60;
+    shard = &shards_[shard_index];
+    return buckets_[shard_index * shard_buckets_ + (hash & (shard_buckets_ - 1))];
+}
+
+bool EvalCache::probe(uint64_t hash, int& score) {
+    Shard* shard;
+    Bucket& bucket = bucket_for(hash, shard);
+
+    for (Slot& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t key = slot.key_xor_data.load(std::memory_order_relaxed) ^ data;
+        if ((data & VALID_BIT) && key == hash) {
+            score = unpack_score(data);
+
+            // Refresh stale entries so frequently used positions survive eviction
+            uint8_t generation = shard->generation.load(std::memory_order_relaxed);
+            if (unpack_generation(data) != generation) {
+                uint64_t fresh = pack(score, generation);
+                slot.data.store(fresh, std::memory_order_relaxed);
+                slot.key_xor_data.store(hash ^ fresh, std::memory_order_relaxed);
+            }
+            shard->hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    shard->misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void EvalCache::store(uint64_t hash, int score) {
+    Shard* shard;
+    Bucket& bucket = bucket_for(hash, shard);
+
+    // Advance the shard's generation once per quarter of its slots written
+    uint64_t stores = shard->stores.fetch_add(1, std::memory_order_relaxed) + 1;
+    uint64_t interval = (shard_buckets_ * BUCKET_SIZE + 3) / 4;
+    if (stores % interval == 0) {
+        shard->generation.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint8_t generation = shard->generation.load(std::memory_order_relaxed);
+
+    // Same key, then an empty slot, then the oldest entry
+    Slot* victim = &bucket.slots[0];
+    int victim_age = -1;
+    bool fills_empty = false;
+    for (Slot& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if (!(data & VALID_BIT)) {
+            if (!fills_empty) {
+                victim = &slot;
+                fills_empty = true;
+            }
+            continue;
+        }
+        if ((slot.key_xor_data.load(std::memory_order_relaxed) ^ data) == hash) {
+            victim = &slot;
+            fills_empty = false;
+            break;
+        }
+        int age = static_cast<uint8_t>(generation - unpack_generation(data));
+        if (!fills_empty && age > victim_age) {
+            victim = &slot;
+            victim_age = age;
+        }
+    }
+
+    uint64_t data = pack(score, generation);
+    victim->data.store(data, std::memory_order_relaxed);
+    victim->key_xor_data.store(hash ^ data, std::memory_order_relaxed);
+    if (fills_empty) {
+        shard->entries.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void EvalCache::clear() {
+    platform::parallel_clear(buckets_, shard_buckets_ * SHARDS * sizeof(Bucket));
+    for (Shard& shard : shards_) {
+        shard.hits.store(0, std::memory_order_relaxed);
+        shard.misses.store(0, std::memory_order_relaxed);
+        shard.stores.store(0, std::memory_order_relaxed);
+        shard.entries.store(0, std::memory_order_relaxed);
+        shard.generation.store(0, std::memory_order_relaxed);
+    }
+}
+
+EvalCacheStats EvalCache::stats() const {
+    EvalCacheStats result{};
+    for (const Shard& shard : shards_) {
+        result.hits += shard.hits.load(std::memory_order_relaxed);
+        result.misses += shard.misses.load(std::memory_order_relaxed);
+        result.stores += shard.stores.load(std::memory_order_relaxed);
+        result.entries += shard.entries.load(std::memory_order_relaxed);
+    }
+    result.capacity = shard_buckets_ * SHARDS * BUCKET_SIZE;
+    if (result.entries > result.capacity) result.entries = result.capacity;
+    return result;
+}
+
+} // namespace fianchetto
@@ -0,0 +1,190 @@
+#include "eval_pipeline.hpp"
+#include "search.hpp"
+#include <algorithm>
+
+namespace fianchetto {
+
+void encode_binary_position(const Board& board, uint8_t* out) {
+    for (int color = 0; color < 2; color++) {
+        for (int pt = 1; pt <= 6; pt++) {
+            Bitboard bb = board.pieces(static_cast<PieceType>(pt), static_cast<Color>(color));
+            for (int i = 0; i < 8; i++) {
+                *out++ = static_cast<uint8_t>(bb >> (8 * i));
+            }
+        }
+    }
+
+    uint8_t state = (board.side_to_move() == Color::BLACK) ? 1 : 0;
+    if (board.can_castle_kingside(Color::WHITE)) state |= 1 << 1;
+    if (board.can_castle_queenside(Color::WHITE)) state |= 1 << 2;
+    if (board.can_castle_kingside(Color::BLACK)) state |= 1 << 3;
+    if (board.can_castle_queenside(Color::BLACK)) state |= 1 << 4;
+    *out = state;
+}
+
+EvalPipeline::EvalPipeline(BatchFn backend, EvalCache& cache, size_t max_batch,
+                           size_t max_queue, int max_wait_us)
+    : backend_(std::move(backend)), cache_(cache), max_batch_(max_batch),
+      max_queue_(max_queue), max_wait_us_(max_wait_us), stop_(false),
+      submitted_(0), dropped_(0), batches_(0), evaluated_(0), failures_(0), expired_(0) {
+    worker_ = std::thread(&EvalPipeline::run, this);
+}
+
+EvalPipeline::~EvalPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+
+    // Requests that never reached the backend
+    for (Request& request : queue_) {
+        if (request.promise) request.promise->set_value(request.fallback);
+    }
+}
+
+std::future<int> EvalPipeline::submit(const Board& board, Clock::time_point deadline) {
+    std::promise<int> promise;
+    std::future<int> result = promise.get_future();
+
+    int score;
+    if (cache_.probe(board.hash(), score)) {
+        promise.set_value(score);
+        return result;
+    }
+
+    Request request;
+    request.hash = board.hash();
+    encode_binary_position(board, request.position);
+    request.deadline = deadline;
+    request.promise = std::move(promise);
+    request.fallback = evaluate(board);
+    if (board.side_to_move() == Color::BLACK) request.fallback = -request.fallback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        in_flight_.insert(request.hash);
+        queue_.push_back(std::move(request));
+    }
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    cv_.notify_one();
+    return result;
+}
+
+void EvalPipeline::prefetch(const Board& board, bool urgent, Clock::time_point deadline) {
+    int score;
+    if (cache_.probe(board.hash(), score)) return;
+
+    Request request{};
+    request.hash = board.hash();
+    request.deadline = deadline;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (in_flight_.count(request.hash)) return;
+        if (!urgent && queue_.size() >= max_queue_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        encode_binary_position(board, request.position);
+        in_flight_.insert(request.hash);
+        if (urgent) {
+            queue_.push_front(std::move(request));
+        } else {
+            queue_.push_back(std::move(request));
+        }
+    }
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    cv_.notify_one();
+}
+
+void EvalPipeline::run() {
+    std::vector<Request> batch;
+    std::vector<uint8_t> body;
+    std::vector<int> scores;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+            if (stop_) break;
+
+            // Give a partial batch a moment to fill before sending it
+            if (queue_.size() < max_batch_) {
+                cv_.wait_for(lock, std::chrono::microseconds(max_wait_us_),
+                             [&] { return stop_ || queue_.size() >= max_batch_; });
+                if (stop_) break;
+            }
+
+            // Requests past their deadline are no longer useful to anyone
+            Clock::time_point now = Clock::now();
+            batch.clear();
+            while (!queue_.empty() && batch.size() < max_batch_) {
+                Request& request = queue_.front();
+                if (request.deadline <= now) {
+                    // Count before waking the caller, who may read the stats next
+                    expired_.fetch_add(1, std::memory_order_relaxed);
+                    in_flight_.erase(request.hash);
+                    if (request.promise) request.promise->set_value(request.fallback);
+                } else {
+                    batch.push_back(std::move(request));
+                }
+                queue_.pop_front();
+            }
+            if (batch.empty()) continue;
+        }
+
+        // The batch must answer before its most urgent deadline
+        Clock::time_point deadline = Clock::time_point::max();
+        for (const Request& request : batch) {
+            deadline = std::min(deadline, request.deadline);
+        }
+        long timeout_ms = 0;
+        if (deadline != Clock::time_point::max()) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+            timeout_ms = std::max<long>(1, remaining.count());
+        }
+
+        body.resize(batch.size() * BINARY_POSITION_SIZE);
+        for (size_t i = 0; i < batch.size(); i++) {
+            std::copy(batch[i].position, batch[i].position + BINARY_POSITION_SIZE,
+                      body.begin() + i * BINARY_POSITION_SIZE);
+        }
+        scores.assign(batch.size(), 0);
+
+        bool ok = backend_(body.data(), batch.size(), scores.data(), timeout_ms);
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        if (ok) {
+            evaluated_.fetch_add(batch.size(), std::memory_order_relaxed);
+            for (size_t i = 0; i < batch.size(); i++) {
+                cache_.store(batch[i].hash, scores[i]);
+            }
+        } else {
+            failures_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Publish before clearing the in-flight marks so a racing prefetch
+        // either sees the cached score or the pending request
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (Request& request : batch) {
+                in_flight_.erase(request.hash);
+            }
+        }
+        for (size_t i = 0; i < batch.size(); i++) {
+            if (batch[i].promise) batch[i].promise->set_value(ok ? scores[i] : batch[i].fallback);
+        }
+    }
+}
+
+EvalPipelineStats EvalPipeline::stats() const {
+    EvalPipelineStats result;
+    result.submitted = submitted_.load(std::memory_order_relaxed);
+    result.dropped = dropped_.load(std::memory_order_relaxed);
+    result.batches = batches_.load(std::memory_order_relaxed);
+    result.evaluated = evaluated_.load(std::memory_order_relaxed);
+    result.failures = failures_.load(std::memory_order_relaxed);
+    result.expired = expired_.load(std::memory_order_relaxed);
+    return result;
+}
+
+} // namespace fianchetto
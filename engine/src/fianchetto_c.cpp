@@ -0,0 +1,217 @@
+#include "fianchetto.h"
+#include "board.hpp"
+#include "movegen.hpp"
+#include "search.hpp"
+#include "transposition_table.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+// C API (fianchetto.h) over Board, SearchThread and a per-handle
+// transposition table. Each search runs on its own thread against a copy
+// of the handle's position, so the position can be read while it runs.
+
+using namespace fianchetto;
+
+struct fianchetto_engine {
+    std::mutex mutex;
+    std::condition_variable finished;
+    Board board;
+    std::unique_ptr<TranspositionTable> tt; // Used by the search thread only while `searching`
+    std::thread worker;
+    std::atomic<bool> stop{false};
+    bool searching = false;
+    fianchetto_stats stats = {};
+};
+
+namespace {
+
+const char* STARTPOS = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Apply space-separated UCI moves; false (and `board` partly moved) on the
+// first one that is not legal
+bool play_moves(Board& board, std::string_view moves) {
+    size_t pos = 0;
+    while (pos < moves.size()) {
+        while (pos < moves.size() && moves[pos] == ' ') pos++;
+        size_t start = pos;
+        while (pos < moves.size() && moves[pos] != ' ') pos++;
+        if (pos == start) break;
+
+        Move found = movegen::parse_move(board, moves.substr(start, pos - start));
+        if (found == Move()) return false;
+        board.make_move(found);
+    }
+    return true;
+}
+
+// Info for the last completed iteration, with the strings in `bestmove`
+// and `pv`
+fianchetto_info make_info(Board& board, TranspositionTable& tt, const SearchStats& stats,
+                          std::chrono::steady_clock::time_point start, std::string& bestmove, std::string& pv) {
+    fianchetto_info info = {};
+    info.depth = stats.depth;
+    info.score = stats.best_score;
+    if (is_mate_score(stats.best_score)) info.mate = mate_in_moves(stats.best_score);
+    info.nodes = stats.nodes + stats.qnodes;
+    info.time_ms = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                             std::chrono::steady_clock::now() - start).count());
+    info.nps = info.nodes * 1000 / std::max<uint64_t>(info.time_ms, 1);
+
+    bestmove = stats.best_move == Move() ? "" : move_to_string(stats.best_move);
+    std::vector<Move> line = extract_pv(board, tt, stats.depth);
+    if (line.empty() || line.front() != stats.best_move) line.assign(1, stats.best_move);
+    pv.clear();
+    for (Move move : line) {
+        if (move == Move()) break;
+        if (!pv.empty()) pv += ' ';
+        pv += move_to_string(move);
+    }
+    info.bestmove = bestmove.c_str();
+    info.pv = pv.c_str();
+    return info;
+}
+
+void run_search(fianchetto_engine* engine, Board board, fianchetto_limits limits, fianchetto_callback on_progress,
+                fianchetto_callback on_done, void* user_data) {
+    SearchParams params;
+    params.node_limit = limits.nodes;
+    params.time_limit_ms = std::max(0, limits.movetime_ms);
+    params.depth = limits.depth > 0 ? std::min(limits.depth, MAX_PLY - 1)
+                                     : (limits.nodes > 0 || limits.movetime_ms > 0 ? MAX_PLY - 1 : 8);
+    params.stop = &engine->stop;
+
+    auto start = std::chrono::steady_clock::now();
+    std::string bestmove, pv;
+    fianchetto_info info = {};
+    std::vector<Move> legal = movegen::generate_legal_moves(board);
+    if (legal.empty()) {
+        info.score = board.in_check(board.side_to_move()) ? -SCORE_MATE : 0;
+        info.bestmove = info.pv = "";
+    } else {
+        // The handle's table carries over between searches (fianchetto_clear_hash resets it)
+        TranspositionTable& tt = *engine->tt;
+        SearchThread thread(board, tt, params);
+        for (int depth = 1; depth <= params.depth; depth++) {
+            if (!thread.search_iteration(depth)) break;
+            if (on_progress) {
+                fianchetto_info progress = make_info(board, tt, thread.stats(), start, bestmove, pv);
+                on_progress(&progress, user_data);
+            }
+        }
+        // Stopped before any root move was searched: still answer a legal move
+        SearchStats stats = thread.stats();
+        if (stats.best_move == Move()) stats.best_move = legal.front();
+        info = make_info(board, tt, stats, start, bestmove, pv);
+    }
+    if (on_done) on_done(&info, user_data);
+
+    std::lock_guard<std::mutex> lock(engine->mutex);
+    engine->stats.searches++;
+    engine->stats.nodes += info.nodes;
+    engine->stats.time_ms += info.time_ms;
+    engine->searching = false;
+    engine->finished.notify_all();
+}
+
+} // namespace
+
+extern "C" {
+
+int fianchetto_api_version(void) {
+    return FIANCHETTO_API_VERSION;
+}
+
+fianchetto_engine* fianchetto_create(size_t hash_mb) {
+    try {
+        auto engine = std::make_unique<fianchetto_engine>();
+        engine->tt = std::make_unique<TranspositionTable>(hash_mb > 0 ? hash_mb : 16);
+        return engine.release();
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void fianchetto_destroy(fianchetto_engine* engine) {
+    if (!engine) return;
+    fianchetto_stop(engine);
+    fianchetto_wait(engine);
+    if (engine->worker.joinable()) engine->worker.join();
+    delete engine;
+}
+
+fianchetto_status fianchetto_set_position(fianchetto_engine* engine, const char* fen, const char* moves) {
+    if (!engine) return FIANCHETTO_INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lock(engine->mutex);
+    if (engine->searching) return FIANCHETTO_BUSY;
+
+    Board board = engine->board;
+    std::string_view text = fen && std::strcmp(fen, "startpos") != 0 ? fen : STARTPOS;
+    if (board.parse_fen(text) != FenError::NONE) return FIANCHETTO_INVALID_POSITION;
+    if (moves && !play_moves(board, moves)) return FIANCHETTO_ILLEGAL_MOVE;
+    engine->board = std::move(board);
+    return FIANCHETTO_OK;
+}
+
+fianchetto_status fianchetto_get_fen(fianchetto_engine* engine, char* out, size_t size) {
+    if (!engine || !out) return FIANCHETTO_INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lock(engine->mutex);
+    return engine->board.write_fen(out, size) > 0 ? FIANCHETTO_OK : FIANCHETTO_INVALID_ARGUMENT;
+}
+
+fianchetto_status fianchetto_search(fianchetto_engine* engine, const fianchetto_limits* limits,
+                                    fianchetto_callback on_progress, fianchetto_callback on_done, void* user_data) {
+    if (!engine) return FIANCHETTO_INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lock(engine->mutex);
+    if (engine->searching) return FIANCHETTO_BUSY;
+    // The previous search thread has finished its work; reap it
+    if (engine->worker.joinable()) engine->worker.join();
+
+    fianchetto_limits copy = limits ? *limits : fianchetto_limits{};
+    engine->stop.store(false);
+    try {
+        engine->worker = std::thread(run_search, engine, engine->board, copy, on_progress, on_done, user_data);
+    } catch (const std::system_error&) {
+        return FIANCHETTO_NO_RESOURCES;
+    }
+    engine->searching = true;
+    return FIANCHETTO_OK;
+}
+
+void fianchetto_stop(fianchetto_engine* engine) {
+    if (engine) engine->stop.store(true);
+}
+
+void fianchetto_wait(fianchetto_engine* engine) {
+    if (!engine) return;
+    std::unique_lock<std::mutex> lock(engine->mutex);
+    engine->finished.wait(lock, [engine] { return !engine->searching; });
+}
+
+fianchetto_status fianchetto_clear_hash(fianchetto_engine* engine) {
+    if (!engine) return FIANCHETTO_INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lock(engine->mutex);
+    if (engine->searching) return FIANCHETTO_BUSY;
+    engine->tt->clear();
+    return FIANCHETTO_OK;
+}
+
+fianchetto_status fianchetto_get_stats(fianchetto_engine* engine, fianchetto_stats* stats) {
+    if (!engine || !stats) return FIANCHETTO_INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lock(engine->mutex);
+    *stats = engine->stats;
+    stats->searching = engine->searching ? 1 : 0;
+    return FIANCHETTO_OK;
+}
+
+} // extern "C"
@@ -0,0 +1,139 @@
+#include "game_analysis.hpp"
+#include "json.hpp"
+#include "movegen.hpp"
+#include "search.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace fianchetto {
+
+namespace {
+
+// Scores are capped before taking differences, so a move that still wins
+// (a slower mate, a queen up instead of two) is not a blunder
+constexpr int LOSS_CAP = 1000;
+
+PositionAnalysis analyse_position(Board& board, TranspositionTable& tt, const SearchParams& params) {
+    PositionAnalysis result;
+    result.white_to_move = board.side_to_move() == Color::WHITE;
+    std::vector<Move> legal = movegen::generate_legal_moves(board);
+    if (legal.empty()) {
+        result.score = board.in_check(board.side_to_move()) ? -SCORE_MATE : 0;
+        result.scored = true;
+        return result;
+    }
+
+    SearchStats stats;
+    search_root(board, tt, params, stats);
+    result.nodes = stats.nodes + stats.qnodes;
+    // Out of time before any root move was searched: still name a legal move
+    if (stats.best_move == Move()) {
+        result.best_move = legal.front();
+        return result;
+    }
+    result.best_move = stats.best_move;
+    result.score = stats.best_score;
+    result.depth = stats.depth;
+    result.scored = true;
+    return result;
+}
+
+} // namespace
+
+GameAnalysis analyse_game(const Board& start, const std::vector<Move>& moves, TranspositionTable& tt,
+                          const GameAnalysisOptions& options, const std::atomic<bool>* stop) {
+    using Clock = std::chrono::steady_clock;
+    const size_t count = moves.size() + 1;
+    const int threads = std::clamp(options.threads, 1, static_cast<int>(count));
+    const auto started = Clock::now();
+    const auto deadline = started + std::chrono::milliseconds(options.time_ms);
+
+    std::vector<PositionAnalysis> positions(count);
+    std::atomic<size_t> claimed{0};
+
+    auto worker = [&] {
+        Board board = start;
+        for (Move move : moves) board.make_move(move);
+        size_t at = moves.size();
+
+        for (size_t n = claimed.fetch_add(1); n < count; n = claimed.fetch_add(1)) {
+            size_t index = count - 1 - n;
+            while (at > index) board.unmake_move(moves[--at]);
+
+            SearchParams params;
+            params.depth = std::clamp(options.depth, 1, MAX_PLY - 1);
+            params.stop = stop;
+            if (options.time_ms > 0) {
+                // This worker's share of what is left, one position at a time
+                long left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+                long positions_left = static_cast<long>(count - n);
+                params.time_limit_ms = static_cast<int>(std::max(1L, left * threads / positions_left));
+            }
+            positions[index] = analyse_position(board, tt, params);
+        }
+    };
+
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threads; i++) helpers.emplace_back(worker);
+    worker();
+    for (std::thread& helper : helpers) helper.join();
+
+    GameAnalysis analysis = summarize_game(moves, positions, options.blunder_cp);
+    analysis.time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - started).count();
+    return analysis;
+}
+
+GameAnalysis summarize_game(const std::vector<Move>& moves, const std::vector<PositionAnalysis>& positions,
+                            int blunder_cp) {
+    GameAnalysis analysis;
+    for (const PositionAnalysis& position : positions) analysis.nodes += position.nodes;
+
+    for (size_t i = 0; i < moves.size() && i + 1 < positions.size(); i++) {
+        const PositionAnalysis& before = positions[i];
+        const PositionAnalysis& after = positions[i + 1];
+
+        PlyAnalysis ply;
+        ply.played = moves[i];
+        ply.best_move = before.best_move;
+        ply.score = before.white_to_move ? before.score : -before.score;
+        ply.depth = before.depth;
+        // Best available against what the opponent gets after the move
+        int best = std::clamp(before.score, -LOSS_CAP, LOSS_CAP);
+        int played = std::clamp(-after.score, -LOSS_CAP, LOSS_CAP);
+        bool judged = before.scored && after.scored && ply.played != ply.best_move;
+        ply.loss = judged ? std::max(0, best - played) : 0;
+        ply.blunder = ply.loss >= blunder_cp;
+        analysis.plies.push_back(ply);
+    }
+
+    if (!positions.empty()) {
+        const PositionAnalysis& last = positions[std::min(moves.size(), positions.size() - 1)];
+        analysis.final_score = last.white_to_move ? last.score : -last.score;
+    }
+    return analysis;
+}
+
+std::string game_analysis_json(const GameAnalysis& analysis) {
+    std::string plies = "[";
+    for (size_t i = 0; i < analysis.plies.size(); i++) {
+        const PlyAnalysis& ply = analysis.plies[i];
+        json::ObjectWriter out;
+        out.add("ply", static_cast<long>(i + 1)).add("move", move_to_string(ply.played)).add("score", ply.score);
+        if (ply.best_move == Move()) out.add_null("bestmove");
+        else out.add("bestmove", move_to_string(ply.best_move));
+        out.add("depth", ply.depth).add("loss", ply.loss).add("blunder", ply.blunder);
+        if (i > 0) plies += ',';
+        plies += out.str();
+    }
+    plies += "]";
+
+    return json::ObjectWriter()
+        .add_raw("plies", plies)
+        .add("final_score", analysis.final_score)
+        .add("nodes", static_cast<unsigned long>(analysis.nodes))
+        .add("time_ms", analysis.time_ms)
+        .str();
+}
+
+} // namespace fianchetto
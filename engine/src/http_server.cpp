@@ -0,0 +1,367 @@
+#include "http_server.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+
+namespace fianchetto {
+
+namespace {
+
+// epoll tags for the two non-connection descriptors
+constexpr uint64_t LISTEN_TAG = 0;
+constexpr uint64_t WAKE_TAG = 1;
+
+const char* reason_phrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default: return "Unknown";
+    }
+}
+
+HttpResponse error_response(int status, const std::string& message) {
+    HttpResponse response;
+    response.status = status;
+    response.body = "{\"error\":\"" + message + "\"}";
+    return response;
+}
+
+std::string lowercase(std::string_view text) {
+    std::string out(text);
+    for (char& c : out) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return out;
+}
+
+} // namespace
+
+HttpServer::HttpServer(Handler handler, int workers)
+    : handler_(std::move(handler)), listen_fd_(-1), epoll_fd_(-1), event_fd_(-1), port_(0),
+      stopping_(false), next_connection_(2) {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = WAKE_TAG;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, event_fd_, &ev);
+
+    for (int i = 0; i < std::max(1, workers); i++) {
+        workers_.emplace_back(&HttpServer::worker_loop, this);
+    }
+}
+
+HttpServer::~HttpServer() {
+    stop();
+    {
+        std::lock_guard<std::mutex> lock(job_mutex_);
+        jobs_.clear();
+    }
+    job_cv_.notify_all();
+    for (std::thread& worker : workers_) worker.join();
+
+    for (auto& [id, connection] : connections_) close(connection.fd);
+    if (listen_fd_ >= 0) close(listen_fd_);
+    close(event_fd_);
+    close(epoll_fd_);
+}
+
+bool HttpServer::listen(const std::string& host, int port) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) return false;
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) return false;
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) return false;
+    if (::listen(listen_fd_, 128) < 0) return false;
+
+    socklen_t len = sizeof(addr);
+    getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = LISTEN_TAG;
+    return epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &ev) == 0;
+}
+
+void HttpServer::stop() {
+    // Only async-signal-safe calls: workers are woken by the destructor
+    stopping_.store(true);
+    uint64_t one = 1;
+    [[maybe_unused]] ssize_t n = write(event_fd_, &one, sizeof(one));
+}
+
+void HttpServer::run() {
+    epoll_event events[64];
+    while (!stopping_) {
+        int count = epoll_wait(epoll_fd_, events, 64, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            uint64_t tag = events[i].data.u64;
+            if (tag == LISTEN_TAG) {
+                accept_connections();
+            } else if (tag == WAKE_TAG) {
+                uint64_t value;
+                while (read(event_fd_, &value, sizeof(value)) > 0) {
+                }
+                drain_completions();
+            } else {
+                if (events[i].events & EPOLLOUT) write_connection(tag);
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) read_connection(tag);
+            }
+        }
+    }
+}
+
+void HttpServer::accept_connections() {
+    while (true) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        uint64_t id = next_connection_++;
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = id;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            close(fd);
+            continue;
+        }
+        connections_[id].fd = fd;
+    }
+}
+
+void HttpServer::read_connection(uint64_t id) {
+    auto it = connections_.find(id);
+    if (it == connections_.end()) return;
+    Connection& connection = it->second;
+
+    char buffer[16384];
+    while (true) {
+        ssize_t n = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            connection.in.append(buffer, n);
+            if (connection.in.size() > MAX_HEADER_SIZE + MAX_BODY_SIZE) {
+                close_connection(id);
+                return;
+            }
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n < 0 && errno == EINTR) continue;
+        // Peer closed or failed; a response still being computed is dropped
+        close_connection(id);
+        return;
+    }
+
+    if (!connection.busy) dispatch(id);
+}
+
+void HttpServer::dispatch(uint64_t id) {
+    Connection& connection = connections_.at(id);
+    size_t header_end = connection.in.find("\r\n\r\n");
+    if (header_end == std::string::npos) {
+        if (connection.in.size() > MAX_HEADER_SIZE) {
+            connection.keep_alive = false;
+            connection.busy = true;
+            queue_response(id, error_response(431, "headers too large"));
+        }
+        return;
+    }
+
+    // Request line
+    std::string_view head(connection.in.data(), header_end);
+    size_t line_end = head.find("\r\n");
+    std::string_view request_line = head.substr(0, line_end);
+    size_t sp1 = request_line.find(' ');
+    size_t sp2 = request_line.rfind(' ');
+    connection.busy = true;
+    if (sp1 == std::string_view::npos || sp2 == sp1) {
+        connection.keep_alive = false;
+        queue_response(id, error_response(400, "malformed request line"));
+        return;
+    }
+
+    HttpRequest request;
+    request.method = std::string(request_line.substr(0, sp1));
+    request.path = std::string(request_line.substr(sp1 + 1, sp2 - sp1 - 1));
+    std::string_view version = request_line.substr(sp2 + 1);
+    size_t query = request.path.find('?');
+    if (query != std::string::npos) request.path.resize(query);
+
+    // Headers
+    size_t content_length = 0;
+    bool keep_alive = version == "HTTP/1.1";
+    std::string_view rest = line_end == std::string_view::npos ? std::string_view() : head.substr(line_end + 2);
+    while (!rest.empty()) {
+        size_t eol = rest.find("\r\n");
+        std::string_view line = rest.substr(0, eol);
+        rest = eol == std::string_view::npos ? std::string_view() : rest.substr(eol + 2);
+
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) continue;
+        std::string name = lowercase(line.substr(0, colon));
+        std::string_view value = line.substr(colon + 1);
+        while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+
+        if (name == "content-length") {
+            auto result = std::from_chars(value.data(), value.data() + value.size(), content_length);
+            if (result.ec != std::errc()) {
+                connection.keep_alive = false;
+                queue_response(id, error_response(400, "bad content-length"));
+                return;
+            }
+        } else if (name == "connection") {
+            std::string token = lowercase(value);
+            if (token == "close") keep_alive = false;
+            if (token == "keep-alive") keep_alive = true;
+        } else if (name == "transfer-encoding") {
+            connection.keep_alive = false;
+            queue_response(id, error_response(501, "chunked bodies are not supported"));
+            return;
+        }
+    }
+
+    if (content_length > MAX_BODY_SIZE) {
+        connection.keep_alive = false;
+        queue_response(id, error_response(413, "body too large"));
+        return;
+    }
+    if (connection.in.size() < header_end + 4 + content_length) {
+        connection.busy = false; // Wait for the rest of the body
+        return;
+    }
+
+    request.body = connection.in.substr(header_end + 4, content_length);
+    connection.in.erase(0, header_end + 4 + content_length);
+    connection.keep_alive = keep_alive;
+
+    {
+        std::lock_guard<std::mutex> lock(job_mutex_);
+        jobs_.push_back(Job{id, std::move(request)});
+    }
+    job_cv_.notify_one();
+}
+
+void HttpServer::queue_response(uint64_t id, const HttpResponse& response) {
+    Connection& connection = connections_.at(id);
+    connection.out += "HTTP/1.1 " + std::to_string(response.status) + " " + reason_phrase(response.status) + "\r\n";
+    connection.out += "Content-Type: " + response.content_type + "\r\n";
+    connection.out += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+    connection.out += connection.keep_alive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    connection.out += response.body;
+    write_connection(id);
+}
+
+void HttpServer::write_connection(uint64_t id) {
+    auto it = connections_.find(id);
+    if (it == connections_.end()) return;
+    Connection& connection = it->second;
+
+    while (connection.out_sent < connection.out.size()) {
+        ssize_t n = send(connection.fd, connection.out.data() + connection.out_sent,
+                         connection.out.size() - connection.out_sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            connection.out_sent += n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!connection.want_write) {
+                epoll_event ev{};
+                ev.events = EPOLLIN | EPOLLOUT;
+                ev.data.u64 = id;
+                epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd, &ev);
+                connection.want_write = true;
+            }
+            return;
+        }
+        close_connection(id);
+        return;
+    }
+
+    // Response fully sent
+    connection.out.clear();
+    connection.out_sent = 0;
+    if (connection.want_write) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = id;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd, &ev);
+        connection.want_write = false;
+    }
+    if (!connection.busy) return;
+    if (!connection.keep_alive) {
+        close_connection(id);
+        return;
+    }
+    connection.busy = false;
+    dispatch(id); // The next request may already be buffered
+}
+
+void HttpServer::drain_completions() {
+    std::vector<Completion> completions;
+    {
+        std::lock_guard<std::mutex> lock(completion_mutex_);
+        completions.swap(completions_);
+    }
+    for (Completion& completion : completions) {
+        if (!connections_.count(completion.connection)) continue; // Client went away
+        queue_response(completion.connection, completion.response);
+    }
+}
+
+void HttpServer::close_connection(uint64_t id) {
+    auto it = connections_.find(id);
+    if (it == connections_.end()) return;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    close(it->second.fd);
+    connections_.erase(it);
+}
+
+void HttpServer::worker_loop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(job_mutex_);
+            job_cv_.wait(lock, [&] { return stopping_ || !jobs_.empty(); });
+            if (stopping_) return;
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+
+        HttpResponse response = handler_(job.request);
+
+        {
+            std::lock_guard<std::mutex> lock(completion_mutex_);
+            completions_.push_back(Completion{job.connection, std::move(response)});
+        }
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t n = write(event_fd_, &one, sizeof(one));
+    }
+}
+
+} // namespace fianchetto
@@ -0,0 +1,242 @@
+#include "json.hpp"
+#include <charconv>
+#include <cstdio>
+
+namespace fianchetto {
+namespace json {
+
+namespace {
+
+struct Parser {
+    std::string_view text;
+    size_t pos = 0;
+
+    void skip_ws() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' ||
+                                     text[pos] == '\n' || text[pos] == '\r')) {
+            pos++;
+        }
+    }
+
+    bool consume(char c) {
+        skip_ws();
+        if (pos < text.size() && text[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    static int hex_value(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    bool parse_string(std::string& out) {
+        if (!consume('"')) return false;
+        out.clear();
+        while (pos < text.size()) {
+            char c = text[pos++];
+            if (c == '"') return true;
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= text.size()) return false;
+            char e = text[pos++];
+            switch (e) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    if (pos + 4 > text.size()) return false;
+                    unsigned code = 0;
+                    for (int i = 0; i < 4; i++) {
+                        int v = hex_value(text[pos++]);
+                        if (v < 0) return false;
+                        code = code * 16 + v;
+                    }
+                    // UTF-8 encode (BMP only; surrogates are kept as-is)
+                    if (code < 0x80) {
+                        out += static_cast<char>(code);
+                    } else if (code < 0x800) {
+                        out += static_cast<char>(0xC0 | (code >> 6));
+                        out += static_cast<char>(0x80 | (code & 0x3F));
+                    } else {
+                        out += static_cast<char>(0xE0 | (code >> 12));
+                        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                        out += static_cast<char>(0x80 | (code & 0x3F));
+                    }
+                    break;
+                }
+                default: return false;
+            }
+        }
+        return false;
+    }
+
+    // Raw text of a number, literal, array or object
+    bool parse_raw(std::string& out) {
+        skip_ws();
+        size_t start = pos;
+        int depth = 0;
+        bool in_string = false;
+        while (pos < text.size()) {
+            char c = text[pos];
+            if (in_string) {
+                if (c == '\\') pos++;
+                else if (c == '"') in_string = false;
+            } else if (c == '"') {
+                in_string = true;
+            } else if (c == '[' || c == '{') {
+                depth++;
+            } else if (c == ']' || c == '}') {
+                if (depth == 0) break;
+                depth--;
+            } else if (c == ',' && depth == 0) {
+                break;
+            }
+            pos++;
+        }
+        if (depth != 0 || in_string) return false;
+        size_t end = pos;
+        while (end > start && (text[end - 1] == ' ' || text[end - 1] == '\t' ||
+                               text[end - 1] == '\n' || text[end - 1] == '\r')) {
+            end--;
+        }
+        if (end == start) return false;
+        out.assign(text.substr(start, end - start));
+        return true;
+    }
+};
+
+} // namespace
+
+bool parse_object(std::string_view text, std::unordered_map<std::string, std::string>& fields) {
+    Parser parser{text};
+    fields.clear();
+    if (!parser.consume('{')) return false;
+    if (parser.consume('}')) {
+        parser.skip_ws();
+        return parser.pos == text.size();
+    }
+
+    while (true) {
+        std::string key, value;
+        if (!parser.parse_string(key)) return false;
+        if (!parser.consume(':')) return false;
+        parser.skip_ws();
+        bool ok = parser.pos < text.size() && text[parser.pos] == '"'
+                      ? parser.parse_string(value)
+                      : parser.parse_raw(value);
+        if (!ok) return false;
+        fields[key] = value;
+
+        if (parser.consume(',')) continue;
+        if (!parser.consume('}')) return false;
+        break;
+    }
+    parser.skip_ws();
+    return parser.pos == text.size();
+}
+
+bool get_int(const std::unordered_map<std::string, std::string>& fields, const std::string& key, long& out) {
+    auto it = fields.find(key);
+    if (it == fields.end()) return false;
+    const std::string& raw = it->second;
+    auto result = std::from_chars(raw.data(), raw.data() + raw.size(), out);
+    return result.ec == std::errc() && result.ptr == raw.data() + raw.size();
+}
+
+bool get_string(const std::unordered_map<std::string, std::string>& fields, const std::string& key, std::string& out) {
+    auto it = fields.find(key);
+    if (it == fields.end()) return false;
+    out = it->second;
+    return true;
+}
+
+std::string quote(std::string_view text) {
+    std::string out = "\"";
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+    return out;
+}
+
+void ObjectWriter::key(std::string_view key) {
+    if (!body_.empty()) body_ += ',';
+    body_ += quote(key);
+    body_ += ':';
+}
+
+ObjectWriter& ObjectWriter::add(std::string_view k, std::string_view value) {
+    key(k);
+    body_ += quote(value);
+    return *this;
+}
+
+ObjectWriter& ObjectWriter::add(std::string_view k, long value) {
+    key(k);
+    body_ += std::to_string(value);
+    return *this;
+}
+
+ObjectWriter& ObjectWriter::add(std::string_view k, unsigned long value) {
+    key(k);
+    body_ += std::to_string(value);
+    return *this;
+}
+
+ObjectWriter& ObjectWriter::add(std::string_view k, bool value) {
+    key(k);
+    body_ += value ? "true" : "false";
+    return *this;
+}
+
+ObjectWriter& ObjectWriter::add(std::string_view k, const std::vector<std::string>& values) {
+    key(k);
+    body_ += '[';
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i > 0) body_ += ',';
+        body_ += quote(values[i]);
+    }
+    body_ += ']';
+    return *this;
+}
+
+ObjectWriter& ObjectWriter::add_null(std::string_view k) {
+    key(k);
+    body_ += "null";
+    return *this;
+}
+
+ObjectWriter& ObjectWriter::add_raw(std::string_view k, std::string_view json) {
+    key(k);
+    body_ += json;
+    return *this;
+}
+
+} // namespace json
+} // namespace fianchetto
@@ -298,29 +298,18 @@ std::vector<Move> generate_moves(const Board& board) {
             moves.push_back(Move(from, to, PieceType::KING, captured));
         }
 
-        // Castling
+        // Castling: the king may not castle out of or through check
         int rank = rank_of(from);
-        if (stm == Color::WHITE) {
-            if (board.can_castle_kingside(Color::WHITE)) {
-                if ((all_occupied & (0x60ULL << (rank * 8))) == 0) {
-                    moves.push_back(Move(from, square(6, rank), PieceType::KING, PieceType::NONE, PieceType::NONE, MOVE_FLAG_CASTLE_KINGSIDE));
-                }
-            }
-            if (board.can_castle_queenside(Color::WHITE)) {
-                if ((all_occupied & (0x0EULL << (rank * 8))) == 0) {
-                    moves.push_back(Move(from, square(2, rank), PieceType::KING, PieceType::NONE, PieceType::NONE, MOVE_FLAG_CASTLE_QUEENSIDE));
-                }
+        if (board.can_castle_kingside(stm) && !board.is_square_attacked(from, enemy)) {
+            if ((all_occupied & (0x60ULL << (rank * 8))) == 0 &&
+                !board.is_square_attacked(square(5, rank), enemy)) {
+                moves.push_back(Move(from, square(6, rank), PieceType::KING, PieceType::NONE, PieceType::NONE, MOVE_FLAG_CASTLE_KINGSIDE));
             }
-        } else {
-            if (board.can_castle_kingside(Color::BLACK)) {
-                if ((all_occupied & (0x60ULL << (rank * 8))) == 0) {
-                    moves.push_back(Move(from, square(6, rank), PieceType::KING, PieceType::NONE, PieceType::NONE, MOVE_FLAG_CASTLE_KINGSIDE));
-                }
-            }
-            if (board.can_castle_queenside(Color::BLACK)) {
-                if ((all_occupied & (0x0EULL << (rank * 8))) == 0) {
-                    moves.push_back(Move(from, square(2, rank), PieceType::KING, PieceType::NONE, PieceType::NONE, MOVE_FLAG_CASTLE_QUEENSIDE));
-                }
+        }
+        if (board.can_castle_queenside(stm) && !board.is_square_attacked(from, enemy)) {
+            if ((all_occupied & (0x0EULL << (rank * 8))) == 0 &&
+                !board.is_square_attacked(square(3, rank), enemy)) {
+                moves.push_back(Move(from, square(2, rank), PieceType::KING, PieceType::NONE, PieceType::NONE, MOVE_FLAG_CASTLE_QUEENSIDE));
             }
         }
     }
@@ -341,6 +330,22 @@ std::vector<Move> generate_legal_moves(const Board& board) {
     return legal;
 }
 
+Move parse_move(const Board& board, std::string_view uci) {
+    if (uci.size() < 4 || uci.size() > 5) return Move();
+    for (size_t i = 0; i < 4; i += 2) {
+        if (uci[i] < 'a' || uci[i] > 'h' || uci[i + 1] < '1' || uci[i + 1] > '8') return Move();
+    }
+    Move wanted = string_to_move(uci);
+    if (uci.size() == 5 && wanted.promotion() == PieceType::NONE) return Move();
+
+    for (Move move : generate_moves(board)) {
+        if (move.from() == wanted.from() && move.to() == wanted.to() && move.promotion() == wanted.promotion()) {
+            return board.is_legal_move(move) ? move : Move();
+        }
+    }
+    return Move();
+}
+
 uint64_t perft(Board& board, int depth) {
     if (depth == 0) return 1;
     if (depth == 1) {
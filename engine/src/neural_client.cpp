@@ -1,90 +1,249 @@
 #ifdef USE_NEURAL
 
 #include "neural_client.hpp"
+#include "search.hpp"
 #include <curl/curl.h>
-#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <mutex>
 
 namespace fianchetto {
 
-static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* data) {
+namespace {
+
+size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* data) {
     size_t total_size = size * nmemb;
     data->append((char*)contents, total_size);
     return total_size;
 }
 
-NeuralClient::NeuralClient(const std::string& url) : url_(url) {
-    curl_global_init(CURL_GLOBAL_DEFAULT);
+// One easy handle per thread, reused across requests so libcurl keeps the
+// TCP connection to the neural service alive
+struct CurlHandle {
+    CURL* curl = nullptr;
+    struct curl_slist* headers = nullptr;
+    std::string response;
+
+    CurlHandle() {
+        curl = curl_easy_init();
+        headers = curl_slist_append(headers, "Content-Type: application/octet-stream");
+        headers = curl_slist_append(headers, "Expect:"); // No 100-continue round trip for larger batches
+        if (curl) {
+            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+            curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+            curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1L);
+            curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        }
+    }
+
+    ~CurlHandle() {
+        if (curl) curl_easy_cleanup(curl);
+        curl_slist_free_all(headers);
+    }
+
+    void prepare(const std::string& url, const uint8_t* positions, size_t count,
+                 long timeout_ms, long connect_timeout_ms) {
+        response.clear();
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, positions);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(count * BINARY_POSITION_SIZE));
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeout_ms);
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, std::min(connect_timeout_ms, timeout_ms));
+    }
+
+    // Response: one little-endian int32 centipawn score per position
+    bool read_scores(size_t count, int* scores) const {
+        long status = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+        if (status != 200 || response.size() != count * sizeof(int32_t)) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            int32_t score;
+            std::memcpy(&score, response.data() + i * sizeof(int32_t), sizeof(score));
+            scores[i] = score;
+        }
+        return true;
+    }
+};
+
+CurlHandle& thread_handle() {
+    thread_local CurlHandle handle;
+    return handle;
 }
 
-int NeuralClient::http_evaluate(const std::string& fen) {
-    CURL* curl = curl_easy_init();
-    if (!curl) return 0;
+// Primary and hedge handles driven by one multi handle (shared connection cache)
+struct HedgeHandles {
+    CURLM* multi = curl_multi_init();
+    CurlHandle primary;
+    CurlHandle hedge;
 
-    std::string response;
-    std::ostringstream json;
-    json << "{\"fen\":\"" << fen << "\"}";
+    ~HedgeHandles() { curl_multi_cleanup(multi); }
+};
 
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
+HedgeHandles& thread_hedge_handles() {
+    thread_local HedgeHandles handles;
+    return handles;
+}
 
-    curl_easy_setopt(curl, CURLOPT_URL, url_.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json.str().c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+std::once_flag curl_init_flag;
+
+// Classical evaluation on the neural service's scale (white's perspective)
+int fallback_score(const Board& board) {
+    int score = fianchetto::evaluate(board);
+    return board.side_to_move() == Color::WHITE ? score : -score;
+}
 
-    CURLcode res = curl_easy_perform(curl);
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
+} // namespace
 
-    if (res != CURLE_OK) {
-        return 0;
+NeuralClient::NeuralClient(const std::string& url, const NeuralClientOptions& options)
+    : url_(url), options_(options), cache_(options.cache_mb),
+      breaker_(options.breaker_failures, options.breaker_cooldown_ms), hedged_(0) {
+    std::call_once(curl_init_flag, [] { curl_global_init(CURL_GLOBAL_DEFAULT); });
+
+    // ".../evaluate" -> ".../evaluate_batch"
+    const std::string suffix = "/evaluate";
+    if (url_.size() >= suffix.size() && url_.compare(url_.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        batch_url_ = url_ + "_batch";
+    } else {
+        batch_url_ = url_ + "/evaluate_batch";
+    }
+}
+
+bool NeuralClient::perform(const uint8_t* positions, size_t count, int* scores, long timeout_ms) {
+    CurlHandle& handle = thread_handle();
+    if (!handle.curl) return false;
+
+    handle.prepare(batch_url_, positions, count, timeout_ms, options_.connect_timeout_ms);
+    if (curl_easy_perform(handle.curl) != CURLE_OK) {
+        return false;
     }
+    return handle.read_scores(count, scores);
+}
 
-    // Parse JSON response (simplified)
-    // Expected: {"score": 42}
-    size_t pos = response.find("\"score\":");
-    if (pos != std::string::npos) {
-        pos += 8;
-        while (pos < response.length() && (response[pos] == ' ' || response[pos] == ':')) pos++;
-        return std::stoi(response.substr(pos));
+bool NeuralClient::perform_hedged(const uint8_t* positions, size_t count, int* scores, long timeout_ms) {
+    HedgeHandles& handles = thread_hedge_handles();
+    if (!handles.multi || !handles.primary.curl || !handles.hedge.curl) return false;
+
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed_ms = [&] {
+        return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    };
+
+    handles.primary.prepare(batch_url_, positions, count, timeout_ms, options_.connect_timeout_ms);
+    curl_multi_add_handle(handles.multi, handles.primary.curl);
+    bool primary_active = true;
+    bool hedge_active = false;
+    bool hedged = false;
+    bool ok = false;
+
+    while (!ok && (primary_active || hedge_active)) {
+        int running = 0;
+        curl_multi_perform(handles.multi, &running);
+
+        int left = 0;
+        while (CURLMsg* msg = curl_multi_info_read(handles.multi, &left)) {
+            if (msg->msg != CURLMSG_DONE) continue;
+            bool is_primary = msg->easy_handle == handles.primary.curl;
+            CurlHandle& handle = is_primary ? handles.primary : handles.hedge;
+            if (!ok && msg->data.result == CURLE_OK && handle.read_scores(count, scores)) {
+                ok = true;
+            }
+            curl_multi_remove_handle(handles.multi, handle.curl);
+            (is_primary ? primary_active : hedge_active) = false;
+        }
+        if (ok || (!primary_active && !hedge_active)) break;
+
+        // The primary is slow rather than failed: race a second copy of it
+        // against the remaining deadline
+        long elapsed = elapsed_ms();
+        if (!hedged && elapsed >= options_.hedge_after_ms && timeout_ms - elapsed > 0) {
+            handles.hedge.prepare(batch_url_, positions, count, timeout_ms - elapsed,
+                                  options_.connect_timeout_ms);
+            curl_multi_add_handle(handles.multi, handles.hedge.curl);
+            hedge_active = true;
+            hedged = true;
+            hedged_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        int wait_ms = hedged ? 50 : static_cast<int>(std::clamp(options_.hedge_after_ms - elapsed, 1L, 50L));
+        curl_multi_poll(handles.multi, nullptr, 0, wait_ms, nullptr);
     }
 
-    return 0;
+    // Abandon the losing request
+    if (primary_active) curl_multi_remove_handle(handles.multi, handles.primary.curl);
+    if (hedge_active) curl_multi_remove_handle(handles.multi, handles.hedge.curl);
+    return ok;
 }
 
-int NeuralClient::evaluate(const Board& board) {
-    uint64_t hash = board.hash();
-    
+bool NeuralClient::evaluate_encoded(const uint8_t* positions, size_t count, int* scores, long timeout_ms) {
+    if (!breaker_.allow()) return false;
+
+    if (timeout_ms <= 0) timeout_ms = options_.request_timeout_ms;
+    auto start = std::chrono::steady_clock::now();
+    bool ok = options_.hedge_after_ms > 0 && options_.hedge_after_ms < timeout_ms
+                  ? perform_hedged(positions, count, scores, timeout_ms)
+                  : perform(positions, count, scores, timeout_ms);
+    latency_.record(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+
+    if (ok) {
+        breaker_.record_success();
+    } else {
+        breaker_.record_failure();
+    }
+    return ok;
+}
+
+std::vector<int> NeuralClient::evaluate_batch(std::span<const Board* const> boards, long timeout_ms) {
+    std::vector<int> scores(boards.size(), 0);
+    std::vector<size_t> misses;
+
     // Check cache
-    {
-        std::lock_guard<std::mutex> lock(cache_mutex_);
-        auto it = cache_.find(hash);
-        if (it != cache_.end()) {
-            return it->second;
+    for (size_t i = 0; i < boards.size(); i++) {
+        if (!cache_.probe(boards[i]->hash(), scores[i])) {
+            misses.push_back(i);
         }
     }
+    if (misses.empty()) return scores;
 
     // Call neural service
-    std::string fen = board.get_fen();
-    int score = http_evaluate(fen);
+    std::vector<uint8_t> body(misses.size() * BINARY_POSITION_SIZE);
+    for (size_t i = 0; i < misses.size(); i++) {
+        encode_binary_position(*boards[misses[i]], body.data() + i * BINARY_POSITION_SIZE);
+    }
+    std::vector<int> fetched(misses.size(), 0);
+    if (!evaluate_encoded(body.data(), misses.size(), fetched.data(), timeout_ms)) {
+        for (size_t i : misses) {
+            scores[i] = fallback_score(*boards[i]);
+        }
+        return scores;
+    }
 
-    // Cache result
-    {
-        std::lock_guard<std::mutex> lock(cache_mutex_);
-        cache_[hash] = score;
+    // Cache results
+    for (size_t i = 0; i < misses.size(); i++) {
+        scores[misses[i]] = fetched[i];
+        cache_.store(boards[misses[i]]->hash(), fetched[i]);
     }
 
-    return score;
+    return scores;
+}
+
+int NeuralClient::evaluate(const Board& board, long timeout_ms) {
+    const Board* boards[1] = {&board};
+    return evaluate_batch(std::span<const Board* const>(boards, 1), timeout_ms)[0];
 }
 
 void NeuralClient::clear_cache() {
-    std::lock_guard<std::mutex> lock(cache_mutex_);
     cache_.clear();
 }
 
 } // namespace fianchetto
 
 #endif // USE_NEURAL
-
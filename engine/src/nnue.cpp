@@ -0,0 +1,285 @@
+#include "nnue.hpp"
+#include "board.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace fianchetto {
+namespace nnue {
+
+namespace {
+
+// SIMD kernels. AVX2 and SSE4.1 paths are selected at compile time
+// (see NATIVE_ARCH in CMakeLists.txt); the scalar path is the reference.
+
+void add_column(int16_t* acc, const int16_t* column) {
+#if defined(__AVX2__)
+    for (int i = 0; i < HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_add_epi16(a, w));
+    }
+#elif defined(__SSE4_1__)
+    for (int i = 0; i < HIDDEN; i += 8) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i));
+        _mm_store_si128(reinterpret_cast<__m128i*>(acc + i), _mm_add_epi16(a, w));
+    }
+#else
+    for (int i = 0; i < HIDDEN; i++) {
+        acc[i] += column[i];
+    }
+#endif
+}
+
+void sub_column(int16_t* acc, const int16_t* column) {
+#if defined(__AVX2__)
+    for (int i = 0; i < HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_sub_epi16(a, w));
+    }
+#elif defined(__SSE4_1__)
+    for (int i = 0; i < HIDDEN; i += 8) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i));
+        _mm_store_si128(reinterpret_cast<__m128i*>(acc + i), _mm_sub_epi16(a, w));
+    }
+#else
+    for (int i = 0; i < HIDDEN; i++) {
+        acc[i] -= column[i];
+    }
+#endif
+}
+
+// Clipped ReLU from int16 accumulator values to [0, ACTIVATION_MAX] bytes
+void clip_accumulator(const int16_t* acc, uint8_t* out) {
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    for (int i = 0; i < HIDDEN; i += 32) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i + 16));
+        // packs works per 128-bit lane, so restore the element order afterwards
+        __m256i packed = _mm256_max_epi8(_mm256_packs_epi16(a, b), zero);
+        packed = _mm256_permute4x64_epi64(packed, 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+#elif defined(__SSE4_1__)
+    const __m128i zero = _mm_setzero_si128();
+    for (int i = 0; i < HIDDEN; i += 16) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(acc + i + 8));
+        __m128i packed = _mm_max_epi8(_mm_packs_epi16(a, b), zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+#else
+    for (int i = 0; i < HIDDEN; i++) {
+        out[i] = static_cast<uint8_t>(std::clamp<int>(acc[i], 0, ACTIVATION_MAX));
+    }
+#endif
+}
+
+#if defined(__AVX2__)
+int32_t horizontal_sum(__m256i v) {
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+}
+#elif defined(__SSE4_1__)
+int32_t horizontal_sum(__m128i sum) {
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+}
+#endif
+
+// out[j] = bias[j] + sum_i input[i] * weights[j][i]; in_dims is a multiple of 32
+void affine(const uint8_t* input, int in_dims, const int8_t* weights, const int32_t* bias,
+            int32_t* out, int out_dims) {
+    for (int j = 0; j < out_dims; j++) {
+        const int8_t* row = weights + static_cast<size_t>(j) * in_dims;
+#if defined(__AVX2__)
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256i sum = _mm256_setzero_si256();
+        for (int i = 0; i < in_dims; i += 32) {
+            __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+            __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+            // u8 x i8 pairs fit in int16: 2 * 127 * 127 < 32767
+            __m256i products = _mm256_madd_epi16(_mm256_maddubs_epi16(in, w), ones);
+            sum = _mm256_add_epi32(sum, products);
+        }
+        out[j] = bias[j] + horizontal_sum(sum);
+#elif defined(__SSE4_1__)
+        const __m128i ones = _mm_set1_epi16(1);
+        __m128i sum = _mm_setzero_si128();
+        for (int i = 0; i < in_dims; i += 16) {
+            __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+            __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            __m128i products = _mm_madd_epi16(_mm_maddubs_epi16(in, w), ones);
+            sum = _mm_add_epi32(sum, products);
+        }
+        out[j] = bias[j] + horizontal_sum(sum);
+#else
+        int32_t sum = bias[j];
+        for (int i = 0; i < in_dims; i++) {
+            sum += static_cast<int32_t>(input[i]) * row[i];
+        }
+        out[j] = sum;
+#endif
+    }
+}
+
+// Hidden layer activation: rescale by the weight scale, then clip
+void clip_hidden(const int32_t* in, uint8_t* out, int dims) {
+    for (int i = 0; i < dims; i++) {
+        out[i] = static_cast<uint8_t>(std::clamp(in[i] >> WEIGHT_SHIFT, 0, ACTIVATION_MAX));
+    }
+}
+
+template <typename T>
+bool read_array(std::ifstream& in, std::vector<T>& data, size_t count) {
+    data.resize(count);
+    in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(count * sizeof(T)));
+    return static_cast<bool>(in);
+}
+
+template <typename T>
+void write_array(std::ofstream& out, const std::vector<T>& data) {
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(T)));
+}
+
+} // namespace
+
+Network::Network()
+    : loaded_(false), output_scale_(100),
+      ft_weights_(static_cast<size_t>(INPUTS) * HIDDEN, 0), ft_bias_(HIDDEN, 0),
+      l1_weights_(static_cast<size_t>(L1) * 2 * HIDDEN, 0), l1_bias_(L1, 0),
+      l2_weights_(static_cast<size_t>(L2) * L1, 0), l2_bias_(L2, 0),
+      out_weights_(L2, 0), out_bias_(0) {}
+
+bool Network::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    char magic[4];
+    uint32_t header[5];
+    int32_t output_scale;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    in.read(reinterpret_cast<char*>(&output_scale), sizeof(output_scale));
+    if (!in || std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0) return false;
+    if (header[0] != FILE_VERSION || header[1] != INPUTS || header[2] != HIDDEN ||
+        header[3] != L1 || header[4] != L2) {
+        return false;
+    }
+
+    Network net;
+    int32_t out_bias;
+    bool ok = read_array(in, net.ft_weights_, static_cast<size_t>(INPUTS) * HIDDEN) &&
+              read_array(in, net.ft_bias_, HIDDEN) &&
+              read_array(in, net.l1_weights_, static_cast<size_t>(L1) * 2 * HIDDEN) &&
+              read_array(in, net.l1_bias_, L1) &&
+              read_array(in, net.l2_weights_, static_cast<size_t>(L2) * L1) &&
+              read_array(in, net.l2_bias_, L2) &&
+              read_array(in, net.out_weights_, L2);
+    in.read(reinterpret_cast<char*>(&out_bias), sizeof(out_bias));
+    if (!ok || !in) return false;
+
+    *this = std::move(net);
+    output_scale_ = output_scale;
+    out_bias_ = out_bias;
+    loaded_ = true;
+    return true;
+}
+
+bool Network::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+
+    uint32_t header[5] = {FILE_VERSION, INPUTS, HIDDEN, L1, L2};
+    out.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(&output_scale_), sizeof(output_scale_));
+    write_array(out, ft_weights_);
+    write_array(out, ft_bias_);
+    write_array(out, l1_weights_);
+    write_array(out, l1_bias_);
+    write_array(out, l2_weights_);
+    write_array(out, l2_bias_);
+    write_array(out, out_weights_);
+    out.write(reinterpret_cast<const char*>(&out_bias_), sizeof(out_bias_));
+    return static_cast<bool>(out);
+}
+
+int Network::feature_index(Color perspective, PieceType piece, Color color, Square sq) {
+    // Each perspective sees its own pieces first and the board from its own side
+    int side = (color == perspective) ? 0 : 1;
+    int oriented = (perspective == Color::WHITE) ? sq : (sq ^ 56);
+    return (side * 6 + static_cast<int>(piece) - 1) * 64 + oriented;
+}
+
+void Network::refresh(Accumulator& acc, const Board& board) const {
+    for (int p = 0; p < 2; p++) {
+        std::copy(ft_bias_.begin(), ft_bias_.end(), acc.values[p].begin());
+    }
+
+    Bitboard occupied = board.all_pieces();
+    while (occupied) {
+        Square sq = __builtin_ctzll(occupied);
+        occupied &= occupied - 1;
+        PieceType piece = board.piece_on(sq);
+        Color color = board.color_on(sq);
+        for (Color p : {Color::WHITE, Color::BLACK}) {
+            int idx = feature_index(p, piece, color, sq);
+            add_column(acc.values[static_cast<int>(p)].data(), &ft_weights_[static_cast<size_t>(idx) * HIDDEN]);
+        }
+    }
+}
+
+void Network::update(Accumulator& acc, const DirtyPieces& dirty) const {
+    for (int i = 0; i < dirty.count; i++) {
+        const DirtyPieces::Entry& e = dirty.entries[i];
+        for (Color p : {Color::WHITE, Color::BLACK}) {
+            int idx = feature_index(p, e.piece, e.color, e.sq);
+            const int16_t* column = &ft_weights_[static_cast<size_t>(idx) * HIDDEN];
+            int16_t* values = acc.values[static_cast<int>(p)].data();
+            if (e.added) {
+                add_column(values, column);
+            } else {
+                sub_column(values, column);
+            }
+        }
+    }
+}
+
+int Network::evaluate(const Accumulator& acc, Color stm) const {
+    alignas(64) uint8_t input[2 * HIDDEN];
+    alignas(64) int32_t l1_out[L1];
+    alignas(64) uint8_t l1_act[L1];
+    alignas(64) int32_t l2_out[L2];
+    alignas(64) uint8_t l2_act[L2];
+
+    clip_accumulator(acc.values[0].data(), input);
+    clip_accumulator(acc.values[1].data(), input + HIDDEN);
+
+    affine(input, 2 * HIDDEN, l1_weights_.data(), l1_bias_.data(), l1_out, L1);
+    clip_hidden(l1_out, l1_act, L1);
+    affine(l1_act, L1, l2_weights_.data(), l2_bias_.data(), l2_out, L2);
+    clip_hidden(l2_out, l2_act, L2);
+
+    int32_t out = out_bias_;
+    for (int i = 0; i < L2; i++) {
+        out += static_cast<int32_t>(l2_act[i]) * out_weights_[i];
+    }
+
+    int score = static_cast<int>(static_cast<int64_t>(out) * output_scale_ / (ACTIVATION_MAX * WEIGHT_SCALE));
+    return (stm == Color::WHITE) ? score : -score;
+}
+
+} // namespace nnue
+} // namespace fianchetto
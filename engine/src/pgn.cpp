@@ -0,0 +1,378 @@
+#include "pgn.hpp"
+#include "movegen.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <thread>
+
+namespace fianchetto {
+namespace pgn {
+
+namespace {
+
+const char* STARTPOS = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+bool is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+bool at_line_start(std::string_view text, size_t pos) { return pos == 0 || text[pos - 1] == '\n'; }
+
+// Position just past the end of the line containing `pos`
+size_t line_end(std::string_view text, size_t pos) {
+    size_t newline = text.find('\n', pos);
+    return newline == std::string_view::npos ? text.size() : newline + 1;
+}
+
+PieceType piece_of_letter(char c) {
+    switch (c) {
+        case 'N': return PieceType::KNIGHT;
+        case 'B': return PieceType::BISHOP;
+        case 'R': return PieceType::ROOK;
+        case 'Q': return PieceType::QUEEN;
+        case 'K': return PieceType::KING;
+        default: return PieceType::NONE;
+    }
+}
+
+// [Name "Value"]
+void parse_tag(std::string_view line, Game& game) {
+    size_t name_start = 1;
+    size_t name_end = line.find_first_of(" \t\"]", name_start);
+    size_t quote = line.find('"', name_start);
+    if (name_end == std::string_view::npos || quote == std::string_view::npos) return;
+
+    std::string value;
+    for (size_t i = quote + 1; i < line.size() && line[i] != '"'; i++) {
+        if (line[i] == '\\' && i + 1 < line.size()) i++;
+        value += line[i];
+    }
+    game.tags.emplace_back(std::string(line.substr(name_start, name_end - name_start)), std::move(value));
+}
+
+// Skip a parenthesised variation starting at `pos`, nested ones and comments included
+size_t skip_variation(std::string_view text, size_t pos) {
+    int depth = 0;
+    while (pos < text.size()) {
+        char c = text[pos];
+        if (c == '{') {
+            size_t end = text.find('}', pos);
+            pos = end == std::string_view::npos ? text.size() : end + 1;
+        } else if (c == ';') {
+            pos = line_end(text, pos);
+        } else {
+            pos++;
+            if (c == '(') depth++;
+            if (c == ')' && --depth == 0) break;
+        }
+    }
+    return pos;
+}
+
+// Parse the game at the start of `text` and consume it
+bool parse_game(std::string_view& text, Board& board, Game& game) {
+    game.tags.clear();
+    game.moves.clear();
+    game.fen = STARTPOS;
+    game.result = RESULT_UNKNOWN;
+    game.complete = true;
+
+    size_t pos = 0;
+    size_t n = text.size();
+    while (pos < n && is_space(text[pos])) pos++;
+    if (pos >= n) {
+        text = {};
+        return false;
+    }
+
+    while (pos < n && text[pos] == '[') {
+        size_t end = line_end(text, pos);
+        parse_tag(text.substr(pos, end - pos), game);
+        pos = end;
+        while (pos < n && is_space(text[pos])) pos++;
+    }
+    std::string_view fen = game.tag("FEN");
+    if (!fen.empty()) game.fen = fen;
+    if (board.parse_fen(game.fen) != FenError::NONE) game.complete = false;
+
+    bool terminated = false;
+    while (pos < n && !terminated) {
+        char c = text[pos];
+        if (is_space(c) || c == ')') {
+            pos++;
+        } else if (c == '[' && at_line_start(text, pos)) {
+            break; // Next game, no result token
+        } else if (c == '{') {
+            size_t end = text.find('}', pos);
+            pos = end == std::string_view::npos ? n : end + 1;
+        } else if (c == ';' || (c == '%' && at_line_start(text, pos))) {
+            pos = line_end(text, pos);
+        } else if (c == '(') {
+            pos = skip_variation(text, pos);
+        } else if (c == '$') {
+            pos++;
+            while (pos < n && is_digit(text[pos])) pos++;
+        } else {
+            size_t start = pos;
+            while (pos < n && !is_space(text[pos]) && !std::strchr("{}();[$", text[pos])) pos++;
+            if (pos == start) {
+                pos++;
+                continue;
+            }
+            std::string_view token = text.substr(start, pos - start);
+
+            if (token == "1-0") game.result = 1;
+            else if (token == "0-1") game.result = -1;
+            else if (token == "1/2-1/2") game.result = 0;
+            if (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*") {
+                terminated = true;
+                continue;
+            }
+
+            // Move number: "12." or "12..." (possibly glued to the move)
+            size_t digits = 0;
+            while (digits < token.size() && is_digit(token[digits])) digits++;
+            size_t dots = digits;
+            while (dots < token.size() && token[dots] == '.') dots++;
+            if (dots > digits || digits == token.size()) token.remove_prefix(dots);
+            if (token.empty() || !game.complete) continue;
+
+            Move move = parse_san(board, token);
+            if (move == Move()) {
+                game.complete = false;
+                continue;
+            }
+            game.moves.push_back(move);
+            board.make_move(move);
+        }
+    }
+
+    if (!terminated) {
+        std::string_view result = game.tag("Result");
+        if (result == "1-0") game.result = 1;
+        else if (result == "0-1") game.result = -1;
+        else if (result == "1/2-1/2") game.result = 0;
+    }
+    text.remove_prefix(pos);
+    return true;
+}
+
+// Start of the first game beginning at or after `pos`: a tag line whose
+// previous non-blank line is not a tag
+size_t game_start_after(std::string_view text, size_t pos) {
+    size_t line = at_line_start(text, pos) ? pos : line_end(text, pos);
+
+    size_t back = line;
+    while (back > 0 && is_space(text[back - 1])) back--;
+    bool previous_tag = false;
+    if (back > 0) {
+        size_t newline = text.rfind('\n', back - 1);
+        previous_tag = text[newline == std::string_view::npos ? 0 : newline + 1] == '[';
+    }
+
+    while (line < text.size()) {
+        size_t next = line_end(text, line);
+        size_t first = line;
+        while (first < next && is_space(text[first])) first++;
+        if (first < next) {
+            bool tag = text[line] == '[';
+            if (tag && !previous_tag) return line;
+            previous_tag = tag;
+        }
+        line = next;
+    }
+    return text.size();
+}
+
+} // namespace
+
+Move parse_san(const Board& board, std::string_view san) {
+    while (!san.empty() && std::strchr("+#!?", san.back())) san.remove_suffix(1);
+    if (san.size() < 2) return Move();
+
+    // Pseudo-legal moves: only the few that match the SAN need the legality test
+    std::vector<Move> moves = movegen::generate_moves(board);
+
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+        uint16_t flag = san.size() == 3 ? MOVE_FLAG_CASTLE_KINGSIDE : MOVE_FLAG_CASTLE_QUEENSIDE;
+        for (Move m : moves) {
+            if ((m.flags() & flag) && board.is_legal_move(m)) return m;
+        }
+        return Move();
+    }
+
+    PieceType piece = piece_of_letter(san[0]);
+    if (piece != PieceType::NONE) san.remove_prefix(1);
+    else piece = PieceType::PAWN;
+
+    // Promotion: "e8=Q", "e8Q" (either case)
+    PieceType promotion = PieceType::NONE;
+    if (piece == PieceType::PAWN && san.size() >= 3) {
+        PieceType promoted = piece_of_letter(static_cast<char>(std::toupper(san.back())));
+        if (promoted != PieceType::NONE && promoted != PieceType::KING) {
+            promotion = promoted;
+            san.remove_suffix(1);
+            if (san.back() == '=') san.remove_suffix(1);
+        }
+    }
+
+    if (san.size() < 2) return Move();
+    char file = san[san.size() - 2];
+    char rank = san[san.size() - 1];
+    if (file < 'a' || file > 'h' || rank < '1' || rank > '8') return Move();
+    Square to = square(file - 'a', rank - '1');
+    san.remove_suffix(2);
+
+    // Disambiguation and capture marks
+    int from_file = -1;
+    int from_rank = -1;
+    for (char c : san) {
+        if (c >= 'a' && c <= 'h') from_file = c - 'a';
+        else if (c >= '1' && c <= '8') from_rank = c - '1';
+        else if (c != 'x' && c != ':' && c != '-') return Move();
+    }
+
+    Move found;
+    for (Move m : moves) {
+        if (m.piece() != piece || m.to() != to || m.promotion() != promotion || m.is_castling()) continue;
+        if (from_file >= 0 && file_of(m.from()) != from_file) continue;
+        if (from_rank >= 0 && rank_of(m.from()) != from_rank) continue;
+        if (!board.is_legal_move(m)) continue;
+        if (found != Move()) return Move(); // Ambiguous
+        found = m;
+    }
+    return found;
+}
+
+std::string move_to_san(Board& board, Move move) {
+    static const char LETTERS[] = " PNBRQK";
+    std::string san;
+
+    if (move.is_castling()) {
+        san = (move.flags() & MOVE_FLAG_CASTLE_KINGSIDE) ? "O-O" : "O-O-O";
+    } else {
+        if (move.piece() == PieceType::PAWN) {
+            if (move.is_capture()) san += static_cast<char>('a' + file_of(move.from()));
+        } else {
+            san += LETTERS[static_cast<int>(move.piece())];
+
+            // Disambiguate from other pieces of the same type reaching the square
+            bool clash = false, same_file = false, same_rank = false;
+            for (Move m : movegen::generate_legal_moves(board)) {
+                if (m.piece() != move.piece() || m.to() != move.to() || m.from() == move.from()) continue;
+                clash = true;
+                same_file |= file_of(m.from()) == file_of(move.from());
+                same_rank |= rank_of(m.from()) == rank_of(move.from());
+            }
+            if (clash && (!same_file || same_rank)) san += static_cast<char>('a' + file_of(move.from()));
+            if (clash && same_file) san += static_cast<char>('1' + rank_of(move.from()));
+        }
+        if (move.is_capture()) san += 'x';
+        san += static_cast<char>('a' + file_of(move.to()));
+        san += static_cast<char>('1' + rank_of(move.to()));
+        if (move.is_promotion()) {
+            san += '=';
+            san += LETTERS[static_cast<int>(move.promotion())];
+        }
+    }
+
+    board.make_move(move);
+    if (board.in_check(board.side_to_move())) {
+        san += movegen::generate_legal_moves(board).empty() ? '#' : '+';
+    }
+    board.unmake_move(move);
+    return san;
+}
+
+std::string_view Game::tag(std::string_view name) const {
+    for (const auto& [key, value] : tags) {
+        if (key == name) return value;
+    }
+    return {};
+}
+
+Reader::Reader(std::string_view text) : text_(text), in_(nullptr) {}
+
+Reader::Reader(std::istream& in) : in_(&in) {}
+
+// Buffer the next game: lines up to the first tag line after movetext
+bool Reader::fill_from_stream() {
+    buffer_.clear();
+    if (!pending_.empty()) {
+        buffer_ = pending_ + '\n';
+        pending_.clear();
+    }
+
+    bool movetext = false;
+    std::string line;
+    while (std::getline(*in_, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos) {
+            buffer_ += '\n';
+            continue;
+        }
+        if (line[first] == '[' && first == 0) {
+            if (movetext) {
+                pending_ = std::move(line);
+                break;
+            }
+        } else {
+            movetext = true;
+        }
+        buffer_ += line;
+        buffer_ += '\n';
+    }
+    return !buffer_.empty();
+}
+
+bool Reader::next(Game& game) {
+    if (!in_) return parse_game(text_, board_, game);
+
+    while (fill_from_stream()) {
+        std::string_view text(buffer_);
+        if (parse_game(text, board_, game)) return true;
+    }
+    return false;
+}
+
+size_t parse_parallel(std::string_view text, int threads,
+                      const std::function<void(const Game&, int)>& visit) {
+    if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    std::vector<size_t> bounds{0};
+    for (int i = 1; i < threads; i++) {
+        size_t start = game_start_after(text, text.size() / threads * i);
+        if (start > bounds.back() && start < text.size()) bounds.push_back(start);
+    }
+    bounds.push_back(text.size());
+
+    std::atomic<size_t> games{0};
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i + 1 < bounds.size(); i++) {
+        workers.emplace_back([&, i] {
+            Reader reader(text.substr(bounds[i], bounds[i + 1] - bounds[i]));
+            Game game;
+            size_t count = 0;
+            while (reader.next(game)) {
+                visit(game, static_cast<int>(i));
+                count++;
+            }
+            games.fetch_add(count, std::memory_order_relaxed);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    return games.load();
+}
+
+void replay(const Game& game, const std::function<void(const Board&, Move)>& visit) {
+    Board board;
+    if (board.parse_fen(game.fen) != FenError::NONE) return;
+    for (Move move : game.moves) {
+        visit(board, move);
+        board.make_move(move);
+    }
+    visit(board, Move());
+}
+
+} // namespace pgn
+} // namespace fianchetto
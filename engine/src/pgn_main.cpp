@@ -0,0 +1,180 @@
+#include "pgn.hpp"
+#include "platform.hpp"
+#include "training_data.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// PGN conversion: decodes every game of a PGN file (in parallel, split at
+// game boundaries, when the input is a file) and writes each position
+// either as a FEN line, e.g. to label with fianchetto_analyse, or as a
+// PackedPosition carrying the game result (score 0).
+
+namespace {
+
+using namespace fianchetto;
+
+void usage() {
+    std::cerr << "Usage: fianchetto_pgn [--input PATH] --output PATH [--format fen|packed]\n"
+                 "                      [--threads N] [--min-ply N]\n";
+}
+
+struct Options {
+    bool packed = false;
+    int threads = 1;
+    int min_ply = 0; // Positions before this ply (opening book moves) are skipped
+};
+
+// FEN lines collected per thread and written in large blocks
+class FenOutput {
+public:
+    explicit FenOutput(std::ostream& out) : out_(out) {}
+
+    void write(std::string& block) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out_ << block;
+        block.clear();
+    }
+
+private:
+    std::mutex mutex_;
+    std::ostream& out_;
+};
+
+struct ThreadOutput {
+    std::string fens;
+    std::unique_ptr<TrainingWriter::Buffer> packed;
+};
+
+struct Totals {
+    std::atomic<uint64_t> positions{0};
+    std::atomic<uint64_t> incomplete{0};
+};
+
+void convert(const pgn::Game& game, const Options& options, ThreadOutput& output, FenOutput* fens,
+             Totals& totals) {
+    if (!game.complete) totals.incomplete.fetch_add(1, std::memory_order_relaxed);
+    if (options.packed && game.result == pgn::RESULT_UNKNOWN) return;
+
+    int ply = 0;
+    uint64_t positions = 0;
+    pgn::replay(game, [&](const Board& board, Move) {
+        if (ply++ < options.min_ply) return;
+        positions++;
+        if (options.packed) {
+            output.packed->add(pack_position(board, 0, game.result));
+        } else {
+            char fen[FEN_BUFFER_SIZE];
+            size_t length = board.write_fen(fen, sizeof(fen));
+            fen[length] = '\n';
+            output.fens.append(fen, length + 1);
+        }
+    });
+    totals.positions.fetch_add(positions, std::memory_order_relaxed);
+
+    if (fens && output.fens.size() >= (1 << 20)) fens->write(output.fens);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::ios::sync_with_stdio(false);
+
+    Options options;
+    options.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::string input_path;
+    std::string output_path;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--input") input_path = value;
+        else if (arg == "--output") output_path = value;
+        else if (arg == "--format" && (value == "fen" || value == "packed")) options.packed = value == "packed";
+        else if (arg == "--threads") options.threads = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--min-ply") options.min_ply = std::max(0, std::atoi(value.c_str()));
+        else {
+            usage();
+            return 1;
+        }
+    }
+    if (output_path.empty() || (options.packed && output_path == "-")) {
+        usage();
+        return 1;
+    }
+
+    // Output: a FEN stream or a packed record file
+    std::ofstream fen_file;
+    std::unique_ptr<FenOutput> fens;
+    std::unique_ptr<TrainingWriter> writer;
+    if (options.packed) {
+        writer = std::make_unique<TrainingWriter>(output_path);
+        if (!writer->is_open()) {
+            std::cerr << "Cannot open " << output_path << std::endl;
+            return 1;
+        }
+    } else {
+        if (output_path != "-") {
+            fen_file.open(output_path);
+            if (!fen_file) {
+                std::cerr << "Cannot open " << output_path << std::endl;
+                return 1;
+            }
+        }
+        fens = std::make_unique<FenOutput>(fen_file.is_open() ? fen_file : std::cout);
+    }
+
+    std::vector<ThreadOutput> outputs(options.threads);
+    for (auto& output : outputs) {
+        if (writer) output.packed = std::make_unique<TrainingWriter::Buffer>(*writer);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Totals totals;
+    size_t games = 0;
+    platform::MappedFile file;
+    if (!input_path.empty() && input_path != "-") {
+        if (!file.open(input_path)) {
+            std::cerr << "Cannot open " << input_path << std::endl;
+            return 1;
+        }
+        games = pgn::parse_parallel(file.text(), options.threads, [&](const pgn::Game& game, int thread) {
+            convert(game, options, outputs[thread], fens.get(), totals);
+        });
+    } else {
+        pgn::Reader reader(std::cin);
+        pgn::Game game;
+        while (reader.next(game)) {
+            convert(game, options, outputs[0], fens.get(), totals);
+            games++;
+        }
+    }
+
+    for (auto& output : outputs) {
+        if (output.packed) output.packed->flush();
+        if (fens && !output.fens.empty()) fens->write(output.fens);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << games << " games (" << totals.incomplete.load() << " with unreadable moves), "
+              << totals.positions.load() << " positions, "
+              << static_cast<uint64_t>(games / std::max(seconds, 1e-3)) << " games/s" << std::endl;
+
+    if (writer && !writer->ok()) {
+        std::cerr << "Write to " << output_path << " failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
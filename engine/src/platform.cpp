@@ -0,0 +1,188 @@
+#include "platform.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fianchetto::platform {
+
+namespace {
+
+constexpr size_t PARALLEL_CLEAR_MIN = 64 * 1024 * 1024;
+
+// "0-3,8-11" -> {0, 1, 2, 3, 8, 9, 10, 11}
+std::vector<int> parse_cpulist(const std::string& list) {
+    std::vector<int> cpus;
+    std::istringstream iss(list);
+    std::string range;
+    while (std::getline(iss, range, ',')) {
+        if (range.empty()) continue;
+        size_t dash = range.find('-');
+        int first = std::atoi(range.c_str());
+        int last = dash == std::string::npos ? first : std::atoi(range.c_str() + dash + 1);
+        for (int cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+std::vector<std::vector<int>> detect_nodes() {
+    std::vector<std::vector<int>> nodes;
+    for (int node = 0;; node++) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file) break;
+        std::string list;
+        std::getline(file, list);
+        std::vector<int> cpus = parse_cpulist(list);
+        if (!cpus.empty()) nodes.push_back(std::move(cpus));
+    }
+    if (nodes.empty()) {
+        std::vector<int> all;
+        for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); cpu++) all.push_back(cpu);
+        nodes.push_back(std::move(all));
+    }
+    return nodes;
+}
+
+} // namespace
+
+LargeBuffer::LargeBuffer(size_t bytes) {
+    if (bytes == 0) return;
+
+    if (bytes >= HUGE_PAGE_SIZE) {
+        size_t rounded = (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        void* p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            data_ = mapping_ = p;
+            size_ = bytes;
+            mapping_size_ = rounded;
+            pages_ = PageKind::HUGETLB;
+            return;
+        }
+
+        // Over-allocate so the usable part starts on a 2 MB boundary
+        size_t length = rounded + HUGE_PAGE_SIZE;
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+        auto base = reinterpret_cast<uintptr_t>(p);
+        auto aligned = (base + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        mapping_ = p;
+        mapping_size_ = length;
+        data_ = reinterpret_cast<void*>(aligned);
+        size_ = bytes;
+#ifdef MADV_HUGEPAGE
+        if (madvise(data_, rounded, MADV_HUGEPAGE) == 0) pages_ = PageKind::TRANSPARENT;
+#endif
+        return;
+    }
+
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) throw std::bad_alloc();
+    data_ = mapping_ = p;
+    size_ = mapping_size_ = bytes;
+}
+
+LargeBuffer::~LargeBuffer() {
+    if (mapping_) munmap(mapping_, mapping_size_);
+}
+
+LargeBuffer::LargeBuffer(LargeBuffer&& other) noexcept
+    : data_(other.data_), size_(other.size_), mapping_(other.mapping_),
+      mapping_size_(other.mapping_size_), pages_(other.pages_) {
+    other.data_ = other.mapping_ = nullptr;
+    other.size_ = other.mapping_size_ = 0;
+}
+
+LargeBuffer& LargeBuffer::operator=(LargeBuffer&& other) noexcept {
+    if (this != &other) {
+        if (mapping_) munmap(mapping_, mapping_size_);
+        data_ = other.data_;
+        size_ = other.size_;
+        mapping_ = other.mapping_;
+        mapping_size_ = other.mapping_size_;
+        pages_ = other.pages_;
+        other.data_ = other.mapping_ = nullptr;
+        other.size_ = other.mapping_size_ = 0;
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    if (data_) munmap(data_, size_);
+}
+
+bool MappedFile::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* data = nullptr;
+    if (size > 0) {
+        data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        madvise(data, size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    if (data_) munmap(data_, size_);
+    data_ = data;
+    size_ = size;
+    return true;
+}
+
+void parallel_clear(void* data, size_t bytes, int threads) {
+    if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    if (bytes < PARALLEL_CLEAR_MIN || threads == 1) {
+        std::memset(data, 0, bytes);
+        return;
+    }
+
+    // Whole huge pages per thread, so no page is touched from two nodes
+    size_t chunk = (bytes / threads + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads && static_cast<size_t>(i) * chunk < bytes; i++) {
+        workers.emplace_back([=] {
+            if (numa_nodes().size() > 1) pin_current_thread(i);
+            size_t begin = static_cast<size_t>(i) * chunk;
+            std::memset(static_cast<char*>(data) + begin, 0, std::min(chunk, bytes - begin));
+        });
+    }
+    for (auto& worker : workers) worker.join();
+}
+
+const std::vector<std::vector<int>>& numa_nodes() {
+    static const std::vector<std::vector<int>> nodes = detect_nodes();
+    return nodes;
+}
+
+bool pin_current_thread(int index) {
+    const auto& nodes = numa_nodes();
+    const auto& cpus = nodes[static_cast<size_t>(index) % nodes.size()];
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+} // namespace fianchetto::platform
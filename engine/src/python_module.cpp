@@ -0,0 +1,317 @@
+#include "board.hpp"
+#include "movegen.hpp"
+#include "pgn.hpp"
+#include "search.hpp"
+#include "transposition_table.hpp"
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Python bindings (module fianchetto_native): the board, legal moves, SAN,
+// search_root with the GIL released, and plane/feature encoding written
+// straight into numpy buffers, so the neural and explain services can run
+// their per-position loops natively instead of through python-chess.
+//
+// Squares are numbered a1 = 0 .. h8 = 63 and colors are booleans (True =
+// white), as in python-chess; moves are UCI strings.
+
+namespace py = pybind11;
+
+namespace {
+
+using namespace fianchetto;
+
+const char* STARTPOS = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+constexpr size_t PLANE_FLOATS = 12 * 64;
+
+// Board plus the moves pushed from Python, which unmake needs back
+struct PyBoard {
+    Board board;
+    std::vector<Move> stack;
+};
+
+void load_fen(Board& board, const std::string& fen) {
+    FenError error = board.parse_fen(fen);
+    if (error != FenError::NONE) throw py::value_error(std::string("invalid FEN: ") + fen_error_string(error));
+}
+
+Move legal_move(Board& board, const std::string& uci) {
+    Move move = movegen::parse_move(board, uci);
+    if (move == Move()) throw py::value_error("illegal move: " + uci);
+    return move;
+}
+
+// 12 planes of 8x8, plane = color * 6 + piece type (pawn first), row 0 =
+// rank 8: the layout of neural/src/encode.py. `out` must be zeroed.
+void encode(const Board& board, float* out) {
+    for (int color = 0; color < 2; color++) {
+        for (int type = 1; type <= 6; type++) {
+            float* plane = out + (color * 6 + type - 1) * 64;
+            Bitboard bb = board.pieces(static_cast<PieceType>(type), static_cast<Color>(color));
+            for (; bb; bb &= bb - 1) {
+                int sq = __builtin_ctzll(bb);
+                plane[(7 - rank_of(sq)) * 8 + file_of(sq)] = 1.0f;
+            }
+        }
+    }
+}
+
+// The features of explain/src/features.py, from white's point of view
+py::dict features(Board& board) {
+    static const int VALUES[7] = {0, 100, 320, 330, 500, 900, 20000};
+    const Bitboard CENTER = (1ULL << square(3, 3)) | (1ULL << square(4, 3)) | (1ULL << square(3, 4)) |
+                            (1ULL << square(4, 4));
+
+    int material[2] = {0, 0}, center[2], doubled[2], isolated[2];
+    double king_distance[2];
+    for (int c = 0; c < 2; c++) {
+        Color color = static_cast<Color>(c);
+        for (int type = 1; type <= 6; type++) {
+            material[c] += VALUES[type] * __builtin_popcountll(board.pieces(static_cast<PieceType>(type), color));
+        }
+        center[c] = __builtin_popcountll(board.all_pieces(color) & CENTER);
+
+        Bitboard king = board.pieces(PieceType::KING, color);
+        int sq = king ? __builtin_ctzll(king) : -1;
+        king_distance[c] = sq < 0 ? 10.0 : std::abs(rank_of(sq) - 3.5) + std::abs(file_of(sq) - 3.5);
+
+        int per_file[8] = {};
+        for (Bitboard bb = board.pieces(PieceType::PAWN, color); bb; bb &= bb - 1) {
+            per_file[file_of(__builtin_ctzll(bb))]++;
+        }
+        doubled[c] = isolated[c] = 0;
+        for (int f = 0; f < 8; f++) {
+            doubled[c] += std::max(0, per_file[f] - 1);
+        }
+        for (int f = 0; f < 8; f++) {
+            bool neighbour = (f > 0 && per_file[f - 1]) || (f < 7 && per_file[f + 1]);
+            if (!neighbour) isolated[c] += per_file[f];
+        }
+    }
+
+    py::dict out;
+    out["material_balance"] = material[0] - material[1];
+    out["center_control"] = center[0] - center[1];
+    out["king_safety"] = king_distance[1] - king_distance[0];
+    out["doubled_pawns"] = doubled[1] - doubled[0];
+    out["isolated_pawns"] = isolated[1] - isolated[0];
+    // features.py counts files without pawns of either colour for both
+    // sides, so the difference is always 0; kept for the same keys
+    out["open_files"] = 0;
+    out["activity"] = movegen::generate_legal_moves(board).size();
+    return out;
+}
+
+// trace_evaluation as {classical, nnue, terms, features}, each term a
+// {"white": w, "black": b} dict; scores from white's point of view
+py::dict trace(const Board& board) {
+    EvalTrace trace = trace_evaluation(board);
+    auto sides = [](const std::vector<EvalTerm>& terms) {
+        py::dict out;
+        for (const EvalTerm& term : terms) {
+            py::dict side;
+            side["white"] = term.white;
+            side["black"] = term.black;
+            out[term.name] = side;
+        }
+        return out;
+    };
+    py::dict out;
+    out["classical"] = trace.classical;
+    out["nnue"] = trace.has_nnue ? py::object(py::int_(trace.nnue)) : py::object(py::none());
+    out["terms"] = sides(trace.terms);
+    out["features"] = sides(trace.features);
+    return out;
+}
+
+// (N, 12, 8, 8) float32 planes for a sequence of Boards and/or FEN strings.
+// Boards are copied before the GIL is released, so other Python threads
+// may move on them during encoding.
+py::array_t<float> encode_planes(const py::sequence& positions) {
+    size_t n = py::len(positions);
+    std::vector<Board> boards(n);
+    for (size_t i = 0; i < n; i++) {
+        py::object item = positions[i];
+        if (py::isinstance<PyBoard>(item)) boards[i] = item.cast<const PyBoard&>().board;
+        else load_fen(boards[i], item.cast<std::string>());
+    }
+
+    py::array_t<float> planes(std::vector<py::ssize_t>{static_cast<py::ssize_t>(n), 12, 8, 8});
+    float* out = planes.mutable_data();
+    {
+        py::gil_scoped_release release;
+        std::fill(out, out + n * PLANE_FLOATS, 0.0f);
+        for (size_t i = 0; i < n; i++) encode(boards[i], out + i * PLANE_FLOATS);
+    }
+    return planes;
+}
+
+// search_root on a copy of the board with the GIL released, so Python
+// threads may use the Board meanwhile. `depth` 0 means no
+// depth limit when a node or time budget is given, else depth 8 (as in
+// fianchetto_analyse). Without `tt` a fresh 16 MB table is used for this
+// call; a table passed in is searched as it is, so it stays warm across calls.
+// `lines` holds the `multipv` best root moves (among `searchmoves` if
+// given) with their scores and full variations.
+py::dict search(const PyBoard& position, int depth, uint64_t nodes, int movetime_ms, TranspositionTable* tt,
+                int multipv, const std::vector<std::string>& searchmoves) {
+    Board board = position.board;
+    SearchParams params;
+    params.node_limit = nodes;
+    params.time_limit_ms = std::max(0, movetime_ms);
+    if (depth <= 0) depth = nodes > 0 || movetime_ms > 0 ? MAX_PLY - 1 : 8;
+    params.depth = std::min(depth, MAX_PLY - 1);
+    params.multi_pv = std::max(multipv, 1);
+    for (const std::string& uci : searchmoves) params.search_moves.push_back(legal_move(board, uci));
+
+    py::dict out;
+    if (movegen::generate_legal_moves(board).empty()) {
+        bool mated = board.in_check(board.side_to_move());
+        out["bestmove"] = py::none();
+        out["score"] = mated ? -SCORE_MATE : 0;
+        out["mate"] = mated ? py::object(py::int_(0)) : py::object(py::none());
+        out["depth"] = 0;
+        out["nodes"] = 0;
+        out["pv"] = py::list();
+        out["lines"] = py::list();
+        return out;
+    }
+
+    std::unique_ptr<TranspositionTable> own;
+    if (!tt) {
+        own = std::make_unique<TranspositionTable>(16);
+        tt = own.get();
+    }
+
+    SearchStats stats;
+    Move best;
+    {
+        py::gil_scoped_release release;
+        best = search_root(board, *tt, params, stats);
+    }
+    std::vector<Move> pv = stats.lines.empty() ? std::vector<Move>() : stats.lines.front().pv;
+    if (pv.empty() || pv.front() != best) pv.assign(1, best);
+
+    auto to_strings = [](const std::vector<Move>& moves) {
+        std::vector<std::string> out;
+        for (Move move : moves) out.push_back(move_to_string(move));
+        return out;
+    };
+    py::list lines;
+    for (const PVLine& l : stats.lines) {
+        py::dict entry;
+        entry["score"] = l.score;
+        entry["pv"] = to_strings(l.pv);
+        lines.append(entry);
+    }
+    out["bestmove"] = move_to_string(best);
+    out["score"] = stats.best_score;
+    // Moves to mate, negative when getting mated
+    if (is_mate_score(stats.best_score)) out["mate"] = mate_in_moves(stats.best_score);
+    else out["mate"] = py::none();
+    out["depth"] = stats.depth;
+    out["nodes"] = stats.nodes + stats.qnodes;
+    out["pv"] = to_strings(pv);
+    out["lines"] = lines;
+    return out;
+}
+
+} // namespace
+
+PYBIND11_MODULE(fianchetto_native, m) {
+    m.doc() = "Fianchetto engine: board, move generation, search and plane encoding";
+
+    py::class_<TranspositionTable>(m, "TranspositionTable")
+        .def(py::init<size_t>(), py::arg("hash_mb") = 16)
+        .def("clear", &TranspositionTable::clear);
+
+    py::class_<PyBoard>(m, "Board")
+        .def(py::init([](const std::string& fen) {
+                 PyBoard position;
+                 load_fen(position.board, fen);
+                 return position;
+             }),
+             py::arg("fen") = STARTPOS)
+        .def("fen", [](const PyBoard& b) { return b.board.get_fen(); })
+        .def("set_fen",
+             [](PyBoard& b, const std::string& fen) {
+                 load_fen(b.board, fen);
+                 b.stack.clear();
+             })
+        .def("copy", [](const PyBoard& b) { return b; })
+        .def_property_readonly("turn", [](const PyBoard& b) { return b.board.side_to_move() == Color::WHITE; })
+        .def_property_readonly("zobrist_hash", [](const PyBoard& b) { return b.board.hash(); })
+        .def("piece_at",
+             [](const PyBoard& b, int sq) -> py::object {
+                 if (sq < 0 || sq > 63) throw py::index_error("square out of range");
+                 PieceType piece = b.board.piece_on(static_cast<Square>(sq));
+                 if (piece == PieceType::NONE) return py::none();
+                 bool white = b.board.color_on(static_cast<Square>(sq)) == Color::WHITE;
+                 return py::make_tuple(static_cast<int>(piece), white);
+             },
+             "(piece type 1-6 pawn..king, is white), or None")
+        .def("legal_moves",
+             [](PyBoard& b) {
+                 std::vector<std::string> moves;
+                 for (Move move : movegen::generate_legal_moves(b.board)) moves.push_back(move_to_string(move));
+                 return moves;
+             })
+        .def("push",
+             [](PyBoard& b, const std::string& uci) {
+                 Move move = legal_move(b.board, uci);
+                 b.board.make_move(move);
+                 b.stack.push_back(move);
+             })
+        .def("push_san",
+             [](PyBoard& b, const std::string& san) {
+                 Move move = pgn::parse_san(b.board, san);
+                 if (move == Move()) throw py::value_error("illegal or ambiguous move: " + san);
+                 b.board.make_move(move);
+                 b.stack.push_back(move);
+                 return move_to_string(move);
+             })
+        .def("pop",
+             [](PyBoard& b) {
+                 if (b.stack.empty()) throw py::index_error("pop from empty move stack");
+                 Move move = b.stack.back();
+                 b.stack.pop_back();
+                 b.board.unmake_move(move);
+                 return move_to_string(move);
+             })
+        .def("san", [](PyBoard& b, const std::string& uci) { return pgn::move_to_san(b.board, legal_move(b.board, uci)); })
+        .def("is_check", [](const PyBoard& b) { return b.board.in_check(b.board.side_to_move()); })
+        .def("is_checkmate",
+             [](PyBoard& b) {
+                 return b.board.in_check(b.board.side_to_move()) && movegen::generate_legal_moves(b.board).empty();
+             })
+        .def("is_stalemate",
+             [](PyBoard& b) {
+                 return !b.board.in_check(b.board.side_to_move()) && movegen::generate_legal_moves(b.board).empty();
+             })
+        .def("is_draw", [](const PyBoard& b) { return b.board.is_draw(0); },
+             "Fifty-move rule or threefold repetition")
+        .def("planes",
+             [](const PyBoard& b) {
+                 py::array_t<float> planes(std::vector<py::ssize_t>{12, 8, 8});
+                 std::fill(planes.mutable_data(), planes.mutable_data() + PLANE_FLOATS, 0.0f);
+                 encode(b.board, planes.mutable_data());
+                 return planes;
+             })
+        .def("features", [](PyBoard& b) { return features(b.board); })
+        .def("trace", [](const PyBoard& b) { return trace(b.board); },
+             "Evaluation broken down per term and side (see the UCI eval command)")
+        .def("__repr__", [](const PyBoard& b) { return "Board('" + b.board.get_fen() + "')"; });
+
+    m.def("encode_planes", &encode_planes, py::arg("positions"),
+          "(N, 12, 8, 8) float32 planes for a sequence of Boards and/or FEN strings");
+    m.def("search", &search, py::arg("board"), py::arg("depth") = 0, py::arg("nodes") = 0,
+          py::arg("movetime_ms") = 0, py::arg("tt") = py::none(), py::arg("multipv") = 1,
+          py::arg("searchmoves") = std::vector<std::string>(),
+          "Search with the GIL released; returns bestmove, score, mate, depth, nodes, pv and the multipv lines");
+}
@@ -1,10 +1,9 @@
 #include "search.hpp"
 #include "movegen.hpp"
-#ifdef USE_NEURAL
-#include "neural_client.hpp"
-#endif
+#include "eval_pipeline.hpp"
 #include <algorithm>
 #include <climits>
+#include <cstdlib>
 #include <chrono>
 
 namespace fianchetto {
@@ -79,7 +78,18 @@ static const int KING_PST[64] = {
 // Piece values (centipawns)
 static const int PIECE_VALUES[7] = {0, 100, 320, 330, 500, 900, 20000};
 
-int evaluate(const Board& board) {
+// Per-side terms of the classical evaluation, each from that side's
+// point of view
+struct ClassicalTerms {
+    int material[2] = {0, 0};
+    int pst[2][7] = {};
+    int doubled_pawns[2] = {0, 0};
+};
+
+// Classical score from white's point of view; with TRACE the terms are
+// also recorded per side (kept out of the search's instantiation)
+template <bool TRACE>
+static int classical_eval(const Board& board, ClassicalTerms* terms) {
     int score = 0;
 
     // Material and PST
@@ -112,6 +122,10 @@ int evaluate(const Board& board) {
         } else {
             score -= value + pst;
         }
+        if constexpr (TRACE) {
+            terms->material[static_cast<int>(color)] += value;
+            terms->pst[static_cast<int>(color)][static_cast<int>(piece)] += pst;
+        }
     }
 
     // Pawn structure bonuses
@@ -125,64 +139,152 @@ int evaluate(const Board& board) {
         int black_count = __builtin_popcountll(black_pawns & file_mask);
         if (white_count > 1) score -= 10 * (white_count - 1);
         if (black_count > 1) score += 10 * (black_count - 1);
+        if constexpr (TRACE) {
+            if (white_count > 1) terms->doubled_pawns[0] -= 10 * (white_count - 1);
+            if (black_count > 1) terms->doubled_pawns[1] -= 10 * (black_count - 1);
+        }
     }
 
-    // Return score from white's perspective
-    return (board.side_to_move() == Color::WHITE) ? score : -score;
+    return score;
 }
 
-// TranspositionTable implementation
-TranspositionTable::TranspositionTable(size_t size_mb) {
-    size_ = (size_mb * 1024 * 1024) / sizeof(TTEntry);
-    table_.resize(size_);
-    current_age_ = 0;
+int evaluate(const Board& board) {
+    // In-process NNUE when a network is attached to the board
+    if (const nnue::Network* net = board.network()) {
+        int score = net->evaluate(board.accumulator(), board.side_to_move());
+        return std::clamp(score, -SCORE_MATE + MAX_PLY + 1, SCORE_MATE - MAX_PLY - 1);
+    }
+
+    int score = classical_eval<false>(board, nullptr);
+
+    // Return score from the side to move's perspective
+    return (board.side_to_move() == Color::WHITE) ? score : -score;
 }
 
-void TranspositionTable::store(uint64_t hash, int depth, int score, Move best_move, uint8_t flag) {
-    size_t index = hash % size_;
-    TTEntry& entry = table_[index];
-    
-    // Replace if deeper or same depth with better flag
-    if (entry.hash == 0 || entry.depth <= depth || entry.age != current_age_) {
-        entry.hash = hash;
-        entry.depth = depth;
-        entry.score = score;
-        entry.best_move = best_move;
-        entry.flag = flag;
-        entry.age = current_age_;
+EvalTrace trace_evaluation(const Board& board) {
+    static const char* PST_NAMES[7] = {"", "pst_pawn", "pst_knight", "pst_bishop", "pst_rook", "pst_queen", "pst_king"};
+
+    EvalTrace trace;
+    ClassicalTerms terms;
+    trace.classical = classical_eval<true>(board, &terms);
+    trace.terms.push_back({"material", terms.material[0], terms.material[1]});
+    for (int piece = 1; piece <= 6; piece++) {
+        trace.terms.push_back({PST_NAMES[piece], terms.pst[0][piece], terms.pst[1][piece]});
     }
-}
+    trace.terms.push_back({"doubled_pawns", terms.doubled_pawns[0], terms.doubled_pawns[1]});
 
-TTEntry* TranspositionTable::probe(uint64_t hash) {
-    size_t index = hash % size_;
-    TTEntry& entry = table_[index];
-    if (entry.hash == hash && entry.age == current_age_) {
-        return &entry;
+    trace.has_nnue = board.network() != nullptr;
+    trace.nnue = 0;
+    if (trace.has_nnue) {
+        int score = evaluate(board);
+        trace.nnue = board.side_to_move() == Color::WHITE ? score : -score;
     }
-    return nullptr;
-}
 
-void TranspositionTable::clear() {
-    for (auto& entry : table_) {
-        entry.hash = 0;
+    // Measurements the evaluation does not score, for explanations
+    const Bitboard occupied = board.all_pieces();
+    const Bitboard CENTER = (1ULL << square(3, 3)) | (1ULL << square(4, 3)) | (1ULL << square(3, 4)) |
+                            (1ULL << square(4, 4));
+    Bitboard pawns[2] = {board.pieces(PieceType::PAWN, Color::WHITE), board.pieces(PieceType::PAWN, Color::BLACK)};
+    int mobility[2] = {0, 0}, king_zone_attacks[2] = {0, 0}, pawn_shelter[2] = {0, 0};
+    int isolated[2] = {0, 0}, passed[2] = {0, 0}, semi_open[2] = {0, 0}, center[2] = {0, 0};
+    int open_files = 0;
+
+    // Squares each side attacks, counted per attacking piece
+    auto attacks_of = [&](int c, Square sq, PieceType piece) -> Bitboard {
+        switch (piece) {
+            case PieceType::PAWN: return movegen::pawn_attacks(sq, static_cast<Color>(c));
+            case PieceType::KNIGHT: return movegen::knight_attacks(sq);
+            case PieceType::BISHOP: return movegen::bishop_attacks(sq, occupied);
+            case PieceType::ROOK: return movegen::rook_attacks(sq, occupied);
+            case PieceType::QUEEN: return movegen::queen_attacks(sq, occupied);
+            case PieceType::KING: return movegen::king_attacks(sq);
+            default: return 0;
+        }
+    };
+
+    for (int file = 0; file < 8; file++) {
+        Bitboard file_mask = 0x0101010101010101ULL << file;
+        if (!((pawns[0] | pawns[1]) & file_mask)) open_files++;
     }
-}
 
-void TranspositionTable::age() {
-    current_age_++;
+    for (int c = 0; c < 2; c++) {
+        Color color = static_cast<Color>(c);
+        Bitboard own = board.all_pieces(color);
+        Bitboard king = board.pieces(PieceType::KING, color);
+        Square king_sq = king ? static_cast<Square>(__builtin_ctzll(king)) : 0;
+        Bitboard zone = king ? (movegen::king_attacks(king_sq) | king) : 0;
+
+        for (int piece = 2; piece <= 5; piece++) {
+            for (Bitboard bb = board.pieces(static_cast<PieceType>(piece), color); bb; bb &= bb - 1) {
+                Square sq = static_cast<Square>(__builtin_ctzll(bb));
+                mobility[c] += __builtin_popcountll(attacks_of(c, sq, static_cast<PieceType>(piece)) & ~own);
+            }
+        }
+
+        // Enemy attacks on the king and the squares around it
+        for (int piece = 1; piece <= 6; piece++) {
+            for (Bitboard bb = board.pieces(static_cast<PieceType>(piece), static_cast<Color>(1 - c)); bb;
+                 bb &= bb - 1) {
+                Square sq = static_cast<Square>(__builtin_ctzll(bb));
+                king_zone_attacks[c] += __builtin_popcountll(attacks_of(1 - c, sq, static_cast<PieceType>(piece)) & zone);
+            }
+        }
+
+        // Own pawns on the king's and neighbouring files, one or two ranks ahead
+        if (king) {
+            for (int df = -1; df <= 1; df++) {
+                int file = file_of(king_sq) + df;
+                for (int ahead = 1; ahead <= 2 && file >= 0 && file < 8; ahead++) {
+                    int rank = rank_of(king_sq) + (c == 0 ? ahead : -ahead);
+                    if (rank >= 0 && rank < 8 && (pawns[c] & (1ULL << square(file, rank)))) pawn_shelter[c]++;
+                }
+            }
+        }
+
+        for (int file = 0; file < 8; file++) {
+            Bitboard file_mask = 0x0101010101010101ULL << file;
+            if (!(pawns[c] & file_mask)) semi_open[c]++;
+        }
+
+        for (Bitboard bb = pawns[c]; bb; bb &= bb - 1) {
+            Square sq = static_cast<Square>(__builtin_ctzll(bb));
+            int file = file_of(sq), rank = rank_of(sq);
+            Bitboard adjacent = (file > 0 ? 0x0101010101010101ULL << (file - 1) : 0) |
+                                (file < 7 ? 0x0101010101010101ULL << (file + 1) : 0);
+            if (!(pawns[c] & adjacent)) isolated[c]++;
+
+            // No enemy pawn ahead on this or an adjacent file
+            Bitboard span = adjacent | (0x0101010101010101ULL << file);
+            Bitboard ahead = c == 0 ? (rank < 7 ? ~0ULL << ((rank + 1) * 8) : 0) : ((1ULL << (rank * 8)) - 1);
+            if (!(pawns[1 - c] & span & ahead)) passed[c]++;
+        }
+
+        center[c] = __builtin_popcountll(own & CENTER);
+    }
+
+    trace.features.push_back({"mobility", mobility[0], mobility[1]});
+    trace.features.push_back({"king_zone_attacks", king_zone_attacks[0], king_zone_attacks[1]});
+    trace.features.push_back({"pawn_shelter", pawn_shelter[0], pawn_shelter[1]});
+    trace.features.push_back({"isolated_pawns", isolated[0], isolated[1]});
+    trace.features.push_back({"passed_pawns", passed[0], passed[1]});
+    trace.features.push_back({"semi_open_files", semi_open[0], semi_open[1]});
+    trace.features.push_back({"open_files", open_files, open_files});
+    trace.features.push_back({"center_control", center[0], center[1]});
+    return trace;
 }
 
+// TranspositionTable implementation
 // KillerMoves implementation
-void KillerMoves::add(int depth, Move move) {
-    if (depth < 64 && move != killers_[depth][0]) {
-        killers_[depth][1] = killers_[depth][0];
-        killers_[depth][0] = move;
+void KillerMoves::add(int ply, Move move) {
+    if (ply < MAX_PLY && move != killers_[ply][0]) {
+        killers_[ply][1] = killers_[ply][0];
+        killers_[ply][0] = move;
     }
 }
 
-bool KillerMoves::is_killer(int depth, Move move) const {
-    if (depth >= 64) return false;
-    return move == killers_[depth][0] || move == killers_[depth][1];
+bool KillerMoves::is_killer(int ply, Move move) const {
+    if (ply >= MAX_PLY) return false;
+    return move == killers_[ply][0] || move == killers_[ply][1];
 }
 
 void KillerMoves::clear() {
@@ -192,23 +294,68 @@ void KillerMoves::clear() {
     }
 }
 
+// History gravity: large entries move less, so values saturate at HISTORY_MAX
+// instead of overflowing, and stale entries decay as new bonuses arrive
+static void apply_gravity(int& entry, int bonus) {
+    entry += bonus - entry * std::abs(bonus) / HISTORY_MAX;
+}
+
+static int history_bonus(int depth) {
+    return std::min(32 * depth * depth, 2048);
+}
+
 // HistoryHeuristic implementation
-void HistoryHeuristic::update(Color color, Move move, int depth) {
-    int from = move.from();
-    int to = move.to();
-    history_[from][to] += depth * depth;
+void HistoryHeuristic::update(Color color, Move move, int bonus) {
+    apply_gravity(history_[static_cast<int>(color)][move.from()][move.to()], bonus);
 }
 
 int HistoryHeuristic::get_score(Color color, Move move) const {
-    return history_[move.from()][move.to()];
+    return history_[static_cast<int>(color)][move.from()][move.to()];
 }
 
 void HistoryHeuristic::clear() {
-    for (auto& row : history_) {
-        row.fill(0);
+    for (auto& side : history_) {
+        for (auto& row : side) {
+            row.fill(0);
+        }
     }
 }
 
+// CounterMoves implementation
+void CounterMoves::set(Color color, Move prev, Move move) {
+    counters_[static_cast<int>(color)][static_cast<int>(prev.piece())][prev.to()] = move;
+}
+
+Move CounterMoves::get(Color color, Move prev) const {
+    return counters_[static_cast<int>(color)][static_cast<int>(prev.piece())][prev.to()];
+}
+
+void CounterMoves::clear() {
+    for (auto& side : counters_) {
+        for (auto& row : side) {
+            row.fill(Move());
+        }
+    }
+}
+
+// ContinuationHistory implementation
+ContinuationHistory::ContinuationHistory() : table_(12 * 64 * 12 * 64, 0) {}
+
+void ContinuationHistory::update(Color prev_color, Move prev, Color color, Move move, int bonus) {
+    int16_t& entry = table_[index(prev_color, prev, color, move)];
+    int value = entry;
+    apply_gravity(value, bonus);
+    entry = static_cast<int16_t>(value);
+}
+
+int ContinuationHistory::get_score(Color prev_color, Move prev, Color color, Move move) const {
+    return table_[index(prev_color, prev, color, move)];
+}
+
+void ContinuationHistory::clear() {
+    std::fill(table_.begin(), table_.end(), 0);
+}
+
 // MVV-LVA (Most Valuable Victim - Least Valuable Attacker)
 int mvv_lva_score(Move move) {
     static const int victim_values[] = {0, 100, 320, 330, 500, 900, 20000};
@@ -219,14 +366,97 @@ int mvv_lva_score(Move move) {
     return victim * 10 - attacker;
 }
 
-// Move ordering
-void order_moves(std::vector<Move>& moves, Move hash_move, const KillerMoves& killers, 
-                 const HistoryHeuristic& history, int depth, Color stm) {
+// Mate scores are stored relative to the node so they stay valid at any ply
+static int score_to_tt(int score, int ply) {
+    if (score >= SCORE_MATE - MAX_PLY) return score + ply;
+    if (score <= -SCORE_MATE + MAX_PLY) return score - ply;
+    return score;
+}
+
+static int score_from_tt(int score, int ply) {
+    if (score >= SCORE_MATE - MAX_PLY) return score - ply;
+    if (score <= -SCORE_MATE + MAX_PLY) return score + ply;
+    return score;
+}
+
+static bool has_non_pawn_material(const Board& board, Color color) {
+    return (board.pieces(PieceType::KNIGHT, color) | board.pieces(PieceType::BISHOP, color) |
+            board.pieces(PieceType::ROOK, color) | board.pieces(PieceType::QUEEN, color)) != 0;
+}
+
+// SearchThread implementation
+SearchThread::SearchThread(Board& board, TranspositionTable& tt, const SearchParams& params)
+    : board_(board), tt_(tt), params_(params),
+      pipeline_(params.use_neural ? params.neural_pipeline : nullptr),
+      stats_{}, ply_(0), root_restricted_(false), stopped_(false) {
+    killers_.clear();
+    history_.clear();
+    counter_moves_.clear();
+    move_stack_.fill(Move());
+    pv_length_.fill(0);
+
+    // search_moves naming no legal move leaves the root unrestricted
+    std::vector<Move> legal = movegen::generate_legal_moves(board);
+    for (Move move : legal) {
+        if (std::find(params.search_moves.begin(), params.search_moves.end(), move) != params.search_moves.end()) {
+            root_moves_.push_back(move);
+        }
+    }
+    root_restricted_ = !root_moves_.empty() && root_moves_.size() < legal.size();
+    if (!root_restricted_) root_moves_ = std::move(legal);
+    start_time_ = std::chrono::steady_clock::now();
+    deadline_ = params.time_limit_ms > 0
+                    ? start_time_ + std::chrono::milliseconds(params.time_limit_ms)
+                    : std::chrono::steady_clock::time_point::max();
+    node_limit_ = params.node_limit;
+}
+
+// Neural score if the pipeline has already delivered one for this position,
+// otherwise the static evaluation; never waits for the service
+int SearchThread::evaluate_leaf() {
+    int score;
+    if (pipeline_ && pipeline_->probe(board_, score)) {
+        if (board_.side_to_move() == Color::BLACK) score = -score;
+        return std::clamp(score, -SCORE_MATE + MAX_PLY + 1, SCORE_MATE - MAX_PLY - 1);
+    }
+    return evaluate(board_);
+}
+
+void SearchThread::check_time() {
+    if ((node_limit_ && stats_.nodes + stats_.qnodes >= node_limit_) ||
+        (params_.stop && params_.stop->load(std::memory_order_relaxed))) {
+        stopped_ = true;
+        return;
+    }
+    if (deadline_ != std::chrono::steady_clock::time_point::max() &&
+        std::chrono::steady_clock::now() >= deadline_) {
+        stopped_ = true;
+    }
+}
+
+// Called once per node, quiescence nodes included (they are most of the
+// tree): the node budget is checked exactly, the clock every 1024 nodes
+bool SearchThread::should_stop() {
+    uint64_t searched = stats_.nodes + stats_.qnodes;
+    if ((node_limit_ && searched >= node_limit_) || (searched & 1023) == 0) check_time();
+    return stopped_;
+}
+
+// Move ordering: hash move, captures (MVV-LVA), killers, counter move, then
+// quiets by butterfly + continuation history
+void SearchThread::order_moves(std::vector<Move>& moves, Move hash_move) {
+    Color stm = board_.side_to_move();
+    Color them = stm == Color::WHITE ? Color::BLACK : Color::WHITE;
+    Move prev1 = ply_ >= 1 ? move_stack_[ply_ - 1] : Move();
+    Move prev2 = ply_ >= 2 ? move_stack_[ply_ - 2] : Move();
+    Move counter = prev1 != Move() ? counter_moves_.get(stm, prev1) : Move();
+
     std::vector<std::pair<int, Move>> scored;
-    
+    scored.reserve(moves.size());
+
     for (Move move : moves) {
         int score = 0;
-        
+
         // Hash move first
         if (move == hash_move) {
             score = 1000000;
@@ -236,50 +466,83 @@ void order_moves(std::vector<Move>& moves, Move hash_move, const KillerMoves& ki
             score = 100000 + mvv_lva_score(move);
         }
         // Killer moves
-        else if (killers.is_killer(depth, move)) {
-            score = 50000;
+        else if (killers_.is_killer(ply_, move)) {
+            score = 90000;
+        }
+        // Counter move
+        else if (move == counter) {
+            score = 80000;
         }
-        // History heuristic
+        // History heuristics, each bounded by HISTORY_MAX
         else {
-            score = history.get_score(stm, move);
+            score = history_.get_score(stm, move);
+            if (prev1 != Move()) score += counter_history_.get_score(them, prev1, stm, move);
+            if (prev2 != Move()) score += followup_history_.get_score(stm, prev2, stm, move);
         }
-        
+
         scored.push_back({score, move});
     }
-    
+
     // Sort by score (descending)
-    std::sort(scored.begin(), scored.end(), 
-              [](const auto& a, const auto& b) { return a.first > b.first; });
-    
-    moves.clear();
-    for (const auto& p : scored) {
-        moves.push_back(p.second);
+    std::stable_sort(scored.begin(), scored.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    for (size_t i = 0; i < scored.size(); i++) {
+        moves[i] = scored[i].second;
     }
 }
 
-int quiescence(Board& board, int alpha, int beta, SearchStats& stats) {
-    stats.qnodes++;
-    
-    int stand_pat = evaluate(board);
+// Reward the quiet move that caused a cutoff and penalize the quiets searched before it
+void SearchThread::update_quiet_stats(Move best, const Move* quiets, int quiet_count, int depth) {
+    Color stm = board_.side_to_move();
+    Color them = stm == Color::WHITE ? Color::BLACK : Color::WHITE;
+    Move prev1 = ply_ >= 1 ? move_stack_[ply_ - 1] : Move();
+    Move prev2 = ply_ >= 2 ? move_stack_[ply_ - 2] : Move();
+    int bonus = history_bonus(depth);
+
+    auto update = [&](Move move, int value) {
+        history_.update(stm, move, value);
+        if (prev1 != Move()) counter_history_.update(them, prev1, stm, move, value);
+        if (prev2 != Move()) followup_history_.update(stm, prev2, stm, move, value);
+    };
+
+    if (!best.is_capture()) {
+        killers_.add(ply_, best);
+        if (prev1 != Move()) counter_moves_.set(stm, prev1, best);
+        update(best, bonus);
+    }
+    for (int i = 0; i < quiet_count; i++) {
+        update(quiets[i], -bonus);
+    }
+}
+
+int SearchThread::quiescence(int alpha, int beta) {
+    stats_.qnodes++;
+    if (should_stop()) return 0;
+
+    int stand_pat = evaluate_leaf();
     if (stand_pat >= beta) return beta;
     if (stand_pat > alpha) alpha = stand_pat;
 
-    std::vector<Move> captures = movegen::generate_moves(board);
+    std::vector<Move> captures = movegen::generate_moves(board_);
     // Filter to captures only
     captures.erase(std::remove_if(captures.begin(), captures.end(),
                                   [](Move m) { return !m.is_capture(); }),
                    captures.end());
-    
+
     // Order captures by MVV-LVA
     std::sort(captures.begin(), captures.end(),
               [](Move a, Move b) { return mvv_lva_score(a) > mvv_lva_score(b); });
 
+    Color us = board_.side_to_move();
     for (Move move : captures) {
-        if (!board.is_legal_move(move)) continue;
-        
-        board.make_move(move);
-        int score = -quiescence(board, -beta, -alpha, stats);
-        board.unmake_move(move);
+        board_.make_move(move);
+        if (board_.in_check(us)) {
+            board_.unmake_move(move);
+            continue;
+        }
+        int score = -quiescence(-beta, -alpha);
+        board_.unmake_move(move);
 
         if (score >= beta) return beta;
         if (score > alpha) alpha = score;
@@ -288,51 +551,114 @@ int quiescence(Board& board, int alpha, int beta, SearchStats& stats) {
     return alpha;
 }
 
-int negamax(Board& board, int depth, int alpha, int beta, SearchStats& stats,
-            TranspositionTable& tt, KillerMoves& killers, HistoryHeuristic& history,
-            const SearchParams& params) {
-    stats.nodes++;
+template <NodeType NT>
+int SearchThread::negamax(int depth, int alpha, int beta) {
+    constexpr bool pv_node = NT != NodeType::NON_PV;
+    constexpr bool root_node = NT == NodeType::ROOT;
 
-    // Check transposition table
-    uint64_t hash = board.hash();
-    TTEntry* tt_entry = tt.probe(hash);
-    if (tt_entry && tt_entry->depth >= depth) {
-        stats.tthits++;
-        if (tt_entry->flag == 0) { // Exact
-            return tt_entry->score;
-        } else if (tt_entry->flag == 1 && tt_entry->score >= beta) { // Lower bound
-            return tt_entry->score;
-        } else if (tt_entry->flag == 2 && tt_entry->score <= alpha) { // Upper bound
-            return tt_entry->score;
+    if constexpr (pv_node) pv_length_[ply_] = ply_;
+
+    if constexpr (!root_node) {
+        // Repetitions and the fifty-move rule
+        if (board_.is_draw(ply_)) return 0;
+
+        // A reversible move back into the search path is available, so the
+        // side to move can always claim at least a draw
+        if (alpha < 0 && board_.has_game_cycle(ply_)) {
+            alpha = 0;
+            if (alpha >= beta) return alpha;
         }
     }
 
-    // Terminal node
-    if (depth == 0) {
-        return quiescence(board, alpha, beta, stats);
+    // Terminal node; queue it for neural evaluation so a later iteration
+    // finds the score cached (PV leaves jump the queue)
+    if (depth <= 0) {
+        if (pipeline_) pipeline_->prefetch(board_, pv_node, deadline_);
+        return quiescence(alpha, beta);
     }
 
-    // Check for checkmate/stalemate
-    std::vector<Move> moves = movegen::generate_legal_moves(board);
-    if (moves.empty()) {
-        if (board.in_check(board.side_to_move())) {
-            return -30000 - depth; // Checkmate
+    stats_.nodes++;
+    if (should_stop()) return 0;
+    if (ply_ >= MAX_PLY - 1) return evaluate_leaf();
+
+    // Check transposition table
+    uint64_t hash = board_.hash();
+    TTEntry tt_entry;
+    bool tt_hit = tt_.probe(hash, tt_entry);
+    Move hash_move = tt_hit ? tt_entry.best_move : Move();
+
+    // Bound cutoffs only at null-window nodes; PV nodes need an exact score for the line
+    if constexpr (!pv_node) {
+        if (tt_hit && tt_entry.depth >= depth) {
+            stats_.tthits++;
+            int tt_score = score_from_tt(tt_entry.score, ply_);
+            if (tt_entry.flag == TT_EXACT ||
+                (tt_entry.flag == TT_LOWER && tt_score >= beta) ||
+                (tt_entry.flag == TT_UPPER && tt_score <= alpha)) {
+                return tt_score;
+            }
         }
-        return 0; // Stalemate
     }
 
-    Move best_move;
-    int best_score = INT_MIN;
-    Move hash_move = (tt_entry) ? tt_entry->best_move : Move();
+    Color us = board_.side_to_move();
+    bool in_check = board_.in_check(us);
+
+    // Null move pruning: give the opponent a free move; if we still fail high, prune
+    if constexpr (!pv_node) {
+        bool after_null = ply_ > 0 && move_stack_[ply_ - 1] == Move();
+        if (!in_check && !after_null && depth >= 3 && has_non_pawn_material(board_, us) &&
+            evaluate(board_) >= beta) {
+            move_stack_[ply_++] = Move();
+            board_.make_null_move();
+            int score = -negamax<NodeType::NON_PV>(depth - 3, -beta, -beta + 1);
+            board_.unmake_null_move();
+            ply_--;
+
+            if (stopped_) return 0;
+            if (score >= beta) return beta;
+        }
+    }
 
-    // Order moves
-    order_moves(moves, hash_move, killers, history, depth, board.side_to_move());
+    std::vector<Move> moves = movegen::generate_moves(board_);
+    order_moves(moves, hash_move);
+
+    Move best_move;
+    int best_score = -SCORE_INFINITE;
+    int legal_moves = 0;
+    uint8_t tt_flag = TT_UPPER;
+    Move quiets_tried[64];
+    int quiet_count = 0;
 
-    uint8_t tt_flag = 2; // Upper bound
     for (Move move : moves) {
-        board.make_move(move);
-        int score = -negamax(board, depth - 1, -beta, -alpha, stats, tt, killers, history, params);
-        board.unmake_move(move);
+        if constexpr (root_node) {
+            if (root_restricted_ && std::find(root_moves_.begin(), root_moves_.end(), move) == root_moves_.end()) {
+                continue;
+            }
+        }
+        board_.make_move(move);
+        if (board_.in_check(us)) {
+            board_.unmake_move(move);
+            continue;
+        }
+        legal_moves++;
+        move_stack_[ply_++] = move;
+        // Null-window children leave no line behind
+        if constexpr (pv_node) pv_length_[ply_] = ply_;
+
+        // Principal variation search: only the first move gets the full window
+        int score;
+        if (legal_moves == 1) {
+            score = -negamax<pv_node ? NodeType::PV : NodeType::NON_PV>(depth - 1, -beta, -alpha);
+        } else {
+            score = -negamax<NodeType::NON_PV>(depth - 1, -alpha - 1, -alpha);
+            if (pv_node && score > alpha && score < beta) {
+                score = -negamax<NodeType::PV>(depth - 1, -beta, -alpha);
+            }
+        }
+
+        ply_--;
+        board_.unmake_move(move);
+        if (stopped_) return 0;
 
         if (score > best_score) {
             best_score = score;
@@ -341,67 +667,254 @@ int negamax(Board& board, int depth, int alpha, int beta, SearchStats& stats,
 
         if (score > alpha) {
             alpha = score;
-            tt_flag = 0; // Exact
+            tt_flag = TT_EXACT;
+            if constexpr (root_node) {
+                root_best_ = move;
+            }
+            if constexpr (pv_node) {
+                pv_table_[ply_][ply_] = move;
+                for (int i = ply_ + 1; i < pv_length_[ply_ + 1]; i++) {
+                    pv_table_[ply_][i] = pv_table_[ply_ + 1][i];
+                }
+                pv_length_[ply_] = std::max(pv_length_[ply_ + 1], ply_ + 1);
+            }
         }
 
         if (alpha >= beta) {
             // Beta cutoff
-            if (!move.is_capture()) {
-                killers.add(depth, move);
-                history.update(board.side_to_move(), move, depth);
+            update_quiet_stats(move, quiets_tried, quiet_count, depth);
+            if (!(root_node && root_restricted_)) {
+                tt_.store(hash, depth, score_to_tt(best_score, ply_), move, TT_LOWER);
             }
-            tt.store(hash, depth, beta, move, 1); // Lower bound
-            return beta;
+            return best_score;
+        }
+
+        if (!move.is_capture() && quiet_count < 64) {
+            quiets_tried[quiet_count++] = move;
         }
     }
 
-    // Store in TT
-    tt.store(hash, depth, best_score, best_move, tt_flag);
+    // Checkmate or stalemate
+    if (legal_moves == 0) {
+        return in_check ? -SCORE_MATE + ply_ : 0;
+    }
+
+    // Store in TT (not a root score over some of its moves only)
+    if (!(root_node && root_restricted_)) {
+        tt_.store(hash, depth, score_to_tt(best_score, ply_), best_move, tt_flag);
+    }
 
     return best_score;
 }
 
-Move search_root(Board& board, const SearchParams& params, SearchStats& stats) {
-    stats = SearchStats{};
-    TranspositionTable tt(16); // 16 MB
-    KillerMoves killers;
-    HistoryHeuristic history;
+// Window around `previous` (the line's score in the last iteration, or
+// SCORE_INFINITE if none) from depth 4 on, not reaching below `floor`
+static void aspiration_window(int depth, int previous, int delta, int floor, int& alpha, int& beta) {
+    alpha = floor;
+    beta = SCORE_INFINITE;
+    if (depth >= 4 && !is_mate_score(previous)) {
+        alpha = std::max(previous - delta, floor);
+        beta = previous + delta;
+        if (beta <= alpha) beta = SCORE_INFINITE;
+    }
+}
 
-    Move best_move;
-    int best_score = INT_MIN;
+// Single-PV root search in an aspiration window; the window widens on
+// each fail
+int SearchThread::search_line(int depth, int previous) {
+    int delta = 25;
+    int alpha, beta;
+    aspiration_window(depth, previous, delta, -SCORE_INFINITE, alpha, beta);
+
+    root_best_ = Move();
+    while (true) {
+        int score = negamax<NodeType::ROOT>(depth, alpha, beta);
+        if (stopped_) return score;
+
+        if (score <= alpha && alpha > -SCORE_INFINITE) {
+            beta = (alpha + beta) / 2;
+            alpha = std::max(score - delta, -SCORE_INFINITE);
+        } else if (score >= beta && beta < SCORE_INFINITE) {
+            beta = std::min(score + delta, SCORE_INFINITE);
+        } else {
+            return score;
+        }
+        delta += delta / 2;
+    }
+}
 
-    // Iterative deepening
-    for (int depth = 1; depth <= params.depth; depth++) {
-        stats.depth = depth;
-        int alpha = INT_MIN;
-        int beta = INT_MAX;
+// Exact score of the root move just made, known to beat `floor`, in an
+// aspiration window around its previous score. At or below `floor` if it
+// does not beat it after all.
+int SearchThread::search_root_move(int depth, int previous, int floor) {
+    int delta = 25;
+    int alpha, beta;
+    aspiration_window(depth, previous, delta, floor, alpha, beta);
+
+    while (true) {
+        int score = -negamax<NodeType::PV>(depth - 1, -beta, -alpha);
+        if (stopped_) return score;
+
+        if (score <= alpha && alpha > floor) {
+            beta = (alpha + beta) / 2;
+            alpha = std::max(score - delta, floor);
+        } else if (score >= beta && beta < SCORE_INFINITE) {
+            beta = std::min(score + delta, SCORE_INFINITE);
+        } else {
+            return score;
+        }
+        delta += delta / 2;
+    }
+}
 
-        std::vector<Move> moves = movegen::generate_legal_moves(board);
-        if (moves.empty()) break;
+// Multi-PV iteration: one pass over the root moves keeping the `count`
+// best with exact scores and full lines. The previous iteration's lines
+// go first; every later move only has to be shown no better than the
+// weakest kept line, which a null-window search does, so the cost stays
+// close to a single-PV search with a lower bound.
+bool SearchThread::search_multipv(int depth, size_t count) {
+    stats_.nodes++;
+
+    TTEntry entry;
+    std::vector<Move> moves = root_moves_;
+    order_moves(moves, tt_.probe(board_.hash(), entry) ? entry.best_move : Move());
+    size_t front = 0;
+    for (const PVLine& old : stats_.lines) {
+        auto it = std::find(moves.begin() + front, moves.end(), old.move);
+        if (it != moves.end()) std::rotate(moves.begin() + front++, it, it + 1);
+    }
 
-        Move current_best = moves[0];
-        int current_score = INT_MIN;
+    std::vector<PVLine> lines;
+    for (Move move : moves) {
+        int floor = lines.size() < count ? -SCORE_INFINITE : lines.back().score;
+        int previous = SCORE_INFINITE;
+        for (const PVLine& old : stats_.lines) {
+            if (old.move == move) previous = old.score;
+        }
 
-        for (Move move : moves) {
-            board.make_move(move);
-            int score = -negamax(board, depth - 1, -beta, -alpha, stats, tt, killers, history, params);
-            board.unmake_move(move);
+        board_.make_move(move);
+        move_stack_[ply_++] = move;
+        pv_length_[ply_] = ply_;
+        bool exact = floor == -SCORE_INFINITE;
+        int score = floor;
+        if (!exact) {
+            score = -negamax<NodeType::NON_PV>(depth - 1, -floor - 1, -floor);
+            exact = !stopped_ && score > floor;
+        }
+        if (exact) score = search_root_move(depth, previous, floor);
+        ply_--;
+        board_.unmake_move(move);
+        if (stopped_) break;
+
+        if (exact && score > floor) {
+            PVLine line{move, score, {move}};
+            line.pv.insert(line.pv.end(), pv_table_[1].begin() + 1, pv_table_[1].begin() + pv_length_[1]);
+            auto at = std::upper_bound(lines.begin(), lines.end(), score,
+                                       [](int value, const PVLine& l) { return value > l.score; });
+            lines.insert(at, std::move(line));
+            if (lines.size() > count) lines.pop_back();
+        }
+    }
+    if (lines.empty()) return !stopped_;
 
-            if (score > current_score) {
-                current_score = score;
-                current_best = move;
-            }
-            if (score > alpha) alpha = score;
+    // As with a single line, a fully searched move can improve on the
+    // previous iteration's best even when this one was interrupted
+    stats_.best_move = lines.front().move;
+    if (stopped_) return false;
+
+    if (!root_restricted_) {
+        tt_.store(board_.hash(), depth, lines.front().score, lines.front().move, TT_EXACT);
+    }
+    stats_.best_score = lines.front().score;
+    stats_.depth = depth;
+    stats_.lines = std::move(lines);
+    return true;
+}
+
+bool SearchThread::search_iteration(int depth) {
+    size_t count = std::min<size_t>(std::max(params_.multi_pv, 1), root_moves_.size());
+    if (count > 1) return search_multipv(depth, count);
+
+    int previous = stats_.lines.empty() ? SCORE_INFINITE : stats_.lines.front().score;
+    int score = search_line(depth, previous);
+
+    // A root move only becomes best once fully searched, so even an
+    // interrupted iteration can improve on the previous one
+    if (root_best_ != Move()) {
+        stats_.best_move = root_best_;
+        if (!stopped_) {
+            stats_.depth = depth;
+            stats_.best_score = score;
+            stats_.lines.assign(1, {root_best_, score,
+                                    std::vector<Move>(pv_table_[0].begin(), pv_table_[0].begin() + pv_length_[0])});
         }
+    }
+    return !stopped_;
+}
 
-        best_move = current_best;
-        best_score = current_score;
+Move SearchThread::iterative_deepening() {
+    for (int depth = std::max(1, params_.start_depth); depth <= params_.depth; depth++) {
+        if (!search_iteration(depth)) break;
     }
+    return stats_.best_move;
+}
+
+Move search_root(Board& board, const SearchParams& params, SearchStats& stats) {
+    TranspositionTable tt(16); // 16 MB
+    return search_root(board, tt, params, stats);
+}
+
+Move search_root(Board& board, TranspositionTable& tt, const SearchParams& params, SearchStats& stats) {
+    SearchThread thread(board, tt, params);
 
-    stats.best_move = best_move;
-    stats.best_score = best_score;
+    Move best_move = thread.iterative_deepening();
+    stats = thread.stats();
     return best_move;
 }
 
-} // namespace fianchetto
+std::vector<Move> extract_pv(Board& board, TranspositionTable& tt, int max_length) {
+    std::vector<Move> pv;
+    std::vector<uint64_t> seen;
+
+    while (static_cast<int>(pv.size()) < max_length) {
+        TTEntry entry;
+        if (!tt.probe(board.hash(), entry) || entry.best_move == Move()) break;
+        if (std::find(seen.begin(), seen.end(), board.hash()) != seen.end()) break;
+
+        // The entry may belong to a colliding position; only follow legal moves
+        std::vector<Move> legal = movegen::generate_legal_moves(board);
+        if (std::find(legal.begin(), legal.end(), entry.best_move) == legal.end()) break;
+
+        seen.push_back(board.hash());
+        pv.push_back(entry.best_move);
+        board.make_move(entry.best_move);
+    }
 
+    for (auto it = pv.rbegin(); it != pv.rend(); ++it) {
+        board.unmake_move(*it);
+    }
+    return pv;
+}
+
+void seed_pv(Board& board, TranspositionTable& tt, const std::vector<Move>& pv, int depth, int score) {
+    size_t played = 0;
+    for (Move move : pv) {
+        int remaining = depth - static_cast<int>(played);
+        if (remaining <= 0) break;
+        std::vector<Move> legal = movegen::generate_legal_moves(board);
+        if (std::find(legal.begin(), legal.end(), move) == legal.end()) break;
+
+        // Scores alternate sides along the line; mate distances become
+        // relative to each node
+        int node_score = played % 2 == 0 ? score : -score;
+        tt.store(board.hash(), remaining, score_to_tt(node_score, static_cast<int>(played)), move, TT_EXACT);
+        board.make_move(move);
+        played++;
+    }
+
+    for (size_t i = played; i > 0; i--) {
+        board.unmake_move(pv[i - 1]);
+    }
+}
+
+} // namespace fianchetto
@@ -0,0 +1,208 @@
+#include "search_scheduler.hpp"
+#include "platform.hpp"
+#include <algorithm>
+
+namespace fianchetto {
+
+SearchScheduler::SearchScheduler(const SearchSchedulerOptions& options)
+    : options_(options), running_(0), virtual_clock_(0), stop_(false), stats_{} {
+    options_.threads = std::max(1, options_.threads);
+    for (int i = 0; i < options_.threads; i++) {
+        workers_.emplace_back([this, i] {
+            if (options_.pin_threads) platform::pin_current_thread(i);
+            worker_loop();
+        });
+    }
+}
+
+SearchScheduler::~SearchScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) worker.join();
+
+    // Tasks still queued report whatever they have so far
+    for (auto& job : ready_) finish(std::move(job));
+}
+
+std::future<SearchOutcome> SearchScheduler::submit(const Board& board, const SearchTask& task) {
+    auto job = std::make_unique<Job>(board, task);
+    job->priority = std::max(1, task.priority);
+    job->submitted = Clock::now();
+    job->deadline = task.params.time_limit_ms > 0
+                        ? job->submitted + std::chrono::milliseconds(task.params.time_limit_ms)
+                        : Clock::time_point::max();
+    auto future = job->promise.get_future();
+
+    if (!job->tt) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!free_tables_.empty()) {
+                job->pooled_tt = std::move(free_tables_.back());
+                free_tables_.pop_back();
+            }
+        }
+        if (!job->pooled_tt) {
+            job->pooled_tt = options_.hash_file.empty()
+                                 ? std::make_unique<TranspositionTable>(options_.hash_mb)
+                                 : TranspositionTable::open_snapshot(options_.hash_file, options_.hash_mb);
+        }
+        job->tt = job->pooled_tt.get();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job->virtual_time = virtual_clock_;
+        ready_.push_back(std::move(job));
+        stats_.submitted++;
+    }
+    cv_.notify_one();
+    return future;
+}
+
+size_t SearchScheduler::active() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ready_.size() + running_;
+}
+
+SearchSchedulerStats SearchScheduler::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// Called with mutex_ held and ready_ non-empty
+std::unique_ptr<SearchScheduler::Job> SearchScheduler::pick(Clock::time_point now) {
+    auto pressure = std::chrono::milliseconds(options_.pressure_ms);
+    auto under_pressure = [&](const Job& job) {
+        return job.deadline != Clock::time_point::max() && job.deadline - now <= pressure;
+    };
+
+    auto best = ready_.end();
+    bool best_pressured = false;
+    for (auto it = ready_.begin(); it != ready_.end(); ++it) {
+        const Job& job = **it;
+        bool pressured = under_pressure(job);
+        if (best == ready_.end()) {
+            best = it;
+            best_pressured = pressured;
+            continue;
+        }
+        const Job& current = **best;
+        bool better;
+        if (pressured != best_pressured) {
+            better = pressured;
+        } else if (pressured) {
+            better = job.priority != current.priority ? job.priority > current.priority
+                                                      : job.deadline < current.deadline;
+        } else {
+            better = job.virtual_time != current.virtual_time ? job.virtual_time < current.virtual_time
+                                                              : job.submitted < current.submitted;
+        }
+        if (better) {
+            best = it;
+            best_pressured = pressured;
+        }
+    }
+
+    std::unique_ptr<Job> job = std::move(*best);
+    *best = std::move(ready_.back());
+    ready_.pop_back();
+
+    virtual_clock_ = std::max(virtual_clock_, job->virtual_time);
+    stats_.slices++;
+    if (best_pressured) stats_.pressured++;
+    return job;
+}
+
+void SearchScheduler::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this] { return stop_ || !ready_.empty(); });
+        if (stop_) return;
+
+        std::unique_ptr<Job> job = pick(Clock::now());
+        running_++;
+        lock.unlock();
+
+        bool done = run_slice(*job);
+
+        lock.lock();
+        running_--;
+        if (!done) {
+            ready_.push_back(std::move(job));
+            cv_.notify_one();
+        } else {
+            lock.unlock();
+            finish(std::move(job));
+            lock.lock();
+        }
+    }
+}
+
+// Runs the task's next iteration; returns true when the task is finished
+bool SearchScheduler::run_slice(Job& job) {
+    auto now = Clock::now();
+
+    if (!job.thread) {
+        job.first_slice = now;
+        if (!job.seed_pv.empty()) seed_pv(job.board, *job.tt, job.seed_pv, job.next_depth - 1, job.seed_score);
+        job.thread = std::make_unique<SearchThread>(job.board, *job.tt, job.params);
+    }
+    if (job.next_depth == 1) {
+        // The first iteration is tiny and guarantees a move, so it ignores
+        // the budget even when the task waited past its deadline
+        job.thread->set_limits(Clock::time_point::max(), 0);
+    } else {
+        // Skip an iteration that would not finish in the time left
+        // (iterations grow by roughly the effective branching factor)
+        if (now >= job.deadline || job.deadline - now < 2 * job.last_iteration) return true;
+        job.thread->set_limits(job.deadline, job.params.node_limit);
+    }
+
+    uint64_t nodes_before = job.thread->stats().nodes + job.thread->stats().qnodes;
+    bool completed = job.thread->search_iteration(job.next_depth++);
+    uint64_t nodes = job.thread->stats().nodes + job.thread->stats().qnodes - nodes_before;
+
+    job.last_iteration = Clock::now() - now;
+    job.virtual_time += static_cast<double>(nodes) / job.priority;
+
+    if (!completed || job.next_depth > job.params.depth) return true;
+    return job.params.node_limit && job.thread->stats().nodes + job.thread->stats().qnodes >= job.params.node_limit;
+}
+
+void SearchScheduler::finish(std::unique_ptr<Job> job) {
+    auto now = Clock::now();
+
+    SearchOutcome outcome{};
+    if (job->thread) {
+        outcome.stats = job->thread->stats();
+        outcome.best_move = outcome.stats.best_move;
+        job->thread.reset();
+        outcome.pv = extract_pv(job->board, *job->tt, std::max(outcome.stats.depth, 1));
+    } else {
+        job->first_slice = now;
+    }
+    outcome.queued_ms = std::chrono::duration_cast<std::chrono::milliseconds>(job->first_slice - job->submitted).count();
+    outcome.deadline_missed = now > job->deadline;
+
+    // A pooled table goes back empty: the next task searches an unrelated
+    // position, and entries left in the same generation would otherwise
+    // outrank its own. A snapshot table is dropped instead, so the next
+    // task maps the snapshot afresh rather than copying every page.
+    if (job->pooled_tt) {
+        if (job->pooled_tt->from_snapshot()) job->pooled_tt.reset();
+        else job->pooled_tt->clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (job->pooled_tt) free_tables_.push_back(std::move(job->pooled_tt));
+        stats_.completed++;
+        if (outcome.deadline_missed) stats_.deadline_misses++;
+    }
+    job->promise.set_value(outcome);
+}
+
+} // namespace fianchetto
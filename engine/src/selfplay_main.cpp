@@ -0,0 +1,204 @@
+#include "board.hpp"
+#include "movegen.hpp"
+#include "nnue.hpp"
+#include "platform.hpp"
+#include "search.hpp"
+#include "training_data.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Self-play training data: each worker thread plays games against itself
+// with node-limited searches from a randomized opening, and writes every
+// searched position (score and final result from white's point of view)
+// as a PackedPosition through its own TrainingWriter::Buffer.
+
+namespace {
+
+using namespace fianchetto;
+
+const char* STARTPOS = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Recorded scores are clamped to this, mates included, so a few mate scores
+// (near +-30000) do not dominate a squared-error training loss
+constexpr int MATE_TARGET = 2000;
+
+void usage() {
+    std::cerr << "Usage: fianchetto_selfplay --output PATH [--games N] [--nodes N] [--depth N]\n"
+                 "                           [--random-plies N] [--max-plies N] [--threads N] [--hash MB]\n"
+                 "                           [--seed N] [--pin-threads 0|1] [--eval-file PATH]\n";
+}
+
+struct Options {
+    SearchParams params;
+    uint64_t games = 1000;
+    int random_plies = 8;  // Uniformly random moves before the engine takes over
+    int max_plies = 400;   // Longer games are scored as draws
+    int threads = 1;
+    size_t hash_mb = 16;
+    uint64_t seed = 1;
+    bool pin_threads = false;
+};
+
+struct Counters {
+    std::atomic<uint64_t> started{0};
+    std::atomic<uint64_t> positions{0};
+    std::atomic<uint64_t> wins{0}; // For white
+    std::atomic<uint64_t> draws{0};
+    std::atomic<uint64_t> losses{0};
+};
+
+bool insufficient_material(const Board& board) {
+    Bitboard heavy = 0;
+    Bitboard minors = 0;
+    for (Color c : {Color::WHITE, Color::BLACK}) {
+        heavy |= board.pieces(PieceType::PAWN, c) | board.pieces(PieceType::ROOK, c) |
+                 board.pieces(PieceType::QUEEN, c);
+        minors |= board.pieces(PieceType::KNIGHT, c) | board.pieces(PieceType::BISHOP, c);
+    }
+    return heavy == 0 && __builtin_popcountll(minors) <= 1;
+}
+
+// Random opening that leaves the side to move with a legal move
+void play_opening(Board& board, int plies, std::mt19937_64& rng) {
+    for (;;) {
+        board.set_fen(STARTPOS);
+        for (int ply = 0; ply < plies; ply++) {
+            std::vector<Move> moves = movegen::generate_legal_moves(board);
+            if (moves.empty()) break;
+            board.make_move(moves[rng() % moves.size()]);
+        }
+        if (!movegen::generate_legal_moves(board).empty()) return;
+    }
+}
+
+// Play one game and return the result for white
+int play_game(Board& board, TranspositionTable& tt, const Options& options, std::mt19937_64& rng,
+              std::vector<PackedPosition>& game) {
+    play_opening(board, options.random_plies, rng);
+    tt.age();
+    game.clear();
+
+    for (int ply = 0;; ply++) {
+        std::vector<Move> moves = movegen::generate_legal_moves(board);
+        if (moves.empty()) {
+            if (!board.in_check(board.side_to_move())) return 0;
+            return board.side_to_move() == Color::WHITE ? -1 : 1;
+        }
+        if (ply >= options.max_plies || board.is_draw(0) || insufficient_material(board)) return 0;
+
+        SearchStats stats;
+        Move best = search_root(board, tt, options.params, stats);
+
+        // A budget too small to finish depth 1 leaves no score to record
+        if (best == Move()) {
+            board.make_move(moves.front());
+            continue;
+        }
+        int score = std::clamp(stats.best_score, -MATE_TARGET, MATE_TARGET);
+        if (board.side_to_move() == Color::BLACK) score = -score;
+        game.push_back(pack_position(board, score, 0));
+        board.make_move(best);
+    }
+}
+
+void worker(int index, const Options& options, const nnue::Network* network, TrainingWriter& writer,
+            Counters& counters) {
+    if (options.pin_threads) platform::pin_current_thread(index);
+
+    std::mt19937_64 rng(options.seed * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(index));
+    Board board;
+    board.set_network(network);
+    TranspositionTable tt(options.hash_mb);
+    TrainingWriter::Buffer buffer(writer);
+    std::vector<PackedPosition> game;
+
+    while (counters.started.fetch_add(1, std::memory_order_relaxed) < options.games) {
+        int result = play_game(board, tt, options, rng, game);
+        for (PackedPosition& record : game) {
+            record.result = static_cast<int8_t>(result);
+            buffer.add(record);
+        }
+        counters.positions.fetch_add(game.size(), std::memory_order_relaxed);
+        (result > 0 ? counters.wins : result < 0 ? counters.losses : counters.draws)
+            .fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    options.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    options.params.depth = MAX_PLY - 1;
+    options.params.node_limit = 5000;
+    std::string output_path;
+    std::string eval_file;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--output") output_path = value;
+        else if (arg == "--games") options.games = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--nodes") options.params.node_limit = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--depth") options.params.depth = std::clamp(std::atoi(value.c_str()), 1, MAX_PLY - 1);
+        else if (arg == "--random-plies") options.random_plies = std::max(0, std::atoi(value.c_str()));
+        else if (arg == "--max-plies") options.max_plies = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--threads") options.threads = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--hash") options.hash_mb = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--seed") options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--pin-threads") options.pin_threads = value == "1";
+        else if (arg == "--eval-file") eval_file = value;
+        else {
+            usage();
+            return 1;
+        }
+    }
+    if (output_path.empty()) {
+        usage();
+        return 1;
+    }
+
+    nnue::Network network;
+    if (!eval_file.empty() && !network.load(eval_file)) {
+        std::cerr << "Failed to load NNUE file " << eval_file << std::endl;
+        return 1;
+    }
+
+    TrainingWriter writer(output_path);
+    if (!writer.is_open()) {
+        std::cerr << "Cannot open " << output_path << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Counters counters;
+    std::vector<std::thread> workers;
+    for (int i = 0; i < options.threads; i++) {
+        workers.emplace_back(worker, i, std::cref(options), network.loaded() ? &network : nullptr,
+                             std::ref(writer), std::ref(counters));
+    }
+    for (auto& thread : workers) thread.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t positions = counters.positions.load();
+    std::cerr << options.games << " games (+" << counters.wins.load() << " =" << counters.draws.load()
+              << " -" << counters.losses.load() << "), " << positions << " positions, "
+              << static_cast<uint64_t>(positions / std::max(seconds, 1e-3)) << " positions/s" << std::endl;
+
+    if (!writer.ok()) {
+        std::cerr << "Write to " << output_path << " failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "engine_server.hpp"
+#include "nnue.hpp"
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+fianchetto::EngineServer* g_server = nullptr;
+
+void handle_signal(int) {
+    if (g_server) g_server->stop();
+}
+
+void usage() {
+    std::cerr << "Usage: fianchetto_server [--host ADDR] [--port N] [--workers N] [--requests N]\n"
+                 "                         [--hash MB] [--sessions N] [--analysis-cache N]\n"
+                 "                         [--pin-threads 0|1] [--hash-file PATH] [--eval-file PATH]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    fianchetto::EngineServerOptions options;
+    options.workers = std::max(1u, std::thread::hardware_concurrency());
+    std::string host = "0.0.0.0";
+    int port = 8080;
+    std::string eval_file;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--host") host = value;
+        else if (arg == "--port") port = std::atoi(value.c_str());
+        else if (arg == "--workers") options.workers = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--requests") options.max_requests = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--hash") options.hash_mb = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--sessions") options.max_sessions = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--analysis-cache") options.analysis_cache_entries = std::max(0, std::atoi(value.c_str()));
+        else if (arg == "--pin-threads") options.pin_threads = value == "1";
+        else if (arg == "--hash-file") options.hash_file = value;
+        else if (arg == "--eval-file") eval_file = value;
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    fianchetto::nnue::Network network;
+    if (!eval_file.empty() && !network.load(eval_file)) {
+        std::cerr << "Failed to load NNUE file " << eval_file << std::endl;
+        return 1;
+    }
+
+    fianchetto::EngineServer server(options, network.loaded() ? &network : nullptr);
+    if (!server.listen(host, port)) {
+        std::cerr << "Cannot listen on " << host << ":" << port << std::endl;
+        return 1;
+    }
+
+    g_server = &server;
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+
+    std::cout << "Fianchetto server listening on " << host << ":" << server.port()
+              << " (" << options.workers << " workers)" << std::endl;
+    server.run();
+    g_server = nullptr;
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include "service_health.hpp"
+#include <bit>
+#include <chrono>
+
+namespace fianchetto {
+
+namespace {
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+CircuitBreaker::CircuitBreaker(int failure_threshold, int cooldown_ms)
+    : failure_threshold_(failure_threshold),
+      cooldown_ns_(static_cast<int64_t>(cooldown_ms) * 1000000),
+      consecutive_failures_(0), open_until_ns_(0), probe_in_flight_(false), trips_(0) {}
+
+bool CircuitBreaker::allow() {
+    int64_t open_until = open_until_ns_.load(std::memory_order_acquire);
+    if (open_until == 0) return true;
+    if (now_ns() < open_until) return false;
+
+    // Half-open: exactly one caller probes the service
+    bool expected = false;
+    return probe_in_flight_.compare_exchange_strong(expected, true, std::memory_order_acq_rel);
+}
+
+void CircuitBreaker::record_success() {
+    consecutive_failures_.store(0, std::memory_order_relaxed);
+    open_until_ns_.store(0, std::memory_order_release);
+    probe_in_flight_.store(false, std::memory_order_release);
+}
+
+void CircuitBreaker::record_failure() {
+    if (open_until_ns_.load(std::memory_order_acquire) != 0) {
+        // Failed probe (or a call that started before the breaker opened)
+        trip();
+        return;
+    }
+    if (consecutive_failures_.fetch_add(1, std::memory_order_relaxed) + 1 >= failure_threshold_) {
+        trip();
+    }
+}
+
+void CircuitBreaker::trip() {
+    open_until_ns_.store(now_ns() + cooldown_ns_, std::memory_order_release);
+    probe_in_flight_.store(false, std::memory_order_release);
+    trips_.fetch_add(1, std::memory_order_relaxed);
+}
+
+LatencyHistogram::LatencyHistogram() {
+    clear();
+}
+
+void LatencyHistogram::record(uint64_t us) {
+    int index = us <= 1 ? 0 : std::bit_width(us - 1);
+    if (index >= BUCKETS) index = BUCKETS - 1;
+    buckets_[index].fetch_add(1, std::memory_order_relaxed);
+    total_us_.fetch_add(us, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::clear() {
+    for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+    total_us_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::count() const {
+    uint64_t total = 0;
+    for (const auto& bucket : buckets_) total += bucket.load(std::memory_order_relaxed);
+    return total;
+}
+
+double LatencyHistogram::mean_us() const {
+    uint64_t n = count();
+    return n ? static_cast<double>(total_us_.load(std::memory_order_relaxed)) / n : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile_us(double p) const {
+    uint64_t n = count();
+    if (n == 0) return 0;
+
+    uint64_t rank = static_cast<uint64_t>(p * n);
+    if (rank >= n) rank = n - 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += bucket(i);
+        if (seen > rank) return i == 0 ? 1 : (1ULL << i);
+    }
+    return 1ULL << (BUCKETS - 1);
+}
+
+} // namespace fianchetto
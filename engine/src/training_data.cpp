@@ -0,0 +1,158 @@
+#include "training_data.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fianchetto {
+
+PackedPosition pack_position(const Board& board, int score, int result) {
+    PackedPosition packed{};
+    packed.occupancy = board.all_pieces();
+
+    int index = 0;
+    for (Bitboard bb = packed.occupancy; bb && index < 32; bb &= bb - 1, index++) {
+        Square sq = static_cast<Square>(__builtin_ctzll(bb));
+        int code = static_cast<int>(board.color_on(sq)) * 6 + static_cast<int>(board.piece_on(sq)) - 1;
+        packed.pieces[index / 2] |= static_cast<uint8_t>(code << (index % 2 * 4));
+    }
+
+    packed.score = static_cast<int16_t>(std::clamp(score, -32767, 32767));
+    packed.fullmove = static_cast<uint16_t>(std::clamp(board.fullmove_number(), 0, 65535));
+    packed.halfmove = static_cast<uint8_t>(std::clamp(board.halfmove_clock(), 0, 255));
+    packed.ep_square = board.en_passant_square() < 64 ? board.en_passant_square() : PACKED_NO_EP;
+    packed.flags = (board.side_to_move() == Color::BLACK ? 1 : 0) |
+                   (board.can_castle_kingside(Color::WHITE) ? 2 : 0) |
+                   (board.can_castle_queenside(Color::WHITE) ? 4 : 0) |
+                   (board.can_castle_kingside(Color::BLACK) ? 8 : 0) |
+                   (board.can_castle_queenside(Color::BLACK) ? 16 : 0);
+    packed.result = static_cast<int8_t>(std::clamp(result, -1, 1));
+    return packed;
+}
+
+std::string packed_to_fen(const PackedPosition& packed) {
+    int count = __builtin_popcountll(packed.occupancy);
+    if (count == 0 || count > 32) return "";
+
+    // Piece code of each occupied square, in square order
+    char on_square[64] = {};
+    int index = 0;
+    for (Bitboard bb = packed.occupancy; bb; bb &= bb - 1, index++) {
+        int code = (packed.pieces[index / 2] >> (index % 2 * 4)) & 0xF;
+        if (code > 11) return "";
+        on_square[__builtin_ctzll(bb)] = "PNBRQKpnbrqk"[code];
+    }
+
+    std::ostringstream oss;
+    for (int rank = 7; rank >= 0; rank--) {
+        int empty = 0;
+        for (int file = 0; file < 8; file++) {
+            char c = on_square[square(file, rank)];
+            if (!c) {
+                empty++;
+                continue;
+            }
+            if (empty > 0) oss << empty;
+            empty = 0;
+            oss << c;
+        }
+        if (empty > 0) oss << empty;
+        if (rank > 0) oss << '/';
+    }
+
+    oss << ' ' << (packed.flags & 1 ? 'b' : 'w') << ' ';
+    if ((packed.flags & 30) == 0) oss << '-';
+    if (packed.flags & 2) oss << 'K';
+    if (packed.flags & 4) oss << 'Q';
+    if (packed.flags & 8) oss << 'k';
+    if (packed.flags & 16) oss << 'q';
+    oss << ' ' << (packed.ep_square < 64 ? square_to_string(packed.ep_square) : "-");
+    oss << ' ' << static_cast<int>(packed.halfmove) << ' ' << packed.fullmove;
+    return oss.str();
+}
+
+bool unpack_position(const PackedPosition& packed, Board& board) {
+    std::string fen = packed_to_fen(packed);
+    if (fen.empty()) return false;
+    board.set_fen(fen);
+    return true;
+}
+
+TrainingWriter::TrainingWriter(const std::string& path)
+    : fd_(open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)), offset_(0), failed_(false) {}
+
+TrainingWriter::~TrainingWriter() {
+    if (fd_ >= 0) close(fd_);
+}
+
+bool TrainingWriter::write(const PackedPosition* records, size_t count) {
+    if (fd_ < 0) return false;
+
+    size_t length = count * sizeof(PackedPosition);
+    uint64_t offset = offset_.fetch_add(length, std::memory_order_relaxed);
+    const char* p = reinterpret_cast<const char*>(records);
+    while (length > 0) {
+        ssize_t n = pwrite(fd_, p, length, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            // The reserved range stays zero-filled: occupancy 0 marks it invalid
+            failed_.store(true, std::memory_order_relaxed);
+            return false;
+        }
+        p += n;
+        offset += static_cast<uint64_t>(n);
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+TrainingWriter::Buffer::Buffer(TrainingWriter& writer, size_t capacity)
+    : writer_(writer), capacity_(std::max<size_t>(1, capacity)) {
+    records_.reserve(capacity_);
+}
+
+void TrainingWriter::Buffer::add(const PackedPosition& record) {
+    records_.push_back(record);
+    if (records_.size() >= capacity_) flush();
+}
+
+bool TrainingWriter::Buffer::flush() {
+    if (records_.empty()) return true;
+    bool ok = writer_.write(records_.data(), records_.size());
+    records_.clear();
+    return ok;
+}
+
+TrainingReader::~TrainingReader() {
+    if (mapping_) munmap(mapping_, mapping_size_);
+}
+
+bool TrainingReader::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st{};
+    size_t length = 0;
+    if (fstat(fd, &st) == 0) length = static_cast<size_t>(st.st_size);
+    if (length == 0 || length % sizeof(PackedPosition) != 0) {
+        close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return false;
+    madvise(mapping, length, MADV_SEQUENTIAL);
+
+    if (mapping_) munmap(mapping_, mapping_size_);
+    mapping_ = mapping;
+    mapping_size_ = length;
+    records_ = static_cast<const PackedPosition*>(mapping);
+    size_ = length / sizeof(PackedPosition);
+    return true;
+}
+
+} // namespace fianchetto
@@ -0,0 +1,254 @@
+#include "transposition_table.hpp"
+#include "board.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fianchetto {
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared slots need lock-free 64-bit atomics");
+
+namespace {
+
+constexpr size_t MB = 1024 * 1024;
+
+uint64_t pack(int depth, int score, Move move, uint8_t flag, uint8_t age) {
+    return static_cast<uint64_t>(move.data) |
+           static_cast<uint64_t>(static_cast<uint16_t>(score)) << 32 |
+           static_cast<uint64_t>(std::clamp(depth, 0, 255)) << 48 |
+           static_cast<uint64_t>(flag & 0x3) << 56 |
+           static_cast<uint64_t>(age & 0x3F) << 58;
+}
+
+int depth_of(uint64_t data) { return static_cast<int>((data >> 48) & 0xFF); }
+uint8_t age_of(uint64_t data) { return static_cast<uint8_t>(data >> 58); }
+
+// A creator that has not finished setting up the segment yet
+template <typename Ready>
+bool wait_for(Ready ready) {
+    for (int i = 0; i < 1000; i++) {
+        if (ready()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return ready();
+}
+
+} // namespace
+
+TranspositionTable::TranspositionTable(size_t size_mb)
+    : slots_(nullptr), size_(0), backing_(Backing::PRIVATE), mapping_(nullptr), mapping_size_(0), local_generation_(0),
+      generation_(&local_generation_) {
+    allocate_private(size_mb);
+}
+
+TranspositionTable::TranspositionTable(size_t size_mb, const std::string& shm_name)
+    : slots_(nullptr), size_(0), backing_(Backing::PRIVATE), mapping_(nullptr), mapping_size_(0), local_generation_(0),
+      generation_(&local_generation_) {
+    if (!attach_shared(size_mb, shm_name)) allocate_private(size_mb);
+}
+
+TranspositionTable::~TranspositionTable() {
+    if (mapping_) munmap(mapping_, mapping_size_);
+}
+
+void TranspositionTable::allocate_private(size_t size_mb) {
+    size_ = std::max<size_t>(1, size_mb * MB / sizeof(Slot));
+    buffer_ = platform::LargeBuffer(size_ * sizeof(Slot));
+    slots_ = static_cast<Slot*>(buffer_.data());
+    platform::parallel_clear(slots_, size_ * sizeof(Slot));
+}
+
+bool TranspositionTable::attach_shared(size_t size_mb, const std::string& shm_name) {
+    int fd = shm_open(shm_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    bool creator = fd >= 0;
+    if (!creator) {
+        if (errno != EEXIST) return false;
+        fd = shm_open(shm_name.c_str(), O_RDWR, 0600);
+        if (fd < 0) return false;
+    }
+
+    size_t slot_count = std::max<size_t>(1, size_mb * MB / sizeof(Slot));
+    size_t total = SLOTS_OFFSET + slot_count * sizeof(Slot);
+    if (creator) {
+        // ftruncate zero-fills, which is an empty slot
+        if (ftruncate(fd, static_cast<off_t>(total)) != 0) {
+            close(fd);
+            shm_unlink(shm_name.c_str());
+            return false;
+        }
+    } else {
+        struct stat st{};
+        if (!wait_for([&] { return fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) > SLOTS_OFFSET; })) {
+            close(fd);
+            return false;
+        }
+        total = static_cast<size_t>(st.st_size);
+    }
+
+    void* mapping = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        if (creator) shm_unlink(shm_name.c_str());
+        return false;
+    }
+
+    auto* header = static_cast<SharedHeader*>(mapping);
+    if (creator) {
+        header->version = SHARED_VERSION;
+        header->slot_count = slot_count;
+        header->generation.store(0, std::memory_order_relaxed);
+        header->magic.store(SHARED_MAGIC, std::memory_order_release);
+    } else {
+        bool ready = wait_for([&] { return header->magic.load(std::memory_order_acquire) == SHARED_MAGIC; });
+        if (!ready || header->version != SHARED_VERSION ||
+            SLOTS_OFFSET + header->slot_count * sizeof(Slot) > total) {
+            munmap(mapping, total);
+            return false;
+        }
+        slot_count = header->slot_count;
+    }
+
+    backing_ = Backing::SHARED;
+    mapping_ = mapping;
+    mapping_size_ = total;
+    slots_ = reinterpret_cast<Slot*>(static_cast<char*>(mapping) + SLOTS_OFFSET);
+    size_ = slot_count;
+    generation_ = &header->generation;
+    return true;
+}
+
+bool TranspositionTable::save(const std::string& path) const {
+    static_assert(sizeof(SnapshotHeader) <= SLOTS_OFFSET);
+    SnapshotHeader header{};
+    std::copy(std::begin(SNAPSHOT_MAGIC), std::end(SNAPSHOT_MAGIC), header.magic);
+    header.version = SNAPSHOT_VERSION;
+    header.slot_size = sizeof(Slot);
+    header.slot_count = size_;
+    header.zobrist = Board::zobrist_fingerprint();
+    header.generation = generation_->load(std::memory_order_relaxed);
+
+    char block[SLOTS_OFFSET] = {};
+    std::memcpy(block, &header, sizeof(header));
+
+    // Write everything to a temporary file first so a crash never leaves
+    // a truncated snapshot under the real name
+    std::string temp = path + ".tmp";
+    int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    auto write_all = [fd](const void* data, size_t length) {
+        const char* p = static_cast<const char*>(data);
+        while (length > 0) {
+            ssize_t n = write(fd, p, length);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            p += n;
+            length -= static_cast<size_t>(n);
+        }
+        return true;
+    };
+    bool ok = write_all(block, sizeof(block)) && write_all(slots_, size_ * sizeof(Slot)) && fsync(fd) == 0;
+    ok = close(fd) == 0 && ok;
+    if (!ok || rename(temp.c_str(), path.c_str()) != 0) {
+        unlink(temp.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool TranspositionTable::load(const std::string& path) {
+    if (backing_ == Backing::SHARED) return false;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    SnapshotHeader header{};
+    struct stat st{};
+    bool valid = pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                 fstat(fd, &st) == 0 &&
+                 std::equal(std::begin(SNAPSHOT_MAGIC), std::end(SNAPSHOT_MAGIC), header.magic) &&
+                 header.version == SNAPSHOT_VERSION && header.slot_size == sizeof(Slot) &&
+                 header.slot_count > 0 && header.zobrist == Board::zobrist_fingerprint() &&
+                 static_cast<size_t>(st.st_size) == SLOTS_OFFSET + header.slot_count * sizeof(Slot);
+    if (!valid) {
+        close(fd);
+        return false;
+    }
+
+    // Private mapping: pages come from the page cache on first probe, and
+    // stores copy only the pages they touch
+    size_t total = static_cast<size_t>(st.st_size);
+    void* mapping = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return false;
+    madvise(mapping, total, MADV_WILLNEED);
+
+    if (mapping_) munmap(mapping_, mapping_size_);
+    buffer_ = platform::LargeBuffer();
+    backing_ = Backing::SNAPSHOT;
+    mapping_ = mapping;
+    mapping_size_ = total;
+    slots_ = reinterpret_cast<Slot*>(static_cast<char*>(mapping) + SLOTS_OFFSET);
+    size_ = header.slot_count;
+    generation_ = &local_generation_;
+    local_generation_.store(header.generation, std::memory_order_relaxed);
+    return true;
+}
+
+std::unique_ptr<TranspositionTable> TranspositionTable::open_snapshot(const std::string& path, size_t size_mb) {
+    auto tt = std::make_unique<TranspositionTable>(0);
+    if (tt->load(path)) return tt;
+    return std::make_unique<TranspositionTable>(size_mb);
+}
+
+bool TranspositionTable::unlink_shared(const std::string& shm_name) {
+    return shm_unlink(shm_name.c_str()) == 0;
+}
+
+void TranspositionTable::store(uint64_t hash, int depth, int score, Move best_move, uint8_t flag) {
+    Slot& slot = slots_[hash % size_];
+    uint8_t generation = generation_->load(std::memory_order_relaxed) & 0x3F;
+    uint64_t old_data = slot.data.load(std::memory_order_relaxed);
+    uint64_t old_key = slot.key_xor_data.load(std::memory_order_relaxed) ^ old_data;
+
+    // Replace if empty, not deeper, or from an older search
+    if (old_key == 0 || depth_of(old_data) <= depth || age_of(old_data) != generation) {
+        uint64_t data = pack(depth, score, best_move, flag, generation);
+        slot.key_xor_data.store(hash ^ data, std::memory_order_relaxed);
+        slot.data.store(data, std::memory_order_relaxed);
+    }
+}
+
+bool TranspositionTable::probe(uint64_t hash, TTEntry& entry) const {
+    const Slot& slot = slots_[hash % size_];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    if ((slot.key_xor_data.load(std::memory_order_relaxed) ^ data) != hash) return false;
+
+    uint8_t generation = generation_->load(std::memory_order_relaxed) & 0x3F;
+    if (age_of(data) != generation) return false;
+
+    entry.hash = hash;
+    entry.best_move = Move(static_cast<uint32_t>(data));
+    entry.score = static_cast<int16_t>(data >> 32);
+    entry.depth = depth_of(data);
+    entry.flag = static_cast<uint8_t>((data >> 56) & 0x3);
+    entry.age = generation;
+    return true;
+}
+
+// Not safe against concurrent searches on the same table
+void TranspositionTable::clear() {
+    platform::parallel_clear(slots_, size_ * sizeof(Slot));
+}
+
+void TranspositionTable::age() {
+    generation_->fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace fianchetto
@@ -1,28 +1,29 @@
 #include "types.hpp"
-#include <sstream>
 
 namespace fianchetto {
 
 std::string square_to_string(Square sq) {
     if (sq >= 64) return "??";
-    int file = file_of(sq);
-    int rank = rank_of(sq);
-    std::ostringstream oss;
-    oss << static_cast<char>('a' + file) << (rank + 1);
-    return oss.str();
+    char text[2] = {static_cast<char>('a' + file_of(sq)), static_cast<char>('1' + rank_of(sq))};
+    return std::string(text, 2);
+}
+
+size_t write_move(Move move, char* out) {
+    out[0] = static_cast<char>('a' + file_of(move.from()));
+    out[1] = static_cast<char>('1' + rank_of(move.from()));
+    out[2] = static_cast<char>('a' + file_of(move.to()));
+    out[3] = static_cast<char>('1' + rank_of(move.to()));
+    if (!move.is_promotion()) return 4;
+    out[4] = " pnbrqk"[static_cast<int>(move.promotion())];
+    return 5;
 }
 
 std::string move_to_string(Move move) {
-    std::ostringstream oss;
-    oss << square_to_string(move.from()) << square_to_string(move.to());
-    if (move.is_promotion()) {
-        char promo_chars[] = {' ', ' ', 'n', 'b', 'r', 'q', ' '};
-        oss << static_cast<char>(std::tolower(promo_chars[static_cast<int>(move.promotion())]));
-    }
-    return oss.str();
+    char text[5];
+    return std::string(text, write_move(move, text));
 }
 
-Move string_to_move(const std::string& str) {
+Move string_to_move(std::string_view str) {
     if (str.length() < 4) return Move();
     int from_file = str[0] - 'a';
     int from_rank = str[1] - '1';
@@ -1,7 +1,16 @@
+#include "analysis_cache.hpp"
 #include "board.hpp"
+#include "game_analysis.hpp"
+#include "json.hpp"
 #include "search.hpp"
 #include "movegen.hpp"
+#include "nnue.hpp"
+#include "pgn.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 
@@ -9,14 +18,69 @@
 #include "neural_client.hpp"
 #endif
 
+// UCI score: "cp <n>", or "mate <moves>" (negative when getting mated)
+static std::string uci_score(int score) {
+    if (fianchetto::is_mate_score(score)) return "mate " + std::to_string(fianchetto::mate_in_moves(score));
+    return "cp " + std::to_string(score);
+}
+
+static void print_info(int depth, int multipv, int score, uint64_t nodes, const std::vector<fianchetto::Move>& pv) {
+    std::cout << "info depth " << depth << " multipv " << multipv << " score " << uci_score(score);
+    if (nodes) std::cout << " nodes " << nodes;
+    std::cout << " pv";
+    for (fianchetto::Move move : pv) std::cout << ' ' << fianchetto::move_to_string(move);
+    std::cout << std::endl;
+}
+
 int main() {
     fianchetto::Board board;
     fianchetto::SearchParams params;
+    fianchetto::nnue::Network network;
     std::string line;
+    // The last "position" command as a start position and moves, for analysegame
+    fianchetto::Board game_start;
+    std::vector<fianchetto::Move> game_moves;
+
+    // Kept across "go" commands: re-analysing a position answers from the
+    // cache or resumes deepening from it with the table still warm. With
+    // SharedHash set, the table is a shared-memory segment that every
+    // engine process using the same name reads and writes.
+    size_t hash_mb = 16;
+    std::string shared_hash;
+    std::string hash_file; // Snapshot to warm-start from and to save to
+    auto tt = std::make_unique<fianchetto::TranspositionTable>(hash_mb);
+    auto resize_tt = [&] {
+        tt.reset();
+        if (shared_hash.empty()) {
+            tt = std::make_unique<fianchetto::TranspositionTable>(hash_mb);
+            const char* pages = tt->pages() == fianchetto::platform::PageKind::HUGETLB       ? "huge pages"
+                                : tt->pages() == fianchetto::platform::PageKind::TRANSPARENT ? "transparent huge pages"
+                                                                                             : "normal pages";
+            std::cout << "info string hash " << tt->size_mb() << " MB (" << pages << ")" << std::endl;
+            return;
+        }
+        tt = std::make_unique<fianchetto::TranspositionTable>(hash_mb, shared_hash);
+        if (tt->shared()) {
+            std::cout << "info string shared hash " << shared_hash << " ("
+                      << tt->size_mb() << " MB)" << std::endl;
+        } else {
+            std::cout << "info string cannot map shared hash " << shared_hash << ", using a private table" << std::endl;
+        }
+    };
+    fianchetto::AnalysisCache analysis_cache;
 
 #ifdef USE_NEURAL
-    fianchetto::NeuralClient neural_client;
+    // Leaves are queued to the neural service in the background; the search
+    // uses its scores once they are cached and static evaluation until then
+    fianchetto::NeuralClient neural_client(params.neural_url);
+    fianchetto::EvalCache neural_cache;
+    fianchetto::EvalPipeline neural_pipeline(
+        [&](const uint8_t* positions, size_t count, int* scores, long timeout_ms) {
+            return neural_client.evaluate_encoded(positions, count, scores, timeout_ms);
+        },
+        neural_cache);
     params.use_neural = true;
+    params.neural_pipeline = &neural_pipeline;
 #endif
 
     std::cout << "Fianchetto Engine v1.0" << std::endl;
@@ -29,13 +93,51 @@ int main() {
         if (cmd == "uci") {
             std::cout << "id name Fianchetto Engine" << std::endl;
             std::cout << "id author Fianchetto Team" << std::endl;
+            std::cout << "option name EvalFile type string default <empty>" << std::endl;
+            std::cout << "option name Hash type spin default 16 min 1 max 65536" << std::endl;
+            std::cout << "option name SharedHash type string default <empty>" << std::endl;
+            std::cout << "option name HashFile type string default <empty>" << std::endl;
+            std::cout << "option name MultiPV type spin default 1 min 1 max 256" << std::endl;
             std::cout << "uciok" << std::endl;
         }
+        else if (cmd == "setoption") {
+            // setoption name <id> value <x>
+            std::string token, name, value;
+            iss >> token >> name >> token;
+            std::getline(iss >> std::ws, value);
+
+            if (name == "EvalFile") {
+                if (value.empty() || value == "<empty>") {
+                    board.set_network(nullptr);
+                } else if (network.load(value)) {
+                    board.set_network(&network);
+                    std::cout << "info string NNUE loaded from " << value << std::endl;
+                } else {
+                    std::cout << "info string failed to load NNUE file " << value << std::endl;
+                }
+            } else if (name == "Hash") {
+                hash_mb = std::clamp(std::atol(value.c_str()), 1L, 65536L);
+                resize_tt();
+            } else if (name == "SharedHash") {
+                shared_hash = value == "<empty>" ? "" : value;
+                resize_tt();
+            } else if (name == "HashFile") {
+                hash_file = value == "<empty>" ? "" : value;
+                if (!hash_file.empty() && tt->load(hash_file)) {
+                    std::cout << "info string hash loaded from " << hash_file << " (" << tt->size_mb() << " MB)" << std::endl;
+                }
+            } else if (name == "MultiPV") {
+                params.multi_pv = static_cast<int>(std::clamp(std::atol(value.c_str()), 1L, 256L));
+            }
+        }
         else if (cmd == "isready") {
             std::cout << "readyok" << std::endl;
         }
         else if (cmd == "ucinewgame") {
             board.set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+            // Other processes may still be using a shared table, and a
+            // loaded snapshot is kept on purpose
+            if (!tt->shared() && !tt->from_snapshot()) tt->clear();
         }
         else if (cmd == "position") {
             std::string type;
@@ -43,68 +145,109 @@ int main() {
             if (type == "startpos") {
                 board.set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
             } else if (type == "fen") {
-                std::string fen;
-                std::string part;
-                for (int i = 0; i < 6 && iss >> part; i++) {
-                    if (i > 0) fen += " ";
-                    fen += part;
+                // The move counters are optional, so the FEN ends where
+                // parse_fen stops reading
+                std::string rest;
+                std::getline(iss, rest);
+                size_t consumed = 0;
+                fianchetto::FenError error = board.parse_fen(rest, &consumed);
+                if (error != fianchetto::FenError::NONE) {
+                    std::cout << "info string invalid FEN: " << fianchetto::fen_error_string(error) << std::endl;
+                    consumed = rest.size();
                 }
-                board.set_fen(fen);
+                iss.clear();
+                iss.str(rest.substr(consumed));
             }
-            
+            game_start = board;
+            game_moves.clear();
+
             std::string moves_cmd;
             if (iss >> moves_cmd && moves_cmd == "moves") {
                 std::string move_str;
                 while (iss >> move_str) {
-                    // Parse move (simplified - assumes UCI format like "e2e4")
-                    if (move_str.length() >= 4) {
-                        int from_file = move_str[0] - 'a';
-                        int from_rank = move_str[1] - '1';
-                        int to_file = move_str[2] - 'a';
-                        int to_rank = move_str[3] - '1';
-                        
-                        fianchetto::Square from = fianchetto::square(from_file, from_rank);
-                        fianchetto::Square to = fianchetto::square(to_file, to_rank);
-                        
-                        // Find matching move
-                        auto moves = fianchetto::movegen::generate_legal_moves(board);
-                        for (fianchetto::Move m : moves) {
-                            if (m.from() == from && m.to() == to) {
-                                if (move_str.length() > 4) {
-                                    // Promotion
-                                    char promo = move_str[4];
-                                    if (m.is_promotion() && 
-                                        ((promo == 'q' && m.promotion() == fianchetto::PieceType::QUEEN) ||
-                                         (promo == 'r' && m.promotion() == fianchetto::PieceType::ROOK) ||
-                                         (promo == 'b' && m.promotion() == fianchetto::PieceType::BISHOP) ||
-                                         (promo == 'n' && m.promotion() == fianchetto::PieceType::KNIGHT))) {
-                                        board.make_move(m);
-                                        break;
-                                    }
-                                } else {
-                                    board.make_move(m);
-                                    break;
-                                }
-                            }
-                        }
+                    fianchetto::Move move = fianchetto::movegen::parse_move(board, move_str);
+                    if (move == fianchetto::Move()) {
+                        std::cout << "info string illegal move " << move_str << std::endl;
+                        break;
                     }
+                    board.make_move(move);
+                    game_moves.push_back(move);
                 }
             }
         }
         else if (cmd == "go") {
+            // Limits apply to this search only; options (MultiPV, neural)
+            // carry over from params. A budget without a depth searches as
+            // deep as the budget allows.
+            auto legal = fianchetto::movegen::generate_legal_moves(board);
+            fianchetto::SearchParams go_params = params;
+            bool have_depth = false;
+            std::vector<fianchetto::Move> search_moves;
+            bool in_searchmoves = false;
             std::string subcmd;
             while (iss >> subcmd) {
                 if (subcmd == "depth") {
                     int d;
-                    if (iss >> d) params.depth = d;
+                    if (iss >> d) {
+                        go_params.depth = std::clamp(d, 1, fianchetto::MAX_PLY - 1);
+                        have_depth = true;
+                    }
                 } else if (subcmd == "movetime") {
                     int ms;
-                    if (iss >> ms) params.time_limit_ms = ms;
+                    if (iss >> ms) go_params.time_limit_ms = std::max(ms, 0);
+                } else if (subcmd == "nodes") {
+                    uint64_t n;
+                    if (iss >> n) go_params.node_limit = n;
+                } else if (subcmd == "searchmoves") {
+                    in_searchmoves = true;
+                    continue;
+                } else if (in_searchmoves) {
+                    // Moves follow searchmoves up to the next keyword
+                    auto it = std::find_if(legal.begin(), legal.end(), [&](fianchetto::Move m) {
+                        return fianchetto::move_to_string(m) == subcmd;
+                    });
+                    if (it != legal.end()) {
+                        search_moves.push_back(*it);
+                        continue;
+                    }
                 }
+                in_searchmoves = false;
+            }
+            if (!have_depth && (go_params.time_limit_ms > 0 || go_params.node_limit > 0)) {
+                go_params.depth = fianchetto::MAX_PLY - 1;
             }
+            go_params.search_moves = search_moves;
 
-            fianchetto::SearchStats stats;
-            fianchetto::Move best = fianchetto::search_root(board, params, stats);
+            // The analysis cache holds single best lines over all moves
+            bool single_line = go_params.multi_pv == 1 && search_moves.empty();
+            fianchetto::Analysis cached;
+            bool have_cached = single_line && analysis_cache.probe(board.hash(), go_params.depth, cached) &&
+                               std::find(legal.begin(), legal.end(), cached.best_move) != legal.end();
+            fianchetto::Move best = cached.best_move;
+
+            if (!have_cached || cached.depth < go_params.depth) {
+                if (have_cached) {
+                    go_params.start_depth = cached.depth + 1;
+                    fianchetto::seed_pv(board, *tt, cached.pv, cached.depth, cached.score);
+                }
+
+                fianchetto::SearchStats stats;
+                fianchetto::search_root(board, *tt, go_params, stats);
+                if (stats.best_move != fianchetto::Move() && (!have_cached || stats.depth > cached.depth)) {
+                    best = stats.best_move;
+                    uint64_t nodes = stats.nodes + stats.qnodes;
+                    for (size_t i = 0; i < stats.lines.size(); i++) {
+                        print_info(stats.depth, static_cast<int>(i + 1), stats.lines[i].score, nodes, stats.lines[i].pv);
+                    }
+                    if (single_line && !stats.lines.empty()) {
+                        analysis_cache.store(board.hash(), {best, stats.best_score, stats.depth, stats.lines.front().pv});
+                    }
+                } else if (have_cached) {
+                    print_info(cached.depth, 1, cached.score, 0, cached.pv);
+                }
+            } else {
+                print_info(cached.depth, 1, cached.score, 0, cached.pv);
+            }
 
             std::cout << "bestmove ";
             std::cout << static_cast<char>('a' + fianchetto::file_of(best.from()));
@@ -117,6 +260,118 @@ int main() {
             }
             std::cout << std::endl;
         }
+        else if (cmd == "eval") {
+            // eval [depth N] [multipv K]: one JSON line with the evaluation
+            // broken down per term and side, plus a short search of the K
+            // best lines (MultiPV by default; depth 0 skips it). Scores are
+            // from white's point of view. The search uses the session's
+            // table as "go" does, without aging it.
+            int depth = 8;
+            int multi_pv = params.multi_pv;
+            std::string token;
+            while (iss >> token) {
+                if (token == "depth") iss >> depth;
+                else if (token == "multipv") iss >> multi_pv;
+            }
+
+            fianchetto::EvalTrace trace = fianchetto::trace_evaluation(board);
+            auto sides = [](const std::vector<fianchetto::EvalTerm>& terms) {
+                fianchetto::json::ObjectWriter out;
+                for (const fianchetto::EvalTerm& term : terms) {
+                    out.add_raw(term.name, fianchetto::json::ObjectWriter()
+                                               .add("white", term.white)
+                                               .add("black", term.black)
+                                               .str());
+                }
+                return out.str();
+            };
+
+            fianchetto::json::ObjectWriter out;
+            out.add("fen", board.get_fen()).add("turn", board.side_to_move() == fianchetto::Color::WHITE ? "w" : "b");
+            out.add("classical", trace.classical);
+            if (trace.has_nnue) out.add("nnue", trace.nnue);
+            else out.add_null("nnue");
+            out.add_raw("terms", sides(trace.terms)).add_raw("features", sides(trace.features));
+
+            auto legal = fianchetto::movegen::generate_legal_moves(board);
+            if (depth > 0 && !legal.empty()) {
+                fianchetto::SearchParams eval_params = params;
+                eval_params.depth = std::min(depth, fianchetto::MAX_PLY - 1);
+                eval_params.time_limit_ms = 0;
+                eval_params.node_limit = 0;
+                eval_params.multi_pv = std::clamp(multi_pv, 1, 256);
+                fianchetto::SearchStats stats;
+                fianchetto::search_root(board, *tt, eval_params, stats);
+
+                int sign = board.side_to_move() == fianchetto::Color::WHITE ? 1 : -1;
+                std::string lines = "[";
+                for (const fianchetto::PVLine& l : stats.lines) {
+                    std::vector<std::string> pv;
+                    for (fianchetto::Move m : l.pv) pv.push_back(fianchetto::move_to_string(m));
+                    if (lines.size() > 1) lines += ',';
+                    lines += fianchetto::json::ObjectWriter().add("score", sign * l.score).add("pv", pv).str();
+                }
+                lines += "]";
+                out.add_raw("search", fianchetto::json::ObjectWriter()
+                                          .add("depth", stats.depth)
+                                          .add("score", sign * stats.best_score)
+                                          .add("bestmove", fianchetto::move_to_string(stats.best_move))
+                                          .add_raw("lines", lines)
+                                          .str());
+            } else {
+                out.add_null("search");
+            }
+            std::cout << out.str() << std::endl;
+        }
+        else if (cmd == "analysegame") {
+            // analysegame [depth N] [movetime MS] [threads T] [blunder CP]
+            // [pgn <path>]: search every position of the game set by
+            // "position" (or the first game of a PGN file), from the last
+            // move back, and print one JSON line with each move's score,
+            // best move and loss. movetime is for the whole game.
+            fianchetto::GameAnalysisOptions options;
+            options.depth = 10;
+            std::string token, pgn_path;
+            while (iss >> token) {
+                if (token == "depth") iss >> options.depth;
+                else if (token == "movetime") iss >> options.time_ms;
+                else if (token == "threads") iss >> options.threads;
+                else if (token == "blunder") iss >> options.blunder_cp;
+                else if (token == "pgn") std::getline(iss >> std::ws, pgn_path);
+            }
+
+            fianchetto::Board start = game_start;
+            std::vector<fianchetto::Move> moves = game_moves;
+            if (!pgn_path.empty()) {
+                std::ifstream in(pgn_path);
+                fianchetto::pgn::Reader reader(in);
+                fianchetto::pgn::Game game;
+                if (!in || !reader.next(game) || start.parse_fen(game.fen) != fianchetto::FenError::NONE) {
+                    std::cout << "info string cannot read a game from " << pgn_path << std::endl;
+                    continue;
+                }
+                if (!game.complete) {
+                    std::cout << "info string analysing the first " << game.moves.size() << " moves of "
+                              << pgn_path << std::endl;
+                }
+                moves = std::move(game.moves);
+            }
+
+            fianchetto::GameAnalysis analysis = fianchetto::analyse_game(start, moves, *tt, options);
+            std::cout << fianchetto::game_analysis_json(analysis) << std::endl;
+        }
+        else if (cmd == "savehash") {
+            // savehash [path]: snapshot the table (to HashFile by default)
+            std::string path;
+            if (!(iss >> path)) path = hash_file;
+            if (path.empty()) {
+                std::cout << "info string savehash needs a path or HashFile" << std::endl;
+            } else if (tt->save(path)) {
+                std::cout << "info string hash saved to " << path << std::endl;
+            } else {
+                std::cout << "info string failed to save hash to " << path << std::endl;
+            }
+        }
         else if (cmd == "stop") {
             // Stop search (simplified - would need threading for real implementation)
         }
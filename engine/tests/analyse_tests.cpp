@@ -0,0 +1,61 @@
+#include <catch2/catch.hpp>
+#include "json.hpp"
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+#include <unistd.h>
+
+// fianchetto_analyse end to end: EPD lines in, one JSON object per line out
+
+namespace {
+
+// Output lines of the labeler by input line number
+std::map<std::string, std::unordered_map<std::string, std::string>> run_analyse(const std::string& input,
+                                                                                 const std::string& args) {
+    char path[] = "/tmp/fianchetto_analyse_XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    close(fd);
+    std::ofstream(path) << input;
+
+    std::string command = std::string(FIANCHETTO_ANALYSE_PATH) + " --input " + path + " " + args;
+    FILE* pipe = popen(command.c_str(), "r");
+    REQUIRE(pipe != nullptr);
+    std::map<std::string, std::unordered_map<std::string, std::string>> results;
+    char buffer[4096];
+    while (fgets(buffer, sizeof(buffer), pipe)) {
+        std::unordered_map<std::string, std::string> fields;
+        REQUIRE(fianchetto::json::parse_object(buffer, fields));
+        results[fields["line"]] = fields;
+    }
+    REQUIRE(pclose(pipe) == 0);
+    unlink(path);
+    return results;
+}
+
+} // namespace
+
+TEST_CASE("Batch labeler writes one JSON result per EPD line", "[analyse]") {
+    auto results = run_analyse("6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - bm Ra8#; id \"back rank\";\n"
+                               "# comment\n"
+                               "7k/5QQ1/8/8/8/8/8/6K1 b - - 0 1\n"
+                               "not a position\n"
+                               "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1\n",
+                               "--depth 3 --threads 2 --hash 1 2>/dev/null");
+
+    REQUIRE(results.size() == 3);
+    auto& mate = results["1"];
+    REQUIRE(mate["id"] == "back rank");
+    REQUIRE(mate["bestmove"] == "a1a8");
+    REQUIRE(mate["mate"] == "1");
+    REQUIRE(mate["depth"] == "3");
+    REQUIRE(mate["pv"] == "[\"a1a8\"]");
+
+    auto& mated = results["3"];
+    REQUIRE(mated["bestmove"] == "null");
+    REQUIRE(mated["mate"] == "0");
+
+    REQUIRE(results["5"]["depth"] == "3");
+    REQUIRE(results.count("4") == 0);
+}
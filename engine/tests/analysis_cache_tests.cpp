@@ -0,0 +1,88 @@
+#include <catch2/catch.hpp>
+#include "analysis_cache.hpp"
+#include "search.hpp"
+
+using namespace fianchetto;
+
+namespace {
+
+const char* KIWIPETE = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+Analysis analysis_of(int depth) {
+    Analysis analysis;
+    analysis.best_move = Move(square(4, 1), square(4, 3), PieceType::PAWN);
+    analysis.depth = depth;
+    analysis.score = 10 * depth;
+    return analysis;
+}
+
+} // namespace
+
+TEST_CASE("Analysis cache keeps the deepest result", "[analysis]") {
+    AnalysisCache cache;
+    Analysis out;
+    REQUIRE_FALSE(cache.probe(1, 1, out));
+
+    cache.store(1, analysis_of(6));
+    cache.store(1, analysis_of(4)); // shallower: ignored
+    REQUIRE(cache.probe(1, 6, out));
+    REQUIRE(out.depth == 6);
+    REQUIRE(cache.probe(1, 8, out)); // still returned, as a starting point
+
+    cache.store(1, analysis_of(8));
+    REQUIRE(cache.probe(1, 8, out));
+    REQUIRE(out.score == 80);
+
+    auto stats = cache.stats();
+    REQUIRE(stats.hits == 2);
+    REQUIRE(stats.resumed == 1);
+    REQUIRE(stats.misses == 1);
+    REQUIRE(stats.entries == 1);
+}
+
+TEST_CASE("Analysis cache evicts the least recently used entry", "[analysis]") {
+    AnalysisCache cache(2);
+    Analysis out;
+    cache.store(1, analysis_of(1));
+    cache.store(2, analysis_of(1));
+    REQUIRE(cache.probe(1, 1, out)); // 2 is now the oldest
+    cache.store(3, analysis_of(1));
+    REQUIRE(cache.probe(1, 1, out));
+    REQUIRE_FALSE(cache.probe(2, 1, out));
+    REQUIRE(cache.probe(3, 1, out));
+
+    AnalysisCache disabled(0);
+    disabled.store(1, analysis_of(1));
+    REQUIRE_FALSE(disabled.probe(1, 1, out));
+}
+
+TEST_CASE("Seeded search resumes from the cached depth", "[analysis]") {
+    Board board(KIWIPETE);
+    SearchParams params;
+    params.depth = 4;
+
+    TranspositionTable tt(4);
+    SearchStats first;
+    search_root(board, tt, params, first);
+    std::vector<Move> pv = extract_pv(board, tt, first.depth);
+    REQUIRE(pv.size() >= 2);
+
+    // Seeding a fresh table restores the line
+    TranspositionTable seeded(4);
+    seed_pv(board, seeded, pv, first.depth, first.best_score);
+    REQUIRE(extract_pv(board, seeded, first.depth) == pv);
+    REQUIRE(board.hash() == Board(KIWIPETE).hash());
+
+    // Deepening from depth 5 finds the same move as a full search to 5
+    params.depth = 5;
+    params.start_depth = 5;
+    SearchStats resumed;
+    Move resumed_move = search_root(board, seeded, params, resumed);
+    REQUIRE(resumed.depth == 5);
+
+    params.start_depth = 1;
+    SearchStats full;
+    Move full_move = search_root(board, params, full);
+    REQUIRE(resumed_move == full_move);
+    REQUIRE(resumed.best_score == full.best_score);
+}
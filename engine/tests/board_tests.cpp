@@ -0,0 +1,154 @@
+#include <catch2/catch.hpp>
+#include "board.hpp"
+#include "movegen.hpp"
+
+namespace {
+
+void play(fianchetto::Board& board, const std::string& uci) {
+    for (fianchetto::Move m : fianchetto::movegen::generate_legal_moves(board)) {
+        if (fianchetto::move_to_string(m) == uci) {
+            board.make_move(m);
+            return;
+        }
+    }
+    FAIL("illegal move " << uci);
+}
+
+} // namespace
+
+TEST_CASE("Threefold repetition in game history", "[board]") {
+    fianchetto::Board board;
+    for (int i = 0; i < 2; i++) {
+        REQUIRE_FALSE(board.is_draw(0));
+        play(board, "g1f3");
+        play(board, "g8f6");
+        play(board, "f3g1");
+        play(board, "f6g8");
+    }
+    REQUIRE(board.is_draw(0));
+}
+
+TEST_CASE("Single repetition inside the search is a draw", "[board]") {
+    fianchetto::Board board;
+    play(board, "g1f3");
+    play(board, "g8f6");
+    play(board, "f3g1");
+    play(board, "f6g8");
+    REQUIRE_FALSE(board.is_draw(0));
+    REQUIRE(board.is_draw(5));
+}
+
+TEST_CASE("Fifty-move rule", "[board]") {
+    fianchetto::Board board("8/8/4k3/8/8/4K3/8/R7 w - - 100 80");
+    REQUIRE(board.is_draw(0));
+}
+
+TEST_CASE("Upcoming repetition via cuckoo tables", "[board]") {
+    fianchetto::Board board;
+    play(board, "g1f3");
+    play(board, "g8f6");
+    play(board, "f3g1");
+    // Black can return to the start position with f6g8
+    REQUIRE(board.has_game_cycle(4));
+    REQUIRE_FALSE(board.has_game_cycle(3));
+}
+
+TEST_CASE("Setting a FEN clears the repetition history", "[board]") {
+    fianchetto::Board board;
+    play(board, "g1f3");
+    play(board, "g8f6");
+    play(board, "f3g1");
+    board.set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 4 3");
+    REQUIRE_FALSE(board.has_game_cycle(4));
+}
+
+TEST_CASE("FEN round-trips through the buffer writer", "[board]") {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 3 12",
+        "r3k2r/8/8/3pP3/8/8/8/4K2R w Kkq d6 5 30",
+        "4k3/8/8/8/8/8/8/4K3 b - - 99 200",
+    };
+    fianchetto::Board board;
+    char buffer[fianchetto::FEN_BUFFER_SIZE];
+    for (const char* fen : fens) {
+        REQUIRE(board.parse_fen(fen) == fianchetto::FenError::NONE);
+        size_t length = board.write_fen(buffer, sizeof(buffer));
+        REQUIRE(std::string(buffer, length) == fen);
+        REQUIRE(board.get_fen() == fen);
+    }
+
+    // Too small a buffer is refused rather than truncated
+    REQUIRE(board.write_fen(buffer, 10) == 0);
+    REQUIRE(board.write_fen(buffer, sizeof(buffer), false) == std::string("4k3/8/8/8/8/8/8/4K3 b - -").size());
+}
+
+TEST_CASE("Invalid FENs are rejected and leave the board unchanged", "[board]") {
+    using fianchetto::FenError;
+    const std::pair<const char*, FenError> cases[] = {
+        {"", FenError::PLACEMENT},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1", FenError::PLACEMENT},
+        {"rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", FenError::PLACEMENT},
+        {"rnbqkbnr/ppppxppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", FenError::PLACEMENT},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNRR w KQkq - 0 1", FenError::PLACEMENT},
+        {"8/8/8/8/8/8/8/8 w - - 0 1", FenError::KINGS},
+        {"4k3/8/8/8/8/8/8/3KK3 w - - 0 1", FenError::KINGS},
+        {"4k2P/8/8/8/8/8/8/4K3 w - - 0 1", FenError::PAWN_RANK},
+        {"4k3/8/8/8/8/8/8/4K3 x - - 0 1", FenError::SIDE},
+        {"4k3/8/8/8/8/8/8/4K3", FenError::SIDE},
+        {"4k3/8/8/8/8/8/8/4K3 w KK - 0 1", FenError::CASTLING},
+        {"4k3/8/8/8/8/8/8/4K3 w X - 0 1", FenError::CASTLING},
+        {"4k3/8/8/8/8/8/8/4K3 w - e3 0 1", FenError::EN_PASSANT},
+        {"4k3/8/8/8/8/8/8/4K3 w - - 12 x", FenError::CLOCKS},
+        {"4k3/8/8/8/8/8/8/4K3 w - - 5", FenError::CLOCKS},
+    };
+    fianchetto::Board board;
+    uint64_t hash = board.hash();
+    for (const auto& [fen, error] : cases) {
+        INFO(fen);
+        REQUIRE(board.parse_fen(fen) == error);
+        REQUIRE(board.hash() == hash);
+    }
+}
+
+TEST_CASE("FEN move counters are optional", "[board]") {
+    fianchetto::Board board;
+    size_t consumed = 0;
+    std::string text = "4k3/8/8/8/8/8/8/4K2R w KQ - moves e1g1";
+    REQUIRE(board.parse_fen(text, &consumed) == fianchetto::FenError::NONE);
+    REQUIRE(text.substr(consumed) == " moves e1g1");
+    REQUIRE(board.halfmove_clock() == 0);
+    REQUIRE(board.fullmove_number() == 1);
+    // The queenside right has no rook on a1 and is dropped
+    REQUIRE(board.can_castle_kingside(fianchetto::Color::WHITE));
+    REQUIRE_FALSE(board.can_castle_queenside(fianchetto::Color::WHITE));
+
+    REQUIRE(board.parse_fen("4k3/8/8/8/8/8/8/4K3 b - - 7 42", &consumed) == fianchetto::FenError::NONE);
+    REQUIRE(consumed == std::string("4k3/8/8/8/8/8/8/4K3 b - - 7 42").size());
+    REQUIRE(board.halfmove_clock() == 7);
+    REQUIRE(board.fullmove_number() == 42);
+}
+
+TEST_CASE("UCI moves are parsed against the legal moves", "[board]") {
+    using fianchetto::movegen::parse_move;
+    fianchetto::Board board;
+    board.set_fen("r3k2r/1P6/8/8/8/8/8/R3K2R w KQkq - 0 1");
+
+    fianchetto::Move castle = parse_move(board, "e1g1");
+    REQUIRE(castle != fianchetto::Move());
+    REQUIRE(castle.is_castling());
+    REQUIRE(parse_move(board, "b7a8n").promotion() == fianchetto::PieceType::KNIGHT);
+    REQUIRE(fianchetto::move_to_string(parse_move(board, "b7b8q")) == "b7b8q");
+
+    REQUIRE(parse_move(board, "b7b8") == fianchetto::Move());  // Promotion piece missing
+    REQUIRE(parse_move(board, "b7b8k") == fianchetto::Move());
+    REQUIRE(parse_move(board, "e1e3") == fianchetto::Move());  // Not a king move
+    REQUIRE(parse_move(board, "a8a7") == fianchetto::Move());  // Black's rook
+    REQUIRE(parse_move(board, "i1a1") == fianchetto::Move());
+    REQUIRE(parse_move(board, "e1") == fianchetto::Move());
+
+    // Pseudo-legal but leaves the king in check
+    board.set_fen("4k3/8/8/8/8/8/4r3/3K4 w - - 0 1");
+    REQUIRE(parse_move(board, "d1e1") == fianchetto::Move());
+    REQUIRE(parse_move(board, "d1e2") != fianchetto::Move());
+}
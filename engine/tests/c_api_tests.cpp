@@ -0,0 +1,136 @@
+#include <catch2/catch.hpp>
+#include "fianchetto.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace {
+
+struct Report {
+    std::atomic<int> progress{0};
+    std::atomic<int> done{0};
+    int depth = 0;
+    uint64_t nodes = 0;
+    std::string bestmove;
+    std::string pv;
+};
+
+void on_progress(const fianchetto_info*, void* user_data) {
+    static_cast<Report*>(user_data)->progress++;
+}
+
+void on_done(const fianchetto_info* info, void* user_data) {
+    Report* report = static_cast<Report*>(user_data);
+    report->depth = info->depth;
+    report->nodes = info->nodes;
+    report->bestmove = info->bestmove;
+    report->pv = info->pv;
+    report->done++;
+}
+
+} // namespace
+
+TEST_CASE("C API sets positions and rejects bad input", "[c_api]") {
+    REQUIRE(fianchetto_api_version() == FIANCHETTO_API_VERSION);
+    fianchetto_engine* engine = fianchetto_create(1);
+    REQUIRE(engine != nullptr);
+
+    char fen[128];
+    REQUIRE(fianchetto_set_position(engine, "startpos", "e2e4 e7e5 g1f3") == FIANCHETTO_OK);
+    REQUIRE(fianchetto_get_fen(engine, fen, sizeof(fen)) == FIANCHETTO_OK);
+    REQUIRE(std::string(fen) == "rnbqkbnr/pppp1ppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 1 2");
+
+    // Failures leave the position as it was
+    REQUIRE(fianchetto_set_position(engine, "8/8/8/8/8/8/8/8 w - - 0 1", nullptr) == FIANCHETTO_INVALID_POSITION);
+    REQUIRE(fianchetto_set_position(engine, nullptr, "e2e4 e2e4") == FIANCHETTO_ILLEGAL_MOVE);
+    REQUIRE(fianchetto_get_fen(engine, fen, sizeof(fen)) == FIANCHETTO_OK);
+    REQUIRE(std::string(fen) == "rnbqkbnr/pppp1ppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 1 2");
+    REQUIRE(fianchetto_get_fen(engine, fen, 8) == FIANCHETTO_INVALID_ARGUMENT);
+
+    REQUIRE(fianchetto_set_position(engine, "4k3/8/8/8/8/8/4p3/4K3 w - - 0 1", "e1e2") == FIANCHETTO_OK);
+    REQUIRE(fianchetto_set_position(nullptr, nullptr, nullptr) == FIANCHETTO_INVALID_ARGUMENT);
+    fianchetto_destroy(engine);
+}
+
+TEST_CASE("C API searches asynchronously with callbacks", "[c_api]") {
+    fianchetto_engine* engine = fianchetto_create(4);
+    REQUIRE(fianchetto_set_position(engine, "6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1", nullptr) == FIANCHETTO_OK);
+
+    Report report;
+    fianchetto_limits limits = {};
+    limits.depth = 4;
+    REQUIRE(fianchetto_search(engine, &limits, on_progress, on_done, &report) == FIANCHETTO_OK);
+    fianchetto_wait(engine);
+
+    REQUIRE(report.done == 1);
+    REQUIRE(report.progress == 4);
+    REQUIRE(report.depth == 4);
+    REQUIRE(report.bestmove == "a1a8");
+    REQUIRE(report.pv.rfind("a1a8", 0) == 0);
+
+    fianchetto_stats stats;
+    REQUIRE(fianchetto_get_stats(engine, &stats) == FIANCHETTO_OK);
+    REQUIRE(stats.searches == 1);
+    REQUIRE(stats.nodes > 0);
+    REQUIRE(stats.searching == 0);
+    fianchetto_destroy(engine);
+}
+
+TEST_CASE("C API searches can be stopped and handles are independent", "[c_api]") {
+    fianchetto_engine* first = fianchetto_create(4);
+    fianchetto_engine* second = fianchetto_create(4);
+    Report long_report, short_report;
+
+    fianchetto_limits unlimited = {};
+    unlimited.movetime_ms = 60000;
+    REQUIRE(fianchetto_search(first, &unlimited, nullptr, on_done, &long_report) == FIANCHETTO_OK);
+    REQUIRE(fianchetto_search(first, &unlimited, nullptr, on_done, &long_report) == FIANCHETTO_BUSY);
+    REQUIRE(fianchetto_set_position(first, "startpos", nullptr) == FIANCHETTO_BUSY);
+    REQUIRE(fianchetto_clear_hash(first) == FIANCHETTO_BUSY);
+
+    // Another handle searches meanwhile
+    fianchetto_limits shallow = {};
+    shallow.depth = 3;
+    REQUIRE(fianchetto_search(second, &shallow, nullptr, on_done, &short_report) == FIANCHETTO_OK);
+    fianchetto_wait(second);
+    REQUIRE(short_report.done == 1);
+    REQUIRE(!short_report.bestmove.empty());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto start = std::chrono::steady_clock::now();
+    fianchetto_stop(first);
+    fianchetto_wait(first);
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+    REQUIRE(long_report.done == 1);
+    REQUIRE(long_report.bestmove.size() == 4);
+
+    // Destroying a handle mid-search stops it and still reports
+    Report destroyed;
+    REQUIRE(fianchetto_search(second, &unlimited, nullptr, on_done, &destroyed) == FIANCHETTO_OK);
+    fianchetto_destroy(second);
+    REQUIRE(destroyed.done == 1);
+    fianchetto_destroy(first);
+}
+
+TEST_CASE("C API keeps the handle's table between searches", "[c_api]") {
+    fianchetto_engine* engine = fianchetto_create(16);
+    REQUIRE(fianchetto_set_position(engine, "startpos", "e2e4 e7e5 g1f3 b8c6") == FIANCHETTO_OK);
+    fianchetto_limits limits = {};
+    limits.depth = 6;
+
+    auto search = [&] {
+        Report report;
+        REQUIRE(fianchetto_search(engine, &limits, nullptr, on_done, &report) == FIANCHETTO_OK);
+        fianchetto_wait(engine);
+        REQUIRE(report.done == 1);
+        return report.nodes;
+    };
+    uint64_t cold = search();
+    REQUIRE(search() < cold);
+
+    // Until the table is cleared
+    REQUIRE(fianchetto_clear_hash(engine) == FIANCHETTO_OK);
+    REQUIRE(search() == cold);
+    fianchetto_destroy(engine);
+}
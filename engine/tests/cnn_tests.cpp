@@ -0,0 +1,139 @@
+#include <catch2/catch.hpp>
+#include "board.hpp"
+#include "cnn_eval.hpp"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+namespace {
+
+struct RawWeights {
+    int hidden;
+    std::vector<std::vector<float>> tensors; // state_dict order
+};
+
+RawWeights random_weights(int hidden, uint32_t seed) {
+    using namespace fianchetto::cnn;
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> dist(0.0f, 0.1f);
+    std::vector<size_t> sizes = {
+        CONV1 * PLANES * 9, CONV1, CONV2 * CONV1 * 9, CONV2, CONV3 * CONV2 * 9, CONV3,
+        static_cast<size_t>(hidden) * CONV3 * 64, static_cast<size_t>(hidden),
+        static_cast<size_t>(hidden) * hidden, static_cast<size_t>(hidden),
+        static_cast<size_t>(hidden), 1};
+    RawWeights w{hidden, {}};
+    for (size_t size : sizes) {
+        std::vector<float> t(size);
+        for (float& v : t) v = dist(rng);
+        w.tensors.push_back(std::move(t));
+    }
+    return w;
+}
+
+void write_weights(const RawWeights& w, const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    out.write(fianchetto::cnn::FILE_MAGIC, 4);
+    uint32_t header[2] = {fianchetto::cnn::FILE_VERSION, static_cast<uint32_t>(w.hidden)};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (const auto& t : w.tensors) {
+        out.write(reinterpret_cast<const char*>(t.data()), t.size() * sizeof(float));
+    }
+}
+
+// Straightforward NCHW forward pass mirroring ChessEvalModel.forward
+float reference_forward(const RawWeights& w, const fianchetto::Board& board) {
+    std::vector<float> x(fianchetto::cnn::PLANES * 64);
+    fianchetto::cnn::encode_planes(board, x.data());
+
+    auto conv = [](const std::vector<float>& in, int cin, const std::vector<float>& weight,
+                   const std::vector<float>& bias, int cout) {
+        std::vector<float> out(cout * 64);
+        for (int o = 0; o < cout; o++) {
+            for (int y = 0; y < 8; y++) {
+                for (int xx = 0; xx < 8; xx++) {
+                    float sum = bias[o];
+                    for (int c = 0; c < cin; c++) {
+                        for (int ky = 0; ky < 3; ky++) {
+                            for (int kx = 0; kx < 3; kx++) {
+                                int sy = y + ky - 1, sx = xx + kx - 1;
+                                if (sy < 0 || sy > 7 || sx < 0 || sx > 7) continue;
+                                sum += weight[((o * cin + c) * 3 + ky) * 3 + kx] * in[c * 64 + sy * 8 + sx];
+                            }
+                        }
+                    }
+                    out[o * 64 + y * 8 + xx] = std::max(sum, 0.0f);
+                }
+            }
+        }
+        return out;
+    };
+    auto linear = [](const std::vector<float>& in, const std::vector<float>& weight,
+                     const std::vector<float>& bias, bool relu) {
+        std::vector<float> out(bias.size());
+        for (size_t o = 0; o < bias.size(); o++) {
+            float sum = bias[o];
+            for (size_t i = 0; i < in.size(); i++) sum += weight[o * in.size() + i] * in[i];
+            out[o] = relu ? std::max(sum, 0.0f) : sum;
+        }
+        return out;
+    };
+
+    using namespace fianchetto::cnn;
+    const auto& t = w.tensors;
+    x = conv(x, PLANES, t[0], t[1], CONV1);
+    x = conv(x, CONV1, t[2], t[3], CONV2);
+    x = conv(x, CONV2, t[4], t[5], CONV3);
+    x = linear(x, t[6], t[7], true);
+    x = linear(x, t[8], t[9], true);
+    x = linear(x, t[10], t[11], false);
+    return x[0];
+}
+
+} // namespace
+
+TEST_CASE("CNN plane encoding matches encode.py layout", "[cnn]") {
+    fianchetto::Board board;
+    std::vector<float> planes(fianchetto::cnn::PLANES * 64);
+    fianchetto::cnn::encode_planes(board, planes.data());
+    REQUIRE(planes[0 * 64 + 6 * 8 + 4] == 1.0f);  // White pawn e2
+    REQUIRE(planes[5 * 64 + 7 * 8 + 4] == 1.0f);  // White king e1
+    REQUIRE(planes[11 * 64 + 0 * 8 + 4] == 1.0f); // Black king e8
+    float total = 0.0f;
+    for (float v : planes) total += v;
+    REQUIRE(total == 32.0f);
+}
+
+TEST_CASE("CNN batched inference matches reference forward pass", "[cnn]") {
+    RawWeights weights = random_weights(32, 5);
+    std::string path = "cnn_test_weights.bin";
+    write_weights(weights, path);
+
+    fianchetto::cnn::Model model;
+    REQUIRE(model.load(path));
+    std::remove(path.c_str());
+
+    std::vector<fianchetto::Board> boards = {
+        fianchetto::Board(),
+        fianchetto::Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+        fianchetto::Board("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"),
+        fianchetto::Board("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"),
+        fianchetto::Board("6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1"),
+    };
+    std::vector<const fianchetto::Board*> batch;
+    for (const auto& b : boards) batch.push_back(&b);
+
+    std::vector<int> scores = model.evaluate(batch);
+    REQUIRE(scores.size() == boards.size());
+    for (size_t i = 0; i < boards.size(); i++) {
+        float expected = reference_forward(weights, boards[i]) * 100.0f;
+        REQUIRE(std::abs(scores[i] - expected) <= 1.0f);
+        REQUIRE(model.evaluate(boards[i]) == scores[i]);
+    }
+}
+
+TEST_CASE("CNN rejects missing weight files", "[cnn]") {
+    fianchetto::cnn::Model model;
+    REQUIRE_FALSE(model.load("does_not_exist.bin"));
+    REQUIRE_FALSE(model.loaded());
+}
@@ -0,0 +1,65 @@
+#include <catch2/catch.hpp>
+#include "epd.hpp"
+#include "movegen.hpp"
+
+using namespace fianchetto;
+
+TEST_CASE("EPD operations are parsed in place", "[epd]") {
+    std::string line = "r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - "
+                       "bm Qxf7#; am Qxe5+ Nf3; id \"scholar; mate\"; c0 \"four moves\"; hmvc 4;";
+    Board board;
+    epd::Record record;
+    REQUIRE(epd::parse(line, board, record) == FenError::NONE);
+
+    REQUIRE(record.operation_count == 5);
+    REQUIRE(record.best_move_count == 1);
+    REQUIRE(move_to_string(record.best_moves[0]) == "h5f7");
+    REQUIRE(record.avoid_move_count == 2);
+    REQUIRE(move_to_string(record.avoid_moves[0]) == "h5e5");
+    REQUIRE(move_to_string(record.avoid_moves[1]) == "g1f3");
+    REQUIRE(record.id == "scholar; mate");
+    REQUIRE(record.comment == "four moves");
+    REQUIRE(record.find("hmvc")->operand == "4");
+    REQUIRE(record.find("dm") == nullptr);
+    REQUIRE(board.halfmove_clock() == 4);
+    REQUIRE(board.fullmove_number() == 1);
+
+    // Views point into the line rather than into copies
+    REQUIRE(record.id.data() >= line.data());
+    REQUIRE(record.id.data() < line.data() + line.size());
+}
+
+TEST_CASE("EPD records are written back into a buffer", "[epd]") {
+    std::string line = "4k3/8/8/8/8/8/8/4K2R w K - bm Rh8+; id \"rook\";";
+    Board board;
+    epd::Record record;
+    REQUIRE(epd::parse(line, board, record) == FenError::NONE);
+
+    char buffer[256];
+    size_t length = epd::write(board, record, buffer, sizeof(buffer));
+    REQUIRE(std::string(buffer, length) == line);
+    REQUIRE(epd::write(board, record, buffer, 30) == 0);
+
+    // A record built by hand, e.g. to store a search result
+    epd::Record result;
+    REQUIRE(result.add("bm", "Kd2"));
+    REQUIRE(result.add("c0", "depth 12"));
+    result.add("noop", "");
+    length = epd::write(board, result, buffer, sizeof(buffer));
+    REQUIRE(std::string(buffer, length) == "4k3/8/8/8/8/8/8/4K2R w K - bm Kd2; c0 \"depth 12\"; noop;");
+}
+
+TEST_CASE("Malformed EPD lines are rejected", "[epd]") {
+    Board board;
+    epd::Record record;
+    REQUIRE(epd::parse("4k3/8/8/8/8/8/8/4K3 w - - id \"open", board, record) == FenError::OPERATION);
+    REQUIRE(epd::parse("4k3/8/8/8/8/8/8/4K3 w - - ; id \"x\";", board, record) == FenError::OPERATION);
+    REQUIRE(epd::parse("4k3/8/8/8/8/8/8/4K3 w - - bm Qh5;", board, record) == FenError::MOVE);
+    REQUIRE(epd::parse("4k3/8/8/8/8/8/8/4K3 w - - hmvc x;", board, record) == FenError::CLOCKS);
+    REQUIRE(epd::parse("4k3/8/8/8/8/8/8/4K3 q - - bm Kd2;", board, record) == FenError::SIDE);
+
+    // A full FEN is an EPD line without operations
+    REQUIRE(epd::parse("4k3/8/8/8/8/8/8/4K3 w - - 3 9", board, record) == FenError::NONE);
+    REQUIRE(record.operation_count == 0);
+    REQUIRE(board.fullmove_number() == 9);
+}
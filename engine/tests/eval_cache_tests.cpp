@@ -0,0 +1,90 @@
+#include <catch2/catch.hpp>
+#include "eval_cache.hpp"
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace fianchetto;
+
+TEST_CASE("Eval cache stores and probes scores", "[eval_cache]") {
+    EvalCache cache(1);
+    int score = 0;
+
+    REQUIRE_FALSE(cache.probe(0x1234, score));
+    cache.store(0x1234, -250);
+    REQUIRE(cache.probe(0x1234, score));
+    REQUIRE(score == -250);
+
+    // Hash 0 must not match an empty slot
+    REQUIRE_FALSE(cache.probe(0, score));
+    cache.store(0, 17);
+    REQUIRE(cache.probe(0, score));
+    REQUIRE(score == 17);
+
+    // Overwriting a key does not take another slot
+    cache.store(0x1234, 40);
+    REQUIRE(cache.probe(0x1234, score));
+    REQUIRE(score == 40);
+
+    EvalCacheStats stats = cache.stats();
+    REQUIRE(stats.entries == 2);
+    REQUIRE(stats.hits == 3);
+    REQUIRE(stats.misses == 2);
+
+    cache.clear();
+    REQUIRE_FALSE(cache.probe(0x1234, score));
+    REQUIRE(cache.stats().entries == 0);
+}
+
+TEST_CASE("Eval cache stays bounded", "[eval_cache]") {
+    EvalCache cache(1);
+    uint64_t capacity = cache.stats().capacity;
+    REQUIRE(capacity * 16 <= 1024 * 1024);
+
+    std::mt19937_64 rng(7);
+    std::vector<uint64_t> keys(capacity * 4);
+    for (auto& key : keys) {
+        key = rng();
+        cache.store(key, static_cast<int>(key & 0xFFFF));
+    }
+
+    EvalCacheStats stats = cache.stats();
+    REQUIRE(stats.entries <= stats.capacity);
+    REQUIRE(stats.occupancy() > 0.9);
+
+    // The most recent stores survive replacement and every hit is correct
+    int recent_hits = 0;
+    for (size_t i = keys.size() - 1000; i < keys.size(); i++) {
+        int score;
+        if (cache.probe(keys[i], score)) {
+            REQUIRE(score == static_cast<int>(keys[i] & 0xFFFF));
+            recent_hits++;
+        }
+    }
+    REQUIRE(recent_hits > 900);
+}
+
+TEST_CASE("Eval cache is consistent under concurrent access", "[eval_cache]") {
+    EvalCache cache(1);
+    std::vector<std::thread> threads;
+    std::atomic<int> bad{0};
+
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t] {
+            std::mt19937_64 rng(t);
+            for (int i = 0; i < 200000; i++) {
+                uint64_t key = rng() % 50000 * 0x9E3779B97F4A7C15ULL;
+                int score;
+                if (cache.probe(key, score)) {
+                    if (score != static_cast<int>(key >> 48)) bad++;
+                } else {
+                    cache.store(key, static_cast<int>(key >> 48));
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    REQUIRE(bad == 0);
+    REQUIRE(cache.stats().hit_rate() > 0.5);
+}
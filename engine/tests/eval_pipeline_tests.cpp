@@ -0,0 +1,203 @@
+#include <catch2/catch.hpp>
+#include "board.hpp"
+#include "eval_pipeline.hpp"
+#include "search.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace fianchetto;
+
+namespace {
+
+// Fake backend: score = number of white pieces minus black pieces, decoded
+// from the binary encoding
+int score_encoded(const uint8_t* position) {
+    int score = 0;
+    for (int bb = 0; bb < 12; bb++) {
+        for (int i = 0; i < 8; i++) {
+            int bits = __builtin_popcount(position[bb * 8 + i]);
+            score += bb < 6 ? bits : -bits;
+        }
+    }
+    return score;
+}
+
+} // namespace
+
+TEST_CASE("Binary position encoding", "[pipeline]") {
+    Board board("4k3/8/8/8/8/8/4P3/4K2R b K - 0 1");
+    uint8_t data[BINARY_POSITION_SIZE];
+    encode_binary_position(board, data);
+
+    // White pawn on e2 (square 12): bitboard 0, byte 1, bit 4
+    REQUIRE(data[1] == (1 << 4));
+    // Black king on e8 (square 60): bitboard 11, byte 7, bit 4
+    REQUIRE(data[11 * 8 + 7] == (1 << 4));
+    // Black to move, white may castle kingside
+    REQUIRE(data[96] == (1 | (1 << 1)));
+}
+
+TEST_CASE("Binary position records match the service's 97-byte format", "[pipeline]") {
+    // Start position, byte for byte: per bitboard, byte r holds rank r + 1
+    // with bit f for file f (the layout neural/src/api.py decode_positions
+    // reads)
+    const uint8_t expected[BINARY_POSITION_SIZE] = {
+        0, 0xFF, 0, 0, 0, 0, 0, 0,    // white pawns
+        0x42, 0, 0, 0, 0, 0, 0, 0,    // white knights b1 g1
+        0x24, 0, 0, 0, 0, 0, 0, 0,    // white bishops c1 f1
+        0x81, 0, 0, 0, 0, 0, 0, 0,    // white rooks a1 h1
+        0x08, 0, 0, 0, 0, 0, 0, 0,    // white queen d1
+        0x10, 0, 0, 0, 0, 0, 0, 0,    // white king e1
+        0, 0, 0, 0, 0, 0, 0xFF, 0,    // black pawns
+        0, 0, 0, 0, 0, 0, 0, 0x42,    // black knights
+        0, 0, 0, 0, 0, 0, 0, 0x24,    // black bishops
+        0, 0, 0, 0, 0, 0, 0, 0x81,    // black rooks
+        0, 0, 0, 0, 0, 0, 0, 0x08,    // black queen
+        0, 0, 0, 0, 0, 0, 0, 0x10,    // black king
+        0x1E,                          // white to move, all four castling rights
+    };
+    Board board("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    uint8_t data[BINARY_POSITION_SIZE];
+    encode_binary_position(board, data);
+    for (size_t i = 0; i < BINARY_POSITION_SIZE; i++) {
+        INFO("byte " << i);
+        REQUIRE(data[i] == expected[i]);
+    }
+
+    // Decoding as the service does gives back every piece of the position
+    board.set_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b Kq - 0 1");
+    encode_binary_position(board, data);
+    for (int sq = 0; sq < 64; sq++) {
+        int found = -1;
+        for (int plane = 0; plane < 12; plane++) {
+            if (data[plane * 8 + sq / 8] & (1 << (sq % 8))) {
+                REQUIRE(found == -1);
+                found = plane;
+            }
+        }
+        PieceType piece = board.piece_on(static_cast<Square>(sq));
+        if (piece == PieceType::NONE) {
+            REQUIRE(found == -1);
+        } else {
+            int color = (board.all_pieces(Color::BLACK) >> sq) & 1;
+            REQUIRE(found == color * 6 + static_cast<int>(piece) - 1);
+        }
+    }
+    REQUIRE(data[96] == (1 | (1 << 1) | (1 << 4)));
+}
+
+TEST_CASE("Pipeline batches requests and completes futures", "[pipeline]") {
+    EvalCache cache(1);
+    std::atomic<int> calls{0};
+    EvalPipeline pipeline(
+        [&](const uint8_t* positions, size_t count, int* scores, long) {
+            calls++;
+            for (size_t i = 0; i < count; i++) {
+                scores[i] = score_encoded(positions + i * BINARY_POSITION_SIZE);
+            }
+            return true;
+        },
+        cache, 64, 4096, 20000);
+
+    Board a("4k3/8/8/8/8/8/4P3/4K2R w K - 0 1");
+    Board b("rnbqkbnr/pppppppp/8/8/8/8/8/4K3 w kq - 0 1");
+    std::future<int> fa = pipeline.submit(a);
+    std::future<int> fb = pipeline.submit(b);
+    REQUIRE(fa.get() == 2);
+    REQUIRE(fb.get() == -15);
+    REQUIRE(calls == 1);
+
+    // Results are cached; a second submit completes immediately
+    int score;
+    REQUIRE(pipeline.probe(a, score));
+    REQUIRE(score == 2);
+    REQUIRE(pipeline.submit(b).get() == -15);
+    REQUIRE(calls == 1);
+    REQUIRE(pipeline.stats().evaluated == 2);
+}
+
+TEST_CASE("Pipeline prefetch fills the cache without blocking", "[pipeline]") {
+    EvalCache cache(1);
+    EvalPipeline pipeline(
+        [&](const uint8_t*, size_t count, int* scores, long) {
+            for (size_t i = 0; i < count; i++) scores[i] = 42;
+            return true;
+        },
+        cache);
+
+    Board board;
+    pipeline.prefetch(board);
+    pipeline.prefetch(board); // already in flight or cached
+
+    int score = 0;
+    for (int i = 0; i < 1000 && !pipeline.probe(board, score); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(score == 42);
+    REQUIRE(pipeline.stats().submitted == 1);
+}
+
+TEST_CASE("Pipeline failures fall back to classical eval and are not cached", "[pipeline]") {
+    EvalCache cache(1);
+    EvalPipeline pipeline([](const uint8_t*, size_t, int*, long) { return false; }, cache);
+
+    // Black to move, white a queen up: fallback is from white's perspective
+    Board board("4k3/8/8/8/8/8/8/3QK3 b - - 0 1");
+    int expected = -evaluate(board);
+    REQUIRE(expected > 800);
+    REQUIRE(pipeline.submit(board).get() == expected);
+    int score;
+    REQUIRE_FALSE(pipeline.probe(board, score));
+    REQUIRE(pipeline.stats().failures == 1);
+}
+
+TEST_CASE("Pipeline discards requests past their deadline", "[pipeline]") {
+    EvalCache cache(1);
+    std::atomic<int> calls{0};
+    std::vector<long> timeouts;
+    EvalPipeline pipeline(
+        [&](const uint8_t*, size_t count, int* scores, long timeout_ms) {
+            calls++;
+            timeouts.push_back(timeout_ms);
+            for (size_t i = 0; i < count; i++) scores[i] = 1;
+            return true;
+        },
+        cache);
+
+    Board board("4k3/8/8/8/8/8/8/3QK3 w - - 0 1");
+    auto past = EvalPipeline::Clock::now() - std::chrono::milliseconds(1);
+    REQUIRE(pipeline.submit(board, past).get() == evaluate(board));
+    REQUIRE(pipeline.stats().expired == 1);
+    REQUIRE(calls == 0);
+
+    // A future deadline bounds the backend's timeout
+    auto soon = EvalPipeline::Clock::now() + std::chrono::seconds(5);
+    REQUIRE(pipeline.submit(board, soon).get() == 1);
+    REQUIRE(calls == 1);
+    REQUIRE(timeouts[0] > 0);
+    REQUIRE(timeouts[0] <= 5000);
+}
+
+TEST_CASE("Search queues leaves to the pipeline", "[pipeline][search]") {
+    EvalCache cache(1);
+    EvalPipeline pipeline(
+        [&](const uint8_t* positions, size_t count, int* scores, long) {
+            for (size_t i = 0; i < count; i++) {
+                scores[i] = score_encoded(positions + i * BINARY_POSITION_SIZE) * 100;
+            }
+            return true;
+        },
+        cache);
+
+    Board board("6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1");
+    SearchParams params;
+    params.depth = 3;
+    params.use_neural = true;
+    params.neural_pipeline = &pipeline;
+    SearchStats stats;
+    Move best = search_root(board, params, stats);
+
+    REQUIRE(move_to_string(best) == "a1a8");
+    REQUIRE(pipeline.stats().submitted > 0);
+}
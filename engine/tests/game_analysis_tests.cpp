@@ -0,0 +1,118 @@
+#include <catch2/catch.hpp>
+#include "game_analysis.hpp"
+#include "movegen.hpp"
+#include "search.hpp"
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace fianchetto;
+
+namespace {
+
+// 1.e4 e5 2.Bc4 Nc6 3.Qh5 Nf6?? 4.Qxf7#
+std::vector<Move> scholars_mate(const Board& start) {
+    Board board = start;
+    std::vector<Move> moves;
+    for (const char* uci : {"e2e4", "e7e5", "f1c4", "b8c6", "d1h5", "g8f6", "h5f7"}) {
+        Move move = movegen::parse_move(board, uci);
+        REQUIRE(move != Move());
+        board.make_move(move);
+        moves.push_back(move);
+    }
+    return moves;
+}
+
+} // namespace
+
+TEST_CASE("Game analysis flags the blunder and scores the final position", "[game_analysis]") {
+    Board start;
+    std::vector<Move> moves = scholars_mate(start);
+    TranspositionTable tt(16);
+
+    GameAnalysisOptions options;
+    options.depth = 4;
+    options.threads = GENERATE(1, 2);
+    GameAnalysis analysis = analyse_game(start, moves, tt, options);
+
+    REQUIRE(analysis.plies.size() == moves.size());
+    REQUIRE(analysis.final_score == SCORE_MATE);
+    REQUIRE(analysis.nodes > 0);
+
+    const PlyAnalysis& knight = analysis.plies[5];
+    REQUIRE(knight.played == moves[5]);
+    REQUIRE(knight.blunder);
+    REQUIRE(knight.loss >= 500);
+
+    const PlyAnalysis& mate = analysis.plies[6];
+    REQUIRE(move_to_string(mate.best_move) == "h5f7");
+    REQUIRE(mate.loss == 0);
+    REQUIRE(mate.score >= SCORE_MATE - MAX_PLY);
+    for (size_t i = 0; i < 5; i++) REQUIRE_FALSE(analysis.plies[i].blunder);
+}
+
+TEST_CASE("Game analysis keeps the table's earlier entries", "[game_analysis]") {
+    // A session's (or a shared or snapshot) table is searched into, not aged
+    Board start;
+    std::vector<Move> moves = scholars_mate(start);
+    TranspositionTable tt(16);
+    const uint64_t earlier = 0x0123456789ABCDEFULL;
+    tt.store(earlier, 30, 123, Move(), TT_EXACT);
+
+    GameAnalysisOptions options;
+    options.depth = 3;
+    analyse_game(start, moves, tt, options);
+
+    TTEntry entry;
+    REQUIRE(tt.probe(earlier, entry));
+    REQUIRE(entry.score == 123);
+}
+
+TEST_CASE("Game analysis stays inside its time budget", "[game_analysis]") {
+    Board start;
+    std::vector<Move> moves = scholars_mate(start);
+    TranspositionTable tt(16);
+
+    GameAnalysisOptions options;
+    options.depth = MAX_PLY - 1;
+    options.time_ms = 300;
+    options.threads = 2;
+    GameAnalysis analysis = analyse_game(start, moves, tt, options);
+
+    REQUIRE(analysis.plies.size() == moves.size());
+    REQUIRE(analysis.time_ms < 2000);
+    for (const PlyAnalysis& ply : analysis.plies) REQUIRE(ply.best_move != Move());
+
+    // A stop request ends every remaining search at once
+    std::atomic<bool> stop{true};
+    options.time_ms = 0;
+    analysis = analyse_game(start, moves, tt, options, &stop);
+    REQUIRE(analysis.plies.size() == moves.size());
+    REQUIRE(analysis.time_ms < 2000);
+}
+
+TEST_CASE("Game summaries judge each move against the best one", "[game_analysis]") {
+    Board start;
+    std::vector<Move> moves = scholars_mate(start);
+    moves.resize(2);
+
+    // White to move, black to move, white to move
+    std::vector<PositionAnalysis> positions(3);
+    positions[0] = {moves[0], 30, 6, 100, true, true};
+    positions[1] = {Move(), 50, 6, 100, false, true};   // Black's best keeps +50 for black
+    positions[2] = {Move(), 250, 6, 100, true, true};   // White is +250 after black's move
+
+    GameAnalysis analysis = summarize_game(moves, positions, 200);
+    REQUIRE(analysis.nodes == 300);
+    REQUIRE(analysis.final_score == 250);
+    REQUIRE(analysis.plies[0].loss == 0);
+    REQUIRE(analysis.plies[0].score == 30);
+    REQUIRE(analysis.plies[1].score == -50);
+    REQUIRE(analysis.plies[1].loss == 300);
+    REQUIRE(analysis.plies[1].blunder);
+
+    std::string json = game_analysis_json(analysis);
+    REQUIRE(json.find("\"ply\":2,\"move\":\"e7e5\",\"score\":-50,\"bestmove\":null") != std::string::npos);
+    REQUIRE(json.find("\"blunder\":true") != std::string::npos);
+    REQUIRE(json.find("\"final_score\":250") != std::string::npos);
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+// Minimal in-process stand-in for the neural service's /evaluate_batch
+// endpoint, used to exercise NeuralClient timeouts, hedging and the
+// circuit breaker. Serves keep-alive HTTP/1.1 on 127.0.0.1, one thread per
+// connection.
+
+#include "eval_pipeline.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fianchetto::testing {
+
+class MockNeuralServer {
+public:
+    std::atomic<int> score{0};            // Returned for every position
+    std::atomic<int> status{200};         // HTTP status of every response
+    std::atomic<int> delay_ms{0};         // Added before answering...
+    std::atomic<int> delayed_requests{-1}; // ...the next N requests (-1 = all)
+    std::atomic<int> requests{0};         // Requests received
+
+    MockNeuralServer() {
+        listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        socklen_t len = sizeof(addr);
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        listen(listen_fd_, 16);
+        acceptor_ = std::thread([this] { accept_loop(); });
+    }
+
+    ~MockNeuralServer() {
+        stopping_ = true;
+        shutdown(listen_fd_, SHUT_RDWR);
+        close(listen_fd_);
+        acceptor_.join();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int fd : connections_) shutdown(fd, SHUT_RDWR);
+        for (std::thread& thread : handlers_) thread.join();
+        for (int fd : connections_) close(fd);
+    }
+
+    std::string url() const { return "http://127.0.0.1:" + std::to_string(port_) + "/evaluate"; }
+
+private:
+    int listen_fd_;
+    int port_;
+    std::atomic<bool> stopping_{false};
+    std::thread acceptor_;
+    std::mutex mutex_;
+    std::vector<int> connections_;
+    std::vector<std::thread> handlers_;
+
+    void accept_loop() {
+        while (!stopping_) {
+            int fd = accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) return;
+            std::lock_guard<std::mutex> lock(mutex_);
+            connections_.push_back(fd);
+            handlers_.emplace_back([this, fd] { serve(fd); });
+        }
+    }
+
+    void serve(int fd) {
+        std::string buffer;
+        char chunk[4096];
+        while (!stopping_) {
+            // Headers
+            size_t header_end;
+            while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) return;
+                buffer.append(chunk, n);
+            }
+            std::string headers = buffer.substr(0, header_end);
+            buffer.erase(0, header_end + 4);
+            for (char& c : headers) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+            size_t length = 0;
+            size_t pos = headers.find("content-length:");
+            if (pos != std::string::npos) length = std::stoul(headers.substr(pos + 15));
+            if (headers.find("expect: 100-continue") != std::string::npos) {
+                send_all(fd, "HTTP/1.1 100 Continue\r\n\r\n");
+            }
+
+            // Body
+            while (buffer.size() < length) {
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) return;
+                buffer.append(chunk, n);
+            }
+            size_t count = length / BINARY_POSITION_SIZE;
+            buffer.erase(0, length);
+            requests++;
+
+            int remaining = delayed_requests.load();
+            while (remaining > 0 && !delayed_requests.compare_exchange_weak(remaining, remaining - 1)) {
+            }
+            if (delay_ms > 0 && remaining != 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms.load()));
+            }
+
+            std::string body(count * sizeof(int32_t), '\0');
+            for (size_t i = 0; i < count; i++) {
+                int32_t value = score;
+                std::memcpy(body.data() + i * sizeof(int32_t), &value, sizeof(value));
+            }
+            std::string response = "HTTP/1.1 " + std::to_string(status.load()) + " X\r\n"
+                                   "Content-Type: application/octet-stream\r\n"
+                                   "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+            if (!send_all(fd, response)) return;
+        }
+    }
+
+    static bool send_all(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            sent += n;
+        }
+        return true;
+    }
+};
+
+} // namespace fianchetto::testing
@@ -0,0 +1,108 @@
+#include <catch2/catch.hpp>
+#include "board.hpp"
+#include "neural_client.hpp"
+#include "search.hpp"
+#include "mock_neural_server.hpp"
+#include <chrono>
+
+using namespace fianchetto;
+using fianchetto::testing::MockNeuralServer;
+
+namespace {
+
+long elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+// Black to move with white a queen up, so the fallback is clearly nonzero
+const char* QUEEN_UP = "4k3/8/8/8/8/8/8/3QK3 b - - 0 1";
+
+} // namespace
+
+TEST_CASE("Neural client batches and caches scores", "[neural]") {
+    MockNeuralServer server;
+    server.score = 37;
+    NeuralClient client(server.url());
+
+    Board a;
+    Board b(QUEEN_UP);
+    const Board* boards[2] = {&a, &b};
+    std::vector<int> scores = client.evaluate_batch(std::span<const Board* const>(boards, 2));
+    REQUIRE(scores == std::vector<int>{37, 37});
+    REQUIRE(server.requests == 1);
+
+    REQUIRE(client.evaluate(b) == 37);
+    REQUIRE(server.requests == 1);
+    REQUIRE(client.cache_stats().hits == 1);
+    REQUIRE(client.latency().count() == 1);
+}
+
+TEST_CASE("Neural client falls back to classical eval on timeout", "[neural]") {
+    MockNeuralServer server;
+    server.score = 37;
+    server.delay_ms = 500;
+    NeuralClient client(server.url());
+
+    Board board(QUEEN_UP);
+    auto start = std::chrono::steady_clock::now();
+    int score = client.evaluate(board, 50);
+    REQUIRE(elapsed_ms(start) < 400);
+    REQUIRE(score == -evaluate(board));
+
+    // Fallbacks are not cached
+    server.delay_ms = 0;
+    REQUIRE(client.evaluate(board) == 37);
+}
+
+TEST_CASE("Neural client falls back on HTTP errors", "[neural]") {
+    MockNeuralServer server;
+    server.status = 503;
+    NeuralClient client(server.url());
+
+    Board board(QUEEN_UP);
+    REQUIRE(client.evaluate(board) == -evaluate(board));
+}
+
+TEST_CASE("Neural client circuit breaker skips an unhealthy service", "[neural]") {
+    MockNeuralServer server;
+    server.status = 500;
+    NeuralClientOptions options;
+    options.breaker_failures = 3;
+    options.breaker_cooldown_ms = 100;
+    NeuralClient client(server.url(), options);
+
+    Board board(QUEEN_UP);
+    for (int i = 0; i < 3; i++) client.evaluate(board);
+    REQUIRE(client.breaker().is_open());
+    REQUIRE(server.requests == 3);
+
+    // Open: no request is sent, the classical score comes back at once
+    REQUIRE(client.evaluate(board) == -evaluate(board));
+    REQUIRE(server.requests == 3);
+
+    // After the cooldown a successful probe closes the breaker
+    server.status = 200;
+    server.score = 12;
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    REQUIRE(client.evaluate(board) == 12);
+    REQUIRE_FALSE(client.breaker().is_open());
+}
+
+TEST_CASE("Neural client hedges slow requests", "[neural]") {
+    MockNeuralServer server;
+    server.score = 5;
+    server.delay_ms = 1000;
+    server.delayed_requests = 1;
+    NeuralClientOptions options;
+    options.hedge_after_ms = 30;
+    options.request_timeout_ms = 3000;
+    NeuralClient client(server.url(), options);
+
+    Board board;
+    auto start = std::chrono::steady_clock::now();
+    REQUIRE(client.evaluate(board) == 5);
+    REQUIRE(elapsed_ms(start) < 800);
+    REQUIRE(client.hedged_requests() == 1);
+    REQUIRE(server.requests == 2);
+}
@@ -0,0 +1,162 @@
+#include <catch2/catch.hpp>
+#include "board.hpp"
+#include "movegen.hpp"
+#include "nnue.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Write a network with small random weights in the FNNU format
+std::string write_random_network(uint32_t seed) {
+    std::string path = "nnue_test_" + std::to_string(seed) + ".bin";
+    std::ofstream out(path, std::ios::binary);
+    std::mt19937 rng(seed);
+    auto put = [&](auto value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    auto fill = [&](auto type, size_t count, int lo, int hi) {
+        std::uniform_int_distribution<int> dist(lo, hi);
+        for (size_t i = 0; i < count; i++) put(static_cast<decltype(type)>(dist(rng)));
+    };
+
+    using namespace fianchetto::nnue;
+    out.write(FILE_MAGIC, 4);
+    put(FILE_VERSION);
+    put(static_cast<uint32_t>(INPUTS));
+    put(static_cast<uint32_t>(HIDDEN));
+    put(static_cast<uint32_t>(L1));
+    put(static_cast<uint32_t>(L2));
+    put(static_cast<int32_t>(100));
+    fill(int16_t{}, static_cast<size_t>(INPUTS) * HIDDEN, -20, 20);
+    fill(int16_t{}, HIDDEN, 0, 60);
+    fill(int8_t{}, static_cast<size_t>(L1) * 2 * HIDDEN, -40, 40);
+    fill(int32_t{}, L1, -2000, 2000);
+    fill(int8_t{}, static_cast<size_t>(L2) * L1, -40, 40);
+    fill(int32_t{}, L2, -2000, 2000);
+    fill(int8_t{}, L2, -60, 60);
+    put(static_cast<int32_t>(500));
+    return path;
+}
+
+// Plain integer forward pass over the file's weights, written independently
+// of the SIMD kernels: clip, affine, clip, affine, clip, output
+int reference_evaluate(const std::string& path, const fianchetto::Board& board) {
+    using namespace fianchetto::nnue;
+    std::ifstream in(path, std::ios::binary);
+    in.seekg(4 + 5 * 4);
+    auto read = [&](auto& data, size_t count) {
+        data.resize(count);
+        in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(count * sizeof(data[0])));
+    };
+    int32_t output_scale, out_bias;
+    std::vector<int16_t> ft_weights, ft_bias;
+    std::vector<int8_t> l1_weights, l2_weights, out_weights;
+    std::vector<int32_t> l1_bias, l2_bias;
+    in.read(reinterpret_cast<char*>(&output_scale), 4);
+    read(ft_weights, static_cast<size_t>(INPUTS) * HIDDEN);
+    read(ft_bias, HIDDEN);
+    read(l1_weights, static_cast<size_t>(L1) * 2 * HIDDEN);
+    read(l1_bias, L1);
+    read(l2_weights, static_cast<size_t>(L2) * L1);
+    read(l2_bias, L2);
+    read(out_weights, L2);
+    in.read(reinterpret_cast<char*>(&out_bias), 4);
+
+    std::vector<int> input(2 * HIDDEN);
+    for (fianchetto::Color p : {fianchetto::Color::WHITE, fianchetto::Color::BLACK}) {
+        std::vector<int> acc(ft_bias.begin(), ft_bias.end());
+        for (int sq = 0; sq < 64; sq++) {
+            fianchetto::PieceType piece = board.piece_on(static_cast<fianchetto::Square>(sq));
+            if (piece == fianchetto::PieceType::NONE) continue;
+            int idx = Network::feature_index(p, piece, board.color_on(static_cast<fianchetto::Square>(sq)),
+                                             static_cast<fianchetto::Square>(sq));
+            for (int i = 0; i < HIDDEN; i++) acc[i] += ft_weights[static_cast<size_t>(idx) * HIDDEN + i];
+        }
+        for (int i = 0; i < HIDDEN; i++) input[static_cast<int>(p) * HIDDEN + i] = std::clamp(acc[i], 0, ACTIVATION_MAX);
+    }
+    auto layer = [](const std::vector<int>& in, const std::vector<int8_t>& weights, const std::vector<int32_t>& bias) {
+        std::vector<int> out(bias.size());
+        for (size_t j = 0; j < bias.size(); j++) {
+            int sum = bias[j];
+            for (size_t i = 0; i < in.size(); i++) sum += in[i] * weights[j * in.size() + i];
+            out[j] = std::clamp(sum >> WEIGHT_SHIFT, 0, ACTIVATION_MAX);
+        }
+        return out;
+    };
+    std::vector<int> hidden = layer(layer(input, l1_weights, l1_bias), l2_weights, l2_bias);
+    int out = out_bias;
+    for (int i = 0; i < L2; i++) out += hidden[i] * out_weights[i];
+    int score = static_cast<int>(static_cast<int64_t>(out) * output_scale / (ACTIVATION_MAX * WEIGHT_SCALE));
+    return board.side_to_move() == fianchetto::Color::WHITE ? score : -score;
+}
+
+} // namespace
+
+TEST_CASE("NNUE kernels match a scalar reference", "[nnue]") {
+    // Whichever kernels this build compiled (AVX2, SSE4.1 or scalar, see
+    // NATIVE_ARCH) must agree with the plain forward pass exactly
+    std::string path = write_random_network(3);
+    fianchetto::nnue::Network net;
+    REQUIRE(net.load(path));
+
+    for (const char* fen : {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1",
+                            "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+                            "4k3/8/8/8/8/8/8/4K2Q w - - 0 1"}) {
+        fianchetto::Board board(fen);
+        board.set_network(&net);
+        REQUIRE(net.evaluate(board.accumulator(), board.side_to_move()) == reference_evaluate(path, board));
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE("NNUE rejects missing or malformed files", "[nnue]") {
+    fianchetto::nnue::Network net;
+    REQUIRE_FALSE(net.load("does_not_exist.bin"));
+    REQUIRE_FALSE(net.loaded());
+}
+
+TEST_CASE("NNUE incremental accumulator matches full refresh", "[nnue]") {
+    std::string path = write_random_network(7);
+    fianchetto::nnue::Network net;
+    REQUIRE(net.load(path));
+    std::remove(path.c_str());
+
+    fianchetto::Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    board.set_network(&net);
+    const int root_eval = net.evaluate(board.accumulator(), board.side_to_move());
+
+    // Every move (captures, castling, en passant setups, promotions) two plies deep
+    for (fianchetto::Move m1 : fianchetto::movegen::generate_legal_moves(board)) {
+        board.make_move(m1);
+        for (fianchetto::Move m2 : fianchetto::movegen::generate_legal_moves(board)) {
+            board.make_move(m2);
+            fianchetto::Board fresh(board.get_fen());
+            fresh.set_network(&net);
+            REQUIRE(net.evaluate(board.accumulator(), board.side_to_move()) ==
+                    net.evaluate(fresh.accumulator(), fresh.side_to_move()));
+            board.unmake_move(m2);
+        }
+        board.unmake_move(m1);
+    }
+    REQUIRE(net.evaluate(board.accumulator(), board.side_to_move()) == root_eval);
+}
+
+TEST_CASE("NNUE save and load round trip", "[nnue]") {
+    std::string path = write_random_network(11);
+    fianchetto::nnue::Network net;
+    REQUIRE(net.load(path));
+    REQUIRE(net.save(path));
+
+    fianchetto::nnue::Network reloaded;
+    REQUIRE(reloaded.load(path));
+    std::remove(path.c_str());
+
+    fianchetto::Board board;
+    board.set_network(&net);
+    int expected = net.evaluate(board.accumulator(), board.side_to_move());
+    board.set_network(&reloaded);
+    REQUIRE(reloaded.evaluate(board.accumulator(), board.side_to_move()) == expected);
+}
@@ -21,3 +21,15 @@ TEST_CASE("Perft depth 3", "[perft]") {
     REQUIRE(nodes == 8902);
 }
 
+
+TEST_CASE("Perft kiwipete depth 3", "[perft]") {
+    fianchetto::Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    uint64_t nodes = fianchetto::movegen::perft(board, 3);
+    REQUIRE(nodes == 97862);
+}
+
+TEST_CASE("Perft promotions and castling rights depth 3", "[perft]") {
+    fianchetto::Board board("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+    uint64_t nodes = fianchetto::movegen::perft(board, 3);
+    REQUIRE(nodes == 9467);
+}
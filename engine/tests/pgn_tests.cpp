@@ -0,0 +1,129 @@
+#include <catch2/catch.hpp>
+#include "movegen.hpp"
+#include "pgn.hpp"
+#include <atomic>
+#include <sstream>
+
+using namespace fianchetto;
+
+namespace {
+
+const char* KIWIPETE = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+const char* TWO_GAMES =
+    "[Event \"Casual\"]\n"
+    "[White \"A \\\"Quoted\\\" Player\"]\n"
+    "[Result \"1-0\"]\n"
+    "\n"
+    "1. e4 e5 2. Bc4 {Italian-ish} Nc6 (2... Nf6 3. d3 (3. Nc3) Bc5) 3. Qh5 $2 Nf6?? 4. Qxf7# 1-0\n"
+    "\n"
+    "[Event \"From a position\"]\n"
+    "[FEN \"4k3/P7/8/8/8/8/8/4K3 w - - 0 1\"]\n"
+    "\n"
+    "1.a8=Q+ Kd7 2.Qb7+ ; rest of line ignored\n"
+    "Kd6 *\n";
+
+} // namespace
+
+TEST_CASE("SAN moves are matched against the legal moves", "[pgn]") {
+    Board board(KIWIPETE);
+    REQUIRE(pgn::parse_san(board, "O-O") == Move(square(4, 0), square(6, 0), PieceType::KING, PieceType::NONE,
+                                                  PieceType::NONE, MOVE_FLAG_CASTLE_KINGSIDE));
+    REQUIRE(move_to_string(pgn::parse_san(board, "Bxa6")) == "e2a6");
+    REQUIRE(move_to_string(pgn::parse_san(board, "dxe6")) == "d5e6");
+    REQUIRE(move_to_string(pgn::parse_san(board, "Nxf7!?")) == "e5f7");
+    REQUIRE(move_to_string(pgn::parse_san(board, "Nb5")) == "c3b5");
+    REQUIRE(pgn::parse_san(board, "Qh9") == Move());
+    REQUIRE(pgn::parse_san(board, "Ke3") == Move()); // Illegal
+
+    // Disambiguation by file and by rank
+    Board rooks("4k3/8/8/8/8/8/8/R4RK1 w - - 0 1");
+    REQUIRE(pgn::parse_san(rooks, "Rd1") == Move());
+    REQUIRE(move_to_string(pgn::parse_san(rooks, "Rad1")) == "a1d1");
+    Board knights("4k3/8/8/1N6/8/1N6/8/4K3 w - - 0 1");
+    REQUIRE(move_to_string(pgn::parse_san(knights, "N5d4")) == "b5d4");
+
+    // Promotion and en passant
+    Board promo("1r2k3/P7/8/3pP3/8/8/8/4K3 w - d6 0 1");
+    REQUIRE(move_to_string(pgn::parse_san(promo, "axb8=N")) == "a7b8n");
+    REQUIRE(move_to_string(pgn::parse_san(promo, "a8q")) == "a7a8q");
+    REQUIRE(pgn::parse_san(promo, "exd6").is_en_passant());
+}
+
+TEST_CASE("SAN output parses back to the same move", "[pgn]") {
+    for (const char* fen : {KIWIPETE, "1r2k3/P7/8/3pP3/8/8/8/R3K2R w KQ d6 0 1",
+                            "4k3/8/8/1N6/8/1N3N2/8/4K3 w - - 0 1"}) {
+        Board board(fen);
+        for (Move move : movegen::generate_legal_moves(board)) {
+            std::string san = pgn::move_to_san(board, move);
+            REQUIRE(pgn::parse_san(board, san) == move);
+        }
+    }
+
+    Board board(KIWIPETE);
+    REQUIRE(pgn::move_to_san(board, pgn::parse_san(board, "O-O-O")) == "O-O-O");
+    REQUIRE(pgn::move_to_san(board, pgn::parse_san(board, "Qxf6")) == "Qxf6");
+    Board mate("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+    REQUIRE(pgn::move_to_san(mate, pgn::parse_san(mate, "Ra8")) == "Ra8#");
+    Board knights("4k3/8/8/1N6/8/1N3N2/8/4K3 w - - 0 1");
+    REQUIRE(pgn::parse_san(knights, "N3d4") == Move()); // b3 or f3
+    REQUIRE(pgn::move_to_san(knights, pgn::parse_san(knights, "Nb3d4")) == "Nb3d4");
+}
+
+TEST_CASE("PGN reader decodes games from memory and streams", "[pgn]") {
+    auto check = [](pgn::Reader& reader) {
+        pgn::Game game;
+        REQUIRE(reader.next(game));
+        REQUIRE(game.tag("White") == "A \"Quoted\" Player");
+        REQUIRE(game.moves.size() == 7);
+        REQUIRE(game.complete);
+        REQUIRE(game.result == 1);
+
+        Board end(game.fen);
+        for (Move m : game.moves) end.make_move(m);
+        REQUIRE(movegen::generate_legal_moves(end).empty());
+
+        REQUIRE(reader.next(game));
+        REQUIRE(game.fen == "4k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+        REQUIRE(game.moves.size() == 4);
+        REQUIRE(game.moves[0].promotion() == PieceType::QUEEN);
+        REQUIRE(game.result == pgn::RESULT_UNKNOWN);
+        REQUIRE_FALSE(reader.next(game));
+    };
+
+    pgn::Reader memory{std::string_view(TWO_GAMES)};
+    check(memory);
+    std::istringstream stream(TWO_GAMES);
+    pgn::Reader streamed(stream);
+    check(streamed);
+
+    // An unreadable move ends the game's moves but not the game
+    pgn::Reader broken{std::string_view("1. e4 Ke7 2. Qh5 e5 0-1\n[Event \"next\"]\n1. d4 *\n")};
+    pgn::Game game;
+    REQUIRE(broken.next(game));
+    REQUIRE_FALSE(game.complete);
+    REQUIRE(game.moves.size() == 1);
+    REQUIRE(game.result == -1);
+    REQUIRE(broken.next(game));
+    REQUIRE(game.moves.size() == 1);
+}
+
+TEST_CASE("PGN games are parsed in parallel and replayed", "[pgn]") {
+    std::string text;
+    for (int i = 0; i < 200; i++) text += TWO_GAMES;
+
+    std::atomic<size_t> moves{0};
+    size_t games = pgn::parse_parallel(text, 4, [&](const pgn::Game& game, int) { moves += game.moves.size(); });
+    REQUIRE(games == 400);
+    REQUIRE(moves == 200 * (7 + 4));
+
+    pgn::Reader reader{std::string_view(TWO_GAMES)};
+    pgn::Game game;
+    reader.next(game);
+    std::vector<std::string> visited;
+    pgn::replay(game, [&](const Board& board, Move move) {
+        if (move == Move()) visited.push_back(board.get_fen());
+    });
+    REQUIRE(visited.size() == 1);
+    REQUIRE(visited[0].rfind("r1bqkb1r/pppp1Qpp/2n2n2/4p3/2B1P3/8/PPPP1PPP/RNB1K1NR b KQkq", 0) == 0);
+}
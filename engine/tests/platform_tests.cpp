@@ -0,0 +1,48 @@
+#include <catch2/catch.hpp>
+#include "platform.hpp"
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+using namespace fianchetto::platform;
+
+TEST_CASE("Large buffers are zeroed and huge-page aligned", "[platform]") {
+    LargeBuffer small(4096);
+    REQUIRE(small.data() != nullptr);
+    REQUIRE(small.pages() == PageKind::NORMAL);
+
+    LargeBuffer large(3 * HUGE_PAGE_SIZE + 100);
+    REQUIRE(large.size() == 3 * HUGE_PAGE_SIZE + 100);
+    REQUIRE(reinterpret_cast<uintptr_t>(large.data()) % HUGE_PAGE_SIZE == 0);
+    auto* bytes = static_cast<unsigned char*>(large.data());
+    REQUIRE(bytes[0] == 0);
+    REQUIRE(bytes[large.size() - 1] == 0);
+
+    // Moving hands over the mapping
+    void* data = large.data();
+    LargeBuffer moved(std::move(large));
+    REQUIRE(moved.data() == data);
+    REQUIRE(large.data() == nullptr);
+}
+
+TEST_CASE("Parallel clear zeroes every byte", "[platform]") {
+    const size_t size = 96 * 1024 * 1024 + 12345; // above the threaded threshold, not chunk aligned
+    LargeBuffer buffer(size);
+    auto* bytes = static_cast<unsigned char*>(buffer.data());
+    std::memset(bytes, 0xAB, size);
+
+    parallel_clear(bytes, size, 5);
+    size_t nonzero = 0;
+    for (size_t i = 0; i < size; i += 4093) nonzero += bytes[i] != 0;
+    REQUIRE(nonzero == 0);
+    REQUIRE(bytes[size - 1] == 0);
+}
+
+TEST_CASE("Threads can be pinned to NUMA nodes", "[platform]") {
+    REQUIRE_FALSE(numa_nodes().empty());
+    REQUIRE_FALSE(numa_nodes().front().empty());
+    // On a short-lived thread, so the test runner's own affinity is untouched
+    bool pinned = false;
+    std::thread([&] { pinned = pin_current_thread(0); }).join();
+    REQUIRE(pinned);
+}
@@ -0,0 +1,90 @@
+"""Smoke test for the fianchetto_native module (run by ctest with BUILD_PYTHON=ON)."""
+
+import threading
+
+import fianchetto_native as fn
+
+START = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+MATE_IN_ONE = "6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1"
+
+
+def test_board():
+    board = fn.Board()
+    assert board.fen() == START
+    assert board.turn
+    board.push("e2e4")
+    assert not board.turn
+    assert board.copy().fen() == board.fen()
+
+
+def test_search_finds_mate():
+    result = fn.search(fn.Board(MATE_IN_ONE), depth=4)
+    assert result["bestmove"] == "a1a8"
+    assert result["mate"] == 1
+    assert result["pv"][0] == "a1a8"
+
+
+def test_table_stays_warm():
+    # The second search starts from the first one's entries
+    board = fn.Board("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3")
+    tt = fn.TranspositionTable(16)
+    first = fn.search(board, depth=6, tt=tt)
+    second = fn.search(board, depth=6, tt=tt)
+    assert second["bestmove"] == first["bestmove"]
+    assert second["nodes"] < first["nodes"]
+
+
+def test_encode_planes_copies_boards():
+    boards = [fn.Board() for _ in range(64)]
+    stop = threading.Event()
+
+    def shuffle():
+        while not stop.is_set():
+            for board in boards:
+                board.push("g1f3")
+                board.pop()
+
+    # Boards are pushed and popped while the GIL is released for encoding
+    thread = threading.Thread(target=shuffle)
+    thread.start()
+    try:
+        for _ in range(200):
+            planes = fn.encode_planes(boards)
+            assert planes.shape == (64, 12, 8, 8)
+            # Never a board caught between removing and placing a piece
+            assert (planes.reshape(64, -1).sum(axis=1) == 32).all()
+    finally:
+        stop.set()
+        thread.join()
+
+
+def test_search_leaves_board_alone():
+    board = fn.Board()
+    results = []
+
+    def run():
+        results.append(fn.search(board, depth=5, tt=fn.TranspositionTable(1)))
+
+    # The GIL is released during search, so the board is read meanwhile
+    threads = [threading.Thread(target=run) for _ in range(2)]
+    for t in threads:
+        t.start()
+    for _ in range(1000):
+        assert board.fen() == START
+    for t in threads:
+        t.join()
+    assert board.fen() == START
+    assert len(results) == 2 and all(r["bestmove"] for r in results)
+
+
+def test_encode_planes():
+    planes = fn.encode_planes([fn.Board(), START])
+    assert planes.shape == (2, 12, 8, 8)
+    assert planes.sum() == 64  # 32 pieces per board
+
+
+if __name__ == "__main__":
+    for name, test in list(globals().items()):
+        if name.startswith("test_"):
+            test()
+    print("ok")
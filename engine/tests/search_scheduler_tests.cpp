@@ -0,0 +1,138 @@
+#include <catch2/catch.hpp>
+#include "search_scheduler.hpp"
+#include "movegen.hpp"
+#include <algorithm>
+
+using namespace fianchetto;
+
+namespace {
+
+const char* KIWIPETE = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+bool is_legal(Board& board, Move move) {
+    auto moves = movegen::generate_legal_moves(board);
+    return std::find(moves.begin(), moves.end(), move) != moves.end();
+}
+
+} // namespace
+
+TEST_CASE("Scheduler runs more searches than threads", "[scheduler]") {
+    SearchSchedulerOptions options;
+    options.threads = 2;
+    options.hash_mb = 1;
+    SearchScheduler scheduler(options);
+
+    Board board(KIWIPETE);
+    SearchTask task;
+    task.params.depth = 4;
+
+    std::vector<std::future<SearchOutcome>> futures;
+    for (int i = 0; i < 8; i++) futures.push_back(scheduler.submit(board, task));
+
+    for (auto& future : futures) {
+        SearchOutcome outcome = future.get();
+        REQUIRE(outcome.stats.depth == 4);
+        REQUIRE(is_legal(board, outcome.best_move));
+        REQUIRE(outcome.pv.front() == outcome.best_move);
+    }
+
+    // Same answer as a direct search
+    SearchStats stats;
+    SearchParams params;
+    params.depth = 4;
+    Move direct = search_root(board, params, stats);
+    REQUIRE(scheduler.submit(board, task).get().best_move == direct);
+
+    auto counters = scheduler.stats();
+    REQUIRE(counters.submitted == 9);
+    REQUIRE(counters.completed == 9);
+    REQUIRE(counters.slices == 36);
+    REQUIRE(scheduler.active() == 0);
+}
+
+TEST_CASE("Scheduler enforces node budgets and deadlines", "[scheduler]") {
+    SearchSchedulerOptions options;
+    options.threads = 1;
+    options.hash_mb = 1;
+    SearchScheduler scheduler(options);
+    Board board(KIWIPETE);
+
+    SearchTask budgeted;
+    budgeted.params.depth = 64;
+    budgeted.params.node_limit = 20000;
+    SearchOutcome outcome = scheduler.submit(board, budgeted).get();
+    REQUIRE(is_legal(board, outcome.best_move));
+    REQUIRE(outcome.stats.nodes + outcome.stats.qnodes < 20000 + 4096);
+
+    SearchTask timed;
+    timed.params.depth = 64;
+    timed.params.time_limit_ms = 100;
+    std::vector<std::future<SearchOutcome>> futures;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 3; i++) futures.push_back(scheduler.submit(board, timed));
+    for (auto& future : futures) REQUIRE(is_legal(board, future.get().best_move));
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+}
+
+TEST_CASE("Scheduler favours priority under time pressure", "[scheduler]") {
+    SearchSchedulerOptions options;
+    options.threads = 1;
+    options.hash_mb = 1;
+    options.pressure_ms = 10000; // Every timed task is under pressure
+    SearchScheduler scheduler(options);
+    Board board(KIWIPETE);
+
+    SearchTask low, high;
+    low.params.depth = high.params.depth = 64;
+    low.params.time_limit_ms = high.params.time_limit_ms = 300;
+    high.priority = 8;
+
+    // The urgent task keeps the only thread until it is done; the other
+    // waits for it despite having less weighted work
+    auto high_future = scheduler.submit(board, high);
+    auto low_future = scheduler.submit(board, low);
+    SearchOutcome high_outcome = high_future.get();
+    SearchOutcome low_outcome = low_future.get();
+    REQUIRE(high_outcome.queued_ms < 50);
+    REQUIRE(low_outcome.queued_ms >= 50);
+    REQUIRE(is_legal(board, low_outcome.best_move));
+    REQUIRE(scheduler.stats().pressured == scheduler.stats().slices);
+}
+
+TEST_CASE("Scheduler shares throughput by priority", "[scheduler]") {
+    SearchSchedulerOptions options;
+    options.threads = 1;
+    options.hash_mb = 1;
+    SearchScheduler scheduler(options);
+    Board board(KIWIPETE);
+
+    // Without deadlines both finish; the heavier task is served first
+    // once their weighted work diverges
+    SearchTask light, heavy;
+    light.params.depth = heavy.params.depth = 5;
+    heavy.priority = 4;
+    auto light_future = scheduler.submit(board, light);
+    auto heavy_future = scheduler.submit(board, heavy);
+    REQUIRE(light_future.get().stats.depth == 5);
+    REQUIRE(heavy_future.get().stats.depth == 5);
+    REQUIRE(scheduler.stats().pressured == 0);
+}
+
+TEST_CASE("Scheduler hands out pooled tables empty", "[scheduler]") {
+    SearchSchedulerOptions options;
+    options.threads = 1;
+    options.hash_mb = 1;
+    SearchScheduler scheduler(options);
+
+    Board board(KIWIPETE);
+    SearchTask task;
+    task.params.depth = 5;
+
+    // The second search gets the first one's table back; with its entries
+    // gone it repeats the same search exactly
+    SearchOutcome first = scheduler.submit(board, task).get();
+    SearchOutcome second = scheduler.submit(board, task).get();
+    REQUIRE(second.stats.nodes == first.stats.nodes);
+    REQUIRE(second.stats.qnodes == first.stats.qnodes);
+    REQUIRE(second.best_move == first.best_move);
+}
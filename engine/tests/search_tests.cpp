@@ -0,0 +1,229 @@
+#include <catch2/catch.hpp>
+#include "board.hpp"
+#include "movegen.hpp"
+#include "search.hpp"
+#include <algorithm>
+
+TEST_CASE("Search finds back-rank mate", "[search]") {
+    fianchetto::Board board("6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1");
+    fianchetto::SearchParams params;
+    params.depth = 3;
+    fianchetto::SearchStats stats;
+    fianchetto::Move best = fianchetto::search_root(board, params, stats);
+    REQUIRE(fianchetto::move_to_string(best) == "a1a8");
+    REQUIRE(stats.best_score == fianchetto::SCORE_MATE - 1);
+}
+
+TEST_CASE("Null move passes the turn and is undone", "[search]") {
+    const std::string fen = "rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 2";
+    fianchetto::Board board(fen);
+    uint64_t hash = board.hash();
+    board.make_null_move();
+    // Same as the position with white to move and no en passant square
+    REQUIRE(board.hash() == fianchetto::Board("rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2").hash());
+    board.unmake_null_move();
+    REQUIRE(board.get_fen() == fen);
+    REQUIRE(board.hash() == hash);
+}
+
+TEST_CASE("Null move pruning keeps mate scores exact", "[search]") {
+    // 1.Kf7 (or Kg6) and 2.Rh1/Ra8 mate: the rook side never gets to pass
+    fianchetto::Board board("7k/8/5K2/8/8/8/8/R7 w - - 0 1");
+    fianchetto::SearchParams params;
+    params.depth = 6;
+    fianchetto::SearchStats stats;
+    fianchetto::search_root(board, params, stats);
+    REQUIRE(stats.best_score == fianchetto::SCORE_MATE - 3);
+}
+
+TEST_CASE("Mate scores convert to moves to mate", "[search]") {
+    using fianchetto::SCORE_MATE;
+    REQUIRE(fianchetto::mate_in_moves(SCORE_MATE - 1) == 1);
+    REQUIRE(fianchetto::mate_in_moves(SCORE_MATE - 3) == 2);
+    REQUIRE(fianchetto::mate_in_moves(-SCORE_MATE + 2) == -1);
+    REQUIRE(fianchetto::mate_in_moves(-SCORE_MATE) == 0);
+    REQUIRE(fianchetto::is_mate_score(SCORE_MATE - fianchetto::MAX_PLY));
+    REQUIRE(fianchetto::is_mate_score(-SCORE_MATE));
+    REQUIRE_FALSE(fianchetto::is_mate_score(SCORE_MATE - fianchetto::MAX_PLY - 1));
+    REQUIRE_FALSE(fianchetto::is_mate_score(-900));
+}
+
+TEST_CASE("Null move pruning is off in zugzwang-prone endings", "[search]") {
+    // Black to move must give way and the pawn promotes; a black null move
+    // would hide that, so pawn-and-king sides never pass
+    fianchetto::Board board("4k3/8/4K3/4P3/8/8/8/8 b - - 0 1");
+    fianchetto::SearchParams params;
+    params.depth = 8;
+    fianchetto::SearchStats stats;
+    fianchetto::search_root(board, params, stats);
+    REQUIRE(stats.best_score <= -500);
+}
+
+TEST_CASE("Search restores the board", "[search]") {
+    const std::string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    fianchetto::Board board(fen);
+    fianchetto::SearchParams params;
+    params.depth = 4;
+    fianchetto::SearchStats stats;
+    fianchetto::search_root(board, params, stats);
+    REQUIRE(board.get_fen() == fen);
+    REQUIRE(stats.depth == 4);
+}
+
+TEST_CASE("History tables stay bounded and remember refutations", "[search]") {
+    using namespace fianchetto;
+    const Color W = Color::WHITE, B = Color::BLACK;
+    Move e4(square(4, 1), square(4, 3), PieceType::PAWN);
+    Move nf3(square(6, 0), square(5, 2), PieceType::KNIGHT);
+    Move e5(square(4, 6), square(4, 4), PieceType::PAWN);
+    Move nc6(square(1, 7), square(2, 5), PieceType::KNIGHT);
+
+    // Gravity saturates instead of growing without bound
+    HistoryHeuristic history;
+    history.clear();
+    for (int i = 0; i < 1000; i++) history.update(W, e4, 2048);
+    REQUIRE(history.get_score(W, e4) > 0);
+    REQUIRE(history.get_score(W, e4) <= HISTORY_MAX);
+    for (int i = 0; i < 1000; i++) history.update(W, nf3, -2048);
+    REQUIRE(history.get_score(W, nf3) >= -HISTORY_MAX);
+
+    // A malus lowers a score, and the other side's table is untouched
+    int before = history.get_score(W, e4);
+    history.update(W, e4, -512);
+    REQUIRE(history.get_score(W, e4) < before);
+    REQUIRE(history.get_score(B, e4) == 0);
+
+    ContinuationHistory continuation;
+    for (int i = 0; i < 1000; i++) continuation.update(B, e5, W, nf3, 2048);
+    REQUIRE(continuation.get_score(B, e5, W, nf3) > 0);
+    REQUIRE(continuation.get_score(B, e5, W, nf3) <= HISTORY_MAX);
+    before = continuation.get_score(B, e5, W, nf3);
+    continuation.update(B, e5, W, nf3, -512);
+    REQUIRE(continuation.get_score(B, e5, W, nf3) < before);
+    // Same pieces and squares with the colors swapped: a separate entry
+    REQUIRE(continuation.get_score(W, e5, B, nf3) == 0);
+    for (int i = 0; i < 1000; i++) continuation.update(W, e4, B, nc6, -2048);
+    REQUIRE(continuation.get_score(W, e4, B, nc6) >= -HISTORY_MAX);
+
+    CounterMoves counters;
+    counters.clear();
+    counters.set(B, e4, nc6);
+    REQUIRE(counters.get(B, e4) == nc6);
+    REQUIRE(counters.get(W, e4) == Move());
+    REQUIRE(counters.get(B, nf3) == Move());
+
+    // Killers are kept per ply
+    KillerMoves killers;
+    killers.clear();
+    killers.add(3, nf3);
+    REQUIRE(killers.is_killer(3, nf3));
+    REQUIRE_FALSE(killers.is_killer(4, nf3));
+}
+
+TEST_CASE("Evaluation trace adds up to the evaluation", "[search]") {
+    for (const char* fen : {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                            "4k3/pp4p1/8/3P4/8/1P6/1P3PPP/4K3 b - - 0 1"}) {
+        fianchetto::Board board(fen);
+        fianchetto::EvalTrace trace = fianchetto::trace_evaluation(board);
+        int sum = 0;
+        for (const fianchetto::EvalTerm& term : trace.terms) sum += term.white - term.black;
+        REQUIRE(sum == trace.classical);
+        int score = fianchetto::evaluate(board);
+        REQUIRE(trace.classical == (board.side_to_move() == fianchetto::Color::WHITE ? score : -score));
+        REQUIRE(!trace.has_nnue);
+    }
+
+    // Doubled b-pawns, a passed d-pawn, a black isolated g-pawn
+    fianchetto::Board board("4k3/pp4p1/8/3P4/8/1P6/1P3PPP/4K3 b - - 0 1");
+    fianchetto::EvalTrace trace = fianchetto::trace_evaluation(board);
+    auto find = [](const std::vector<fianchetto::EvalTerm>& terms, const char* name) {
+        for (const fianchetto::EvalTerm& term : terms) {
+            if (std::string(term.name) == name) return term;
+        }
+        FAIL("missing term " << name);
+        return fianchetto::EvalTerm{};
+    };
+    REQUIRE(find(trace.terms, "doubled_pawns").white == -10);
+    REQUIRE(find(trace.terms, "doubled_pawns").black == 0);
+    REQUIRE(find(trace.features, "passed_pawns").white == 1);
+    REQUIRE(find(trace.features, "isolated_pawns").black == 1);
+    REQUIRE(find(trace.features, "open_files").white == 2);
+    REQUIRE(find(trace.features, "pawn_shelter").white == 1);
+}
+
+TEST_CASE("Multi-PV search returns distinct full lines, best first", "[search]") {
+    const std::string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    fianchetto::Board board(fen);
+    fianchetto::TranspositionTable tt(4);
+    fianchetto::SearchParams params;
+    params.depth = 5;
+
+    fianchetto::SearchStats single;
+    fianchetto::Move best = fianchetto::search_root(board, tt, params, single);
+    REQUIRE(single.lines.size() == 1);
+    REQUIRE(single.lines[0].move == best);
+    REQUIRE(single.lines[0].pv.size() >= 5);
+
+    tt.clear();
+    params.multi_pv = 3;
+    fianchetto::SearchStats multi;
+    fianchetto::search_root(board, tt, params, multi);
+    REQUIRE(board.get_fen() == fen);
+    REQUIRE(multi.depth == 5);
+    REQUIRE(multi.lines.size() == 3);
+    REQUIRE(multi.best_move == multi.lines[0].move);
+    REQUIRE(multi.best_score == multi.lines[0].score);
+    REQUIRE(multi.best_score == single.best_score);
+    for (size_t i = 0; i < multi.lines.size(); i++) {
+        const fianchetto::PVLine& line = multi.lines[i];
+        REQUIRE(line.pv.front() == line.move);
+        if (i > 0) {
+            REQUIRE(line.score <= multi.lines[i - 1].score);
+            REQUIRE(line.move != multi.lines[i - 1].move);
+        }
+
+        // Every line is playable from the root
+        for (fianchetto::Move move : line.pv) {
+            auto legal = fianchetto::movegen::generate_legal_moves(board);
+            REQUIRE(std::find(legal.begin(), legal.end(), move) != legal.end());
+            board.make_move(move);
+        }
+        for (auto it = line.pv.rbegin(); it != line.pv.rend(); ++it) board.unmake_move(*it);
+    }
+
+    // More lines than legal moves
+    fianchetto::Board king("7k/8/8/8/8/8/8/K7 w - - 0 1");
+    params.multi_pv = 10;
+    fianchetto::SearchStats few;
+    fianchetto::search_root(king, params, few);
+    REQUIRE(few.lines.size() == 3);
+}
+
+TEST_CASE("searchmoves restricts the root moves", "[search]") {
+    fianchetto::Board board("6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1");
+    fianchetto::SearchParams params;
+    params.depth = 3;
+    for (fianchetto::Move move : fianchetto::movegen::generate_legal_moves(board)) {
+        std::string text = fianchetto::move_to_string(move);
+        if (text == "a1a7" || text == "h2h3") params.search_moves.push_back(move);
+    }
+    REQUIRE(params.search_moves.size() == 2);
+
+    fianchetto::TranspositionTable tt(1);
+    fianchetto::SearchStats stats;
+    fianchetto::Move best = fianchetto::search_root(board, tt, params, stats);
+    std::string text = fianchetto::move_to_string(best);
+    REQUIRE((text == "a1a7" || text == "h2h3"));
+
+    // Both lines, and the restricted root left nothing in the table
+    params.multi_pv = 5;
+    fianchetto::search_root(board, tt, params, stats);
+    REQUIRE(stats.lines.size() == 2);
+    fianchetto::TTEntry entry;
+    REQUIRE(!tt.probe(board.hash(), entry));
+
+    // Without the restriction the mate is found
+    params.search_moves.clear();
+    params.multi_pv = 1;
+    REQUIRE(fianchetto::move_to_string(fianchetto::search_root(board, tt, params, stats)) == "a1a8");
+}
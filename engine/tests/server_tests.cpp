@@ -0,0 +1,298 @@
+#include <catch2/catch.hpp>
+#include "engine_server.hpp"
+#include "json.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstdio>
+#include <thread>
+
+using namespace fianchetto;
+
+namespace {
+
+// Running server on an ephemeral localhost port
+struct TestServer {
+    EngineServer server;
+    std::thread thread;
+
+    explicit TestServer(const EngineServerOptions& options) : server(options) {
+        REQUIRE(server.listen("127.0.0.1", 0));
+        thread = std::thread([this] { server.run(); });
+    }
+
+    ~TestServer() {
+        server.stop();
+        thread.join();
+    }
+};
+
+class Client {
+public:
+    explicit Client(int port) {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        REQUIRE(connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    }
+
+    ~Client() { close(fd_); }
+
+    // Send one request on the kept-alive connection; returns status and body
+    std::pair<int, std::string> request(const std::string& method, const std::string& path,
+                                        const std::string& body = "") {
+        std::string raw = method + " " + path + " HTTP/1.1\r\nHost: test\r\n"
+                          "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+        send(fd_, raw.data(), raw.size(), 0);
+
+        std::string response;
+        char chunk[4096];
+        size_t header_end;
+        while ((header_end = response.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t n = recv(fd_, chunk, sizeof(chunk), 0);
+            if (n <= 0) return {0, ""};
+            response.append(chunk, n);
+        }
+        size_t pos = response.find("Content-Length: ");
+        size_t length = std::stoul(response.substr(pos + 16));
+        while (response.size() < header_end + 4 + length) {
+            ssize_t n = recv(fd_, chunk, sizeof(chunk), 0);
+            if (n <= 0) return {0, ""};
+            response.append(chunk, n);
+        }
+        int status = std::stoi(response.substr(9, 3));
+        return {status, response.substr(header_end + 4, length)};
+    }
+
+private:
+    int fd_;
+};
+
+std::unordered_map<std::string, std::string> parse(const std::string& body) {
+    std::unordered_map<std::string, std::string> fields;
+    REQUIRE(json::parse_object(body, fields));
+    return fields;
+}
+
+} // namespace
+
+TEST_CASE("JSON object parsing and writing", "[json]") {
+    std::unordered_map<std::string, std::string> fields;
+    REQUIRE(json::parse_object(R"( {"fen": "8/8 w \"x\"A", "depth": 7, "pv": ["a", "b"], "ok": true} )", fields));
+    REQUIRE(fields["fen"] == "8/8 w \"x\"A");
+    long depth = 0;
+    REQUIRE(json::get_int(fields, "depth", depth));
+    REQUIRE(depth == 7);
+    REQUIRE(fields["pv"] == R"(["a", "b"])");
+    REQUIRE(fields["ok"] == "true");
+    REQUIRE_FALSE(json::get_int(fields, "fen", depth));
+
+    REQUIRE_FALSE(json::parse_object("{\"a\": 1", fields));
+    REQUIRE_FALSE(json::parse_object("[1, 2]", fields));
+    REQUIRE(json::parse_object("{}", fields));
+
+    std::string out = json::ObjectWriter().add("move", "e2e4").add("score", -35).add("pv", std::vector<std::string>{"e2e4", "e7e5"}).add("tab", "a\tb").str();
+    REQUIRE(out == R"({"move":"e2e4","score":-35,"pv":["e2e4","e7e5"],"tab":"a\tb"})");
+}
+
+TEST_CASE("Server answers /move, /analyse and /health", "[server]") {
+    EngineServerOptions options;
+    options.workers = 2;
+    options.hash_mb = 1;
+    TestServer test(options);
+    Client client(test.server.port());
+
+    auto [status, body] = client.request("POST", "/move", R"({"fen": "6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1", "depth": 3})");
+    REQUIRE(status == 200);
+    auto fields = parse(body);
+    REQUIRE(fields["move"] == "a1a8");
+    REQUIRE(fields["mate"] == "1");
+
+    // Same connection (keep-alive)
+    std::tie(status, body) = client.request("POST", "/analyse", R"({"fen": "startpos", "depth": 3})");
+    REQUIRE(status == 200);
+    fields = parse(body);
+    REQUIRE(fields["depth"] == "3");
+    REQUIRE(fields["pv"].find(fields["bestmove"]) == 2);
+
+    // Top lines, best first
+    std::tie(status, body) = client.request("POST", "/analyse", R"({"fen": "startpos", "depth": 3, "multipv": 3})");
+    REQUIRE(status == 200);
+    fields = parse(body);
+    REQUIRE(fields.count("cached") == 0);
+    REQUIRE(fields["lines"].rfind("[{\"score\":" + fields["score"] + ",\"pv\":[\"" + fields["bestmove"] + "\"", 0) == 0);
+    size_t count = 0;
+    for (size_t at = fields["lines"].find("\"score\""); at != std::string::npos; at = fields["lines"].find("\"score\"", at + 1)) {
+        count++;
+    }
+    REQUIRE(count == 3);
+
+    std::tie(status, body) = client.request("GET", "/health");
+    REQUIRE(status == 200);
+    REQUIRE(parse(body)["status"] == "healthy");
+
+    // Game over positions have no move
+    std::tie(status, body) = client.request("POST", "/move", R"({"fen": "7k/5QQ1/8/8/8/8/8/6K1 b - - 0 1"})");
+    REQUIRE(status == 200);
+    REQUIRE(parse(body)["result"] == "checkmate");
+}
+
+TEST_CASE("Server rejects bad requests", "[server]") {
+    EngineServerOptions options;
+    options.workers = 1;
+    options.hash_mb = 1;
+    TestServer test(options);
+    Client client(test.server.port());
+
+    REQUIRE(client.request("POST", "/move", "not json").first == 400);
+    REQUIRE(client.request("POST", "/move", R"({"depth": 3})").first == 400);
+    REQUIRE(client.request("POST", "/move", R"({"fen": "8/8/8/8/8/8/8/8 w - - 0 1"})").first == 400);
+    REQUIRE(client.request("POST", "/move", R"({"fen": "startpos", "depth": "deep"})").first == 400);
+    REQUIRE(client.request("GET", "/move").first == 405);
+    REQUIRE(client.request("GET", "/nowhere").first == 404);
+}
+
+TEST_CASE("Server analyses whole games from PGN or a move list", "[server]") {
+    EngineServerOptions options;
+    options.workers = 2;
+    options.hash_mb = 1;
+    TestServer test(options);
+    Client client(test.server.port());
+
+    auto [status, body] = client.request(
+        "POST", "/analysegame",
+        R"({"pgn": "[Event \"Casual\"]\n\n1. e4 e5 2. Bc4 Nc6 3. Qh5 Nf6 4. Qxf7# 1-0\n", "depth": 4})");
+    REQUIRE(status == 200);
+    auto fields = parse(body);
+    REQUIRE(fields["final_score"] == std::to_string(SCORE_MATE));
+    const std::string& plies = fields["plies"];
+    size_t knight = plies.find("\"move\":\"g8f6\"");
+    REQUIRE(knight != std::string::npos);
+    REQUIRE(plies.find("\"blunder\":true", knight) < plies.find("\"ply\":7", knight));
+    REQUIRE(plies.find("\"ply\":7,\"move\":\"h5f7\"") != std::string::npos);
+
+    std::tie(status, body) = client.request(
+        "POST", "/analysegame", R"({"fen": "startpos", "moves": "e2e4 e7e5", "depth": 3, "session": "g"})");
+    REQUIRE(status == 200);
+    REQUIRE(parse(body)["plies"].find("\"ply\":2") != std::string::npos);
+
+    // A long game under a whole-game budget: positions are queued a few at
+    // a time, each with its share of the time left
+    std::string shuffle;
+    for (int i = 0; i < 20; i++) shuffle += " g1f3 g8f6 f3g1 f6g8";
+    std::tie(status, body) = client.request("POST", "/analysegame", R"({"fen": "startpos", "moves": ")" +
+                                                                         shuffle.substr(1) +
+                                                                         R"(", "depth": 20, "movetime": 500})");
+    REQUIRE(status == 200);
+    fields = parse(body);
+    REQUIRE(fields["plies"].find("\"ply\":80,") != std::string::npos);
+    REQUIRE(std::stol(fields["time_ms"]) < 2000);
+
+    REQUIRE(client.request("POST", "/analysegame", R"({"moves": "e2e4 e2e4"})").first == 400);
+    REQUIRE(client.request("POST", "/analysegame", R"({"fen": "startpos"})").first == 400);
+    REQUIRE(client.request("GET", "/analysegame").first == 405);
+}
+
+TEST_CASE("Server sessions keep a warm transposition table", "[server]") {
+    EngineServerOptions options;
+    options.workers = 2;
+    options.hash_mb = 1;
+    options.max_sessions = 2;
+    options.analysis_cache_entries = 0; // Measure the table, not the result cache
+    TestServer test(options);
+    Client client(test.server.port());
+
+    const std::string request =
+        R"({"fen": "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", "depth": 4, "session": "game-1"})";
+    auto first = parse(client.request("POST", "/move", request).second);
+    auto second = parse(client.request("POST", "/move", request).second);
+    REQUIRE(first["session"] == "game-1");
+    REQUIRE(std::stol(second["nodes"]) < std::stol(first["nodes"]));
+
+    // Sessions are bounded
+    client.request("POST", "/move", R"({"fen": "startpos", "depth": 1, "session": "game-2"})");
+    client.request("POST", "/move", R"({"fen": "startpos", "depth": 1, "session": "game-3"})");
+    REQUIRE(test.server.session_count() == 2);
+}
+
+TEST_CASE("Server handles concurrent clients", "[server]") {
+    EngineServerOptions options;
+    options.workers = 4;
+    options.hash_mb = 1;
+    TestServer test(options);
+
+    std::vector<std::thread> clients;
+    std::atomic<int> ok{0};
+    for (int i = 0; i < 8; i++) {
+        clients.emplace_back([&] {
+            Client client(test.server.port());
+            for (int j = 0; j < 3; j++) {
+                auto [status, body] = client.request("POST", "/move", R"({"fen": "startpos", "depth": 3})");
+                if (status == 200 && body.find("\"move\"") != std::string::npos) ok++;
+            }
+        });
+    }
+    for (auto& thread : clients) thread.join();
+    REQUIRE(ok == 24);
+}
+
+TEST_CASE("Server answers repeated positions from the analysis cache", "[server]") {
+    EngineServerOptions options;
+    options.workers = 1;
+    options.hash_mb = 1;
+    TestServer test(options);
+    Client client(test.server.port());
+
+    auto first = parse(client.request("POST", "/analyse", R"({"fen": "startpos", "depth": 4})").second);
+    REQUIRE(first.count("cached") == 0);
+
+    // Same depth or less: no search at all
+    auto again = parse(client.request("POST", "/analyse", R"({"fen": "startpos", "depth": 3})").second);
+    REQUIRE(again["cached"] == "true");
+    REQUIRE(again["nodes"] == "0");
+    REQUIRE(again["depth"] == "4");
+    REQUIRE(again["pv"] == first["pv"]);
+
+    // Deeper: resumes from the cached depth and replaces the entry
+    auto deeper = parse(client.request("POST", "/analyse", R"({"fen": "startpos", "depth": 5})").second);
+    REQUIRE(deeper["depth"] == "5");
+    REQUIRE(std::stol(deeper["nodes"]) > 0);
+    auto latest = parse(client.request("POST", "/move", R"({"fen": "startpos", "depth": 5})").second);
+    REQUIRE(latest["nodes"] == "0");
+    REQUIRE(latest["move"] == deeper["bestmove"]);
+}
+
+TEST_CASE("Server saves a session table and warm-starts from it", "[server]") {
+    std::string path = "/tmp/fianchetto-test-server-" + std::to_string(getpid()) + ".tt";
+    std::remove(path.c_str());
+    const std::string request =
+        R"({"fen": "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", "depth": 5, "session": "s"})";
+
+    EngineServerOptions options;
+    options.workers = 1;
+    options.hash_mb = 1;
+    options.analysis_cache_entries = 0;
+    options.hash_file = path;
+
+    long cold_nodes;
+    {
+        TestServer test(options);
+        Client client(test.server.port());
+        cold_nodes = std::stol(parse(client.request("POST", "/move", request).second)["nodes"]);
+        REQUIRE(client.request("POST", "/hash/save", R"({"session": "nobody"})").first == 404);
+        auto [status, body] = client.request("POST", "/hash/save", R"({"session": "s"})");
+        REQUIRE(status == 200);
+        REQUIRE(parse(body)["size_mb"] == "1");
+    }
+
+    // A restarted server maps the snapshot into new sessions
+    TestServer restarted(options);
+    Client client(restarted.server.port());
+    long warm_nodes = std::stol(parse(client.request("POST", "/move", request).second)["nodes"]);
+    REQUIRE(warm_nodes < cold_nodes);
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,63 @@
+#include <catch2/catch.hpp>
+#include "service_health.hpp"
+#include <chrono>
+#include <thread>
+
+using namespace fianchetto;
+
+TEST_CASE("Circuit breaker opens, probes and closes", "[health]") {
+    CircuitBreaker breaker(3, 20);
+
+    for (int i = 0; i < 2; i++) {
+        REQUIRE(breaker.allow());
+        breaker.record_failure();
+    }
+    REQUIRE_FALSE(breaker.is_open());
+
+    // A success resets the failure streak
+    breaker.record_success();
+    for (int i = 0; i < 3; i++) breaker.record_failure();
+    REQUIRE(breaker.is_open());
+    REQUIRE(breaker.trips() == 1);
+    REQUIRE_FALSE(breaker.allow());
+
+    // After the cooldown exactly one probe is let through; it fails
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    REQUIRE(breaker.allow());
+    REQUIRE_FALSE(breaker.allow());
+    breaker.record_failure();
+    REQUIRE(breaker.trips() == 2);
+    REQUIRE_FALSE(breaker.allow());
+
+    // The next probe succeeds and closes the breaker
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    REQUIRE(breaker.allow());
+    breaker.record_success();
+    REQUIRE_FALSE(breaker.is_open());
+    REQUIRE(breaker.allow());
+    REQUIRE(breaker.allow());
+}
+
+TEST_CASE("Latency histogram buckets and percentiles", "[health]") {
+    LatencyHistogram histogram;
+    REQUIRE(histogram.percentile_us(0.5) == 0);
+
+    histogram.record(0);
+    histogram.record(1);
+    histogram.record(2);
+    histogram.record(3);
+    histogram.record(1000);
+    REQUIRE(histogram.bucket(0) == 2);
+    REQUIRE(histogram.bucket(1) == 1);
+    REQUIRE(histogram.bucket(2) == 1);
+    REQUIRE(histogram.bucket(10) == 1); // (512, 1024]
+    REQUIRE(histogram.count() == 5);
+    REQUIRE(histogram.mean_us() == Approx(201.2));
+
+    REQUIRE(histogram.percentile_us(0.0) == 1);
+    REQUIRE(histogram.percentile_us(0.5) == 2);
+    REQUIRE(histogram.percentile_us(0.99) == 1024);
+
+    histogram.clear();
+    REQUIRE(histogram.count() == 0);
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch.hpp>
+#include "training_data.hpp"
+#include <fstream>
+#include <set>
+#include <thread>
+#include <unistd.h>
+
+using namespace fianchetto;
+
+TEST_CASE("Positions pack into 32 bytes", "[training]") {
+    Board board("r3k2r/8/8/3pP3/8/8/8/4K2R w Kkq d6 5 30");
+    PackedPosition packed = pack_position(board, -45, 1);
+
+    REQUIRE(packed.occupancy == board.all_pieces());
+    // Occupied squares in order: e1 (white king), h1 (white rook), d5, e5, ...
+    REQUIRE((packed.pieces[0] & 0xF) == 5);
+    REQUIRE((packed.pieces[0] >> 4) == 3);
+    REQUIRE((packed.pieces[1] & 0xF) == 6);  // d5: black pawn
+    REQUIRE((packed.pieces[1] >> 4) == 0);   // e5: white pawn
+    REQUIRE((packed.pieces[2] & 0xF) == 9);  // a8: black rook
+    REQUIRE((packed.pieces[2] >> 4) == 11);  // e8: black king
+    REQUIRE(packed.score == -45);
+    REQUIRE(packed.result == 1);
+    REQUIRE(packed.fullmove == 30);
+    REQUIRE(packed.halfmove == 5);
+    REQUIRE(packed.ep_square == square(3, 5));
+    REQUIRE(packed.flags == (2 | 8 | 16));
+
+    board.set_fen("4k3/8/8/8/8/8/8/4K3 b - - 0 1");
+    packed = pack_position(board, 40000, 0);
+    REQUIRE(packed.ep_square == PACKED_NO_EP);
+    REQUIRE(packed.flags == 1);
+    REQUIRE(packed.score == 32767);
+}
+
+TEST_CASE("Training writer appends buffers from many threads", "[training]") {
+    std::string path = "/tmp/fianchetto_training_" + std::to_string(getpid()) + ".bin";
+    const int threads = 4;
+    const int per_thread = 1000;
+    {
+        TrainingWriter writer(path);
+        REQUIRE(writer.is_open());
+
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&writer, t] {
+                Board board;
+                TrainingWriter::Buffer buffer(writer, 64);
+                for (int i = 0; i < per_thread; i++) buffer.add(pack_position(board, t * per_thread + i, 0));
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        REQUIRE(writer.ok());
+        REQUIRE(writer.records() == threads * per_thread);
+    }
+
+    // Every record arrives once and intact
+    std::ifstream file(path, std::ios::binary);
+    std::set<int> scores;
+    PackedPosition record;
+    while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        REQUIRE(record.occupancy == Board().all_pieces());
+        scores.insert(record.score);
+    }
+    REQUIRE(scores.size() == threads * per_thread);
+    unlink(path.c_str());
+}
+
+TEST_CASE("Packed positions round-trip through a mapped file", "[training]") {
+    const std::vector<std::string> fens = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/8/8/3pP3/8/8/8/4K2R w Kkq d6 5 30",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 3 12",
+        "4k3/8/8/8/8/8/8/4K3 b - - 99 200",
+    };
+    std::string path = "/tmp/fianchetto_packed_" + std::to_string(getpid()) + ".bin";
+    {
+        TrainingWriter writer(path);
+        TrainingWriter::Buffer buffer(writer);
+        for (size_t i = 0; i < fens.size(); i++) buffer.add(pack_position(Board(fens[i]), static_cast<int>(i), -1));
+    }
+
+    TrainingReader reader;
+    REQUIRE(reader.open(path));
+    REQUIRE(reader.size() == fens.size());
+    Board board;
+    for (size_t i = 0; i < fens.size(); i++) {
+        REQUIRE(packed_to_fen(reader[i]) == fens[i]);
+        REQUIRE(unpack_position(reader[i], board));
+        REQUIRE(board.hash() == Board(fens[i]).hash());
+        REQUIRE(reader[i].score == static_cast<int>(i));
+        REQUIRE(reader[i].result == -1);
+    }
+
+    PackedPosition empty{};
+    REQUIRE(packed_to_fen(empty).empty());
+    REQUIRE_FALSE(unpack_position(empty, board));
+
+    // A partial record is rejected
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file.put('x');
+    }
+    TrainingReader truncated;
+    REQUIRE_FALSE(truncated.open(path));
+    unlink(path.c_str());
+}
@@ -0,0 +1,184 @@
+#include <catch2/catch.hpp>
+#include "transposition_table.hpp"
+#include "search.hpp"
+#include <cstdio>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace fianchetto;
+
+namespace {
+
+const Move E2E4(square(4, 1), square(4, 3), PieceType::PAWN);
+
+std::string segment_name(const char* tag) {
+    return "/fianchetto-test-" + std::string(tag) + "-" + std::to_string(getpid());
+}
+
+} // namespace
+
+TEST_CASE("Transposition table stores packed entries", "[tt]") {
+    TranspositionTable tt(1);
+    TTEntry entry;
+    REQUIRE_FALSE(tt.probe(0x1234, entry));
+
+    tt.store(0x1234, 7, -SCORE_MATE + 5, E2E4, TT_LOWER);
+    REQUIRE(tt.probe(0x1234, entry));
+    REQUIRE(entry.depth == 7);
+    REQUIRE(entry.score == -SCORE_MATE + 5);
+    REQUIRE(entry.best_move == E2E4);
+    REQUIRE(entry.flag == TT_LOWER);
+
+    // Shallower results do not replace deeper ones from the same search
+    tt.store(0x1234, 3, 10, Move(), TT_EXACT);
+    REQUIRE(tt.probe(0x1234, entry));
+    REQUIRE(entry.depth == 7);
+
+    // Another position in the same slot is not returned for this key
+    uint64_t other = 0x1234 + tt.size();
+    REQUIRE_FALSE(tt.probe(other, entry));
+
+    // After aging, old entries miss and any depth replaces them
+    tt.age();
+    REQUIRE_FALSE(tt.probe(0x1234, entry));
+    tt.store(0x1234, 1, 10, Move(), TT_EXACT);
+    REQUIRE(tt.probe(0x1234, entry));
+    REQUIRE(entry.score == 10);
+
+    tt.clear();
+    REQUIRE_FALSE(tt.probe(0x1234, entry));
+}
+
+TEST_CASE("Shared transposition table is visible to every attachment", "[tt]") {
+    std::string name = segment_name("attach");
+    TranspositionTable::unlink_shared(name);
+
+    TranspositionTable first(2, name);
+    REQUIRE(first.shared());
+    // A later process uses the segment's size, not its own request
+    TranspositionTable second(8, name);
+    REQUIRE(second.shared());
+    REQUIRE(second.size() == first.size());
+    REQUIRE(second.size_mb() == 2);
+
+    TTEntry entry;
+    first.store(0xABCDEF, 5, 42, E2E4, TT_EXACT);
+    REQUIRE(second.probe(0xABCDEF, entry));
+    REQUIRE(entry.score == 42);
+
+    // The generation is shared as well
+    second.age();
+    REQUIRE_FALSE(first.probe(0xABCDEF, entry));
+
+    REQUIRE(TranspositionTable::unlink_shared(name));
+}
+
+TEST_CASE("Shared transposition table crosses process boundaries", "[tt]") {
+    std::string name = segment_name("fork");
+    TranspositionTable::unlink_shared(name);
+    TranspositionTable parent(1, name);
+    REQUIRE(parent.shared());
+
+    pid_t child = fork();
+    if (child == 0) {
+        // Fresh attachment in the child, as a separate engine would do
+        TranspositionTable tt(1, name);
+        for (uint64_t hash = 1; hash <= 1000; hash++) tt.store(hash * 0x9E3779B97F4A7C15ULL, 4, 7, E2E4, TT_EXACT);
+        _exit(tt.shared() ? 0 : 1);
+    }
+    int status = 0;
+    REQUIRE(waitpid(child, &status, 0) == child);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+
+    int found = 0;
+    TTEntry entry;
+    for (uint64_t hash = 1; hash <= 1000; hash++) {
+        if (parent.probe(hash * 0x9E3779B97F4A7C15ULL, entry) && entry.best_move == E2E4) found++;
+    }
+    REQUIRE(found > 900); // a few may share a slot
+
+    REQUIRE(TranspositionTable::unlink_shared(name));
+}
+
+TEST_CASE("Search runs on a shared table", "[tt]") {
+    std::string name = segment_name("search");
+    TranspositionTable::unlink_shared(name);
+    TranspositionTable tt(4, name);
+    REQUIRE(tt.shared());
+
+    Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    SearchParams params;
+    params.depth = 4;
+    SearchStats first, second;
+    Move best = search_root(board, tt, params, first);
+
+    // Another attachment picks up where the first search left off
+    TranspositionTable other(4, name);
+    REQUIRE(search_root(board, other, params, second) == best);
+    REQUIRE(second.nodes < first.nodes);
+
+    TranspositionTable::unlink_shared(name);
+}
+
+TEST_CASE("Transposition table snapshots round-trip through a file", "[tt]") {
+    std::string path = "/tmp/fianchetto-test-snapshot-" + std::to_string(getpid()) + ".tt";
+    TranspositionTable tt(2);
+    tt.age();
+    tt.store(0x5555, 9, -123, E2E4, TT_UPPER);
+    REQUIRE(tt.save(path));
+
+    // The loaded table takes the snapshot's size and generation
+    TranspositionTable loaded(1);
+    REQUIRE(loaded.load(path));
+    REQUIRE(loaded.from_snapshot());
+    REQUIRE(loaded.size() == tt.size());
+    TTEntry entry;
+    REQUIRE(loaded.probe(0x5555, entry));
+    REQUIRE(entry.depth == 9);
+    REQUIRE(entry.score == -123);
+    REQUIRE(entry.flag == TT_UPPER);
+
+    // Writes stay private to the process (copy-on-write)
+    loaded.store(0x5555, 20, 1, Move(), TT_EXACT);
+    TranspositionTable again(1);
+    REQUIRE(again.load(path));
+    REQUIRE(again.probe(0x5555, entry));
+    REQUIRE(entry.depth == 9);
+
+    // A missing file falls back to a fresh table
+    auto fallback = TranspositionTable::open_snapshot(path + ".missing", 1);
+    REQUIRE_FALSE(fallback->from_snapshot());
+    REQUIRE(fallback->size_mb() == 1);
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Transposition table rejects foreign snapshots", "[tt]") {
+    std::string path = "/tmp/fianchetto-test-foreign-" + std::to_string(getpid()) + ".tt";
+    TranspositionTable tt(1);
+    REQUIRE(tt.save(path));
+
+    auto patch = [&](long offset, uint64_t value, size_t length) {
+        FILE* file = std::fopen(path.c_str(), "r+b");
+        REQUIRE(file);
+        std::fseek(file, offset, SEEK_SET);
+        std::fwrite(&value, length, 1, file);
+        std::fclose(file);
+    };
+
+    TranspositionTable target(1);
+    patch(24, 0xDEADBEEF, 8); // Zobrist fingerprint
+    REQUIRE_FALSE(target.load(path));
+
+    REQUIRE(tt.save(path));
+    patch(8, 99, 4); // Format version
+    REQUIRE_FALSE(target.load(path));
+
+    REQUIRE(tt.save(path));
+    REQUIRE(truncate(path.c_str(), 1000) == 0);
+    REQUIRE_FALSE(target.load(path));
+    REQUIRE_FALSE(target.from_snapshot());
+
+    std::remove(path.c_str());
+}
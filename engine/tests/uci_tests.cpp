@@ -0,0 +1,55 @@
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// fianchetto_uci end to end: a command script in, the engine's output lines out
+
+namespace {
+
+std::vector<std::string> run_uci(const std::string& script) {
+    char path[] = "/tmp/fianchetto_uci_XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    close(fd);
+    std::ofstream(path) << script;
+
+    std::string command = std::string(FIANCHETTO_UCI_PATH) + " < " + path;
+    FILE* pipe = popen(command.c_str(), "r");
+    REQUIRE(pipe != nullptr);
+    std::vector<std::string> lines;
+    char buffer[4096];
+    while (fgets(buffer, sizeof(buffer), pipe)) lines.emplace_back(buffer);
+    REQUIRE(pclose(pipe) == 0);
+    unlink(path);
+    return lines;
+}
+
+// Depth of the last "info depth" line before each bestmove
+std::vector<int> reported_depths(const std::vector<std::string>& lines) {
+    std::vector<int> depths;
+    int depth = 0;
+    for (const std::string& line : lines) {
+        if (line.rfind("info depth ", 0) == 0) depth = std::stoi(line.substr(11));
+        if (line.rfind("bestmove ", 0) == 0) depths.push_back(depth);
+    }
+    return depths;
+}
+
+} // namespace
+
+TEST_CASE("UCI go limits last for one search only", "[uci]") {
+    // A node budget too small for depth 7 must not cut the searches after it short
+    auto depths = reported_depths(run_uci("position startpos moves e2e4 e7e5 g1f3\n"
+                                          "go nodes 500\n"
+                                          "go depth 7\n"
+                                          "position startpos moves d2d4\n"
+                                          "go depth 5\n"
+                                          "quit\n"));
+    REQUIRE(depths.size() == 3);
+    REQUIRE(depths[0] < 7);
+    REQUIRE(depths[1] == 7);
+    REQUIRE(depths[2] == 5);
+}
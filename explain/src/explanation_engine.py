@@ -1,11 +1,20 @@
 """
 Main explanation engine that combines features, Stockfish, and templates.
+
+When the engine's fianchetto_native module is importable, the reference
+evaluation and the features come from one in-process search and
+evaluation trace instead of a Stockfish process and Python feature code.
 """
 
 import chess
 from typing import Dict, List, Tuple
 from stockfish_client import StockfishClient
 from features import extract_features
+
+try:
+    from native_client import NativeClient
+except ImportError:
+    NativeClient = None
 from templates import generate_explanation
 
 
@@ -15,7 +24,11 @@ class ExplanationEngine:
     """
     
     def __init__(self, stockfish_path: str = None):
-        self.stockfish = StockfishClient(stockfish_path)
+        # An explicit Stockfish path keeps Stockfish as the reference
+        if NativeClient is not None and stockfish_path is None:
+            self.stockfish = NativeClient()
+        else:
+            self.stockfish = StockfishClient(stockfish_path)
         self.stockfish.start()
     
     def explain(
@@ -40,10 +53,20 @@ class ExplanationEngine:
         board = chess.Board(fen)
         
         # Get Stockfish evaluation
-        stockfish_cp, best_move = self.stockfish.evaluate(board, depth=10)
+        trace = None
+        if NativeClient is not None and isinstance(self.stockfish, NativeClient):
+            try:
+                stockfish_cp, best_move, trace = self.stockfish.analyse(board, depth=10)
+            except ValueError:
+                stockfish_cp, best_move = 0, None  # Positions the engine rejects
+        else:
+            stockfish_cp, best_move = self.stockfish.evaluate(board, depth=10)
         
         # Extract features
         features = extract_features(board)
+        if trace is not None:
+            for name, sides in trace["features"].items():
+                features.setdefault(name, sides["white"] - sides["black"])
         
         # Calculate delta
         delta_cp = fianchetto_eval - stockfish_cp
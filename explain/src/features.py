@@ -1,10 +1,19 @@
 """
 Positional feature extraction for explainability.
+
+The engine's fianchetto_native module computes the same features from
+bitboards when it is importable (engine built with -DBUILD_PYTHON=ON);
+otherwise they are computed here square by square.
 """
 
 import chess
 from typing import Dict, List
 
+try:
+    import fianchetto_native
+except ImportError:
+    fianchetto_native = None
+
 
 def extract_features(board: chess.Board) -> Dict[str, float]:
     """
@@ -13,6 +22,12 @@ def extract_features(board: chess.Board) -> Dict[str, float]:
     Returns:
         Dictionary of feature names to values
     """
+    if fianchetto_native is not None:
+        try:
+            return fianchetto_native.Board(board.fen()).features()
+        except ValueError:
+            pass  # Positions the engine rejects (e.g. missing kings)
+
     features = {}
     
     # Material balance
@@ -0,0 +1,54 @@
+"""
+In-process reference evaluation through the engine's fianchetto_native
+module (engine built with -DBUILD_PYTHON=ON), used instead of a Stockfish
+process when the module is importable.
+"""
+
+import chess
+from typing import Dict, Optional, Tuple
+
+import fianchetto_native
+
+MATE_CP = 30000
+
+
+class NativeClient:
+    """
+    Same interface as StockfishClient, backed by the engine's own search
+    and evaluation trace.
+    """
+
+    def __init__(self, hash_mb: int = 16):
+        self.tt = fianchetto_native.TranspositionTable(hash_mb)
+
+    def start(self):
+        pass
+
+    def stop(self):
+        pass
+
+    def analyse(self, board: chess.Board, depth: int = 10) -> Tuple[float, Optional[chess.Move], Dict]:
+        """
+        Search and trace the position in one call.
+
+        Returns:
+            (score, best_move, trace) with the score in centipawns from
+            white's point of view and the per-term evaluation trace
+        """
+        native = fianchetto_native.Board(board.fen())
+        trace = native.trace()
+        result = fianchetto_native.search(native, depth=depth, tt=self.tt)
+
+        if result["mate"] is not None:
+            cp = MATE_CP if result["mate"] > 0 else -MATE_CP
+        else:
+            cp = result["score"]
+        if board.turn == chess.BLACK:
+            cp = -cp
+
+        best_move = chess.Move.from_uci(result["bestmove"]) if result["bestmove"] else None
+        return cp, best_move, trace
+
+    def evaluate(self, board: chess.Board, depth: int = 10) -> Tuple[float, Optional[chess.Move]]:
+        cp, best_move, _ = self.analyse(board, depth)
+        return cp, best_move
@@ -2,7 +2,7 @@
 FastAPI inference server for neural evaluation.
 """
 
-from fastapi import FastAPI, HTTPException
+from fastapi import FastAPI, HTTPException, Request, Response
 from pydantic import BaseModel
 import torch
 import numpy as np
@@ -13,6 +13,11 @@ from model import load_model, create_model
 from encode import fen_to_planes
 
 
+# Binary batch encoding (see engine/include/neural_client.hpp): 12 little-endian
+# uint64 bitboards (white P N B R Q K, then black) plus one state byte
+BINARY_POSITION_SIZE = 12 * 8 + 1
+
+
 app = FastAPI(title="Fianchetto Neural Evaluation Service")
 
 # Global model
@@ -85,6 +90,42 @@ async def evaluate(request: EvaluateRequest):
         raise HTTPException(status_code=400, detail=f"Error evaluating position: {str(e)}")
 
 
+def decode_positions(data: bytes) -> np.ndarray:
+    """
+    Decode binary positions into (N, 12, 8, 8) planes laid out like
+    fen_to_planes (row 0 = rank 8, column 0 = file a).
+    """
+    records = np.frombuffer(data, dtype=np.uint8).reshape(-1, BINARY_POSITION_SIZE)
+    bitboards = records[:, :96].reshape(-1, 12, 8, 8)  # (N, plane, rank, byte)
+    # Bit f of byte r is square r * 8 + f, i.e. file f on rank r + 1
+    bits = np.unpackbits(bitboards, axis=-1, bitorder="little")  # (N, 12, 8 ranks, 8 files)
+    return np.ascontiguousarray(bits[:, :, ::-1, :], dtype=np.float32)
+
+
+@app.post("/evaluate_batch")
+async def evaluate_batch(request: Request):
+    """
+    Evaluate a batch of binary-encoded positions in one forward pass.
+    Returns one little-endian int32 centipawn score per position
+    (positive = white is better).
+    """
+    if model is None:
+        raise HTTPException(status_code=503, detail="Model not loaded")
+
+    data = await request.body()
+    if len(data) == 0 or len(data) % BINARY_POSITION_SIZE != 0:
+        raise HTTPException(status_code=400, detail="Body must be a multiple of 97 bytes")
+
+    planes = decode_positions(data)
+    input_tensor = torch.from_numpy(planes).to(device)
+
+    with torch.no_grad():
+        output = model(input_tensor).view(-1)
+
+    scores = (output.cpu().numpy() * 100).astype("<i4")  # Convert to centipawns
+    return Response(content=scores.tobytes(), media_type="application/octet-stream")
+
+
 if __name__ == "__main__":
     import uvicorn
     uvicorn.run(app, host="0.0.0.0", port=8000)
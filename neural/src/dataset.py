@@ -2,6 +2,7 @@
 Dataset loading and preprocessing for training.
 """
 
+import json
 import torch
 from torch.utils.data import Dataset, DataLoader
 import chess
@@ -86,6 +87,35 @@ def generate_synthetic_dataset(num_positions: int = 10000) -> tuple[list[str], l
     return positions, evaluations
 
 
+def load_engine_labels(
+    path: str,
+    max_positions: Optional[int] = None
+) -> tuple[list[str], list[float]]:
+    """
+    Load positions labeled by `fianchetto_analyse` (one JSON object per line).
+    Scores are converted to white's perspective; mates and unsearched
+    positions are skipped.
+    """
+    positions = []
+    evaluations = []
+
+    with open(path) as f:
+        for line in f:
+            if max_positions is not None and len(positions) >= max_positions:
+                break
+            record = json.loads(line)
+            if "mate" in record or record.get("bestmove") is None:
+                continue
+            fen = record["fen"]
+            score = float(record["score"])
+            if fen.split()[1] == "b":
+                score = -score
+            positions.append(fen)
+            evaluations.append(score)
+
+    return positions, evaluations
+
+
 def create_dataloader(
     positions: list[str],
     evaluations: list[float],
@@ -1,11 +1,20 @@
 """
 Board encoding: Convert FEN to tensor planes for neural network input.
+
+Uses the engine's fianchetto_native module (engine built with
+-DBUILD_PYTHON=ON, build directory on PYTHONPATH) when it is importable,
+and python-chess otherwise; both produce the same planes.
 """
 
 import numpy as np
 import chess
 import chess.pgn
 
+try:
+    import fianchetto_native
+except ImportError:
+    fianchetto_native = None
+
 
 def fen_to_planes(fen: str) -> np.ndarray:
     """
@@ -14,6 +23,12 @@ def fen_to_planes(fen: str) -> np.ndarray:
     
     Returns: (12, 8, 8) numpy array
     """
+    if fianchetto_native is not None:
+        try:
+            return fianchetto_native.Board(fen).planes()
+        except ValueError:
+            pass  # The engine rejects some FENs python-chess accepts
+
     board = chess.Board(fen)
     planes = np.zeros((12, 8, 8), dtype=np.float32)
     
@@ -53,6 +68,12 @@ def batch_encode(fens: list[str]) -> np.ndarray:
     
     Returns: (batch_size, 12, 8, 8) numpy array
     """
+    if fianchetto_native is not None:
+        try:
+            return fianchetto_native.encode_planes(fens)
+        except ValueError:
+            pass
+
     batch = np.stack([fen_to_planes(fen) for fen in fens])
     return batch
 
@@ -0,0 +1,61 @@
+"""
+Export a trained ChessEvalModel for native inference in the engine
+(engine/src/cnn_eval.cpp).
+
+Layout (little endian), mirrored in engine/include/cnn_eval.hpp:
+    char[4]  magic "FCNN"
+    uint32   version, hidden_dim
+    float32  state_dict tensors in declaration order
+             (conv1, conv2, conv3, fc1, fc2, fc3; weight then bias)
+"""
+
+import argparse
+import struct
+from pathlib import Path
+
+import numpy as np
+
+from model import ChessEvalModel, load_model
+
+FILE_MAGIC = b"FCNN"
+FILE_VERSION = 1
+LAYERS = ["conv1", "conv2", "conv3", "fc1", "fc2", "fc3"]
+
+
+def export_native(model: ChessEvalModel, output_path: str):
+    """
+    Write the model's float32 weights in the engine's native format.
+    """
+    model.eval()
+    state = model.state_dict()
+    hidden_dim = model.fc1.out_features
+
+    with open(output_path, "wb") as f:
+        f.write(FILE_MAGIC)
+        f.write(struct.pack("<2I", FILE_VERSION, hidden_dim))
+        for layer in LAYERS:
+            for param in ("weight", "bias"):
+                tensor = state[f"{layer}.{param}"].detach().cpu().numpy()
+                f.write(np.ascontiguousarray(tensor, dtype="<f4").tobytes())
+
+    print(f"Native weights exported to {output_path}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Export CNN model for native engine inference")
+    parser.add_argument("--model-path", type=str, required=True)
+    parser.add_argument("--output-path", type=str, default=None)
+
+    args = parser.parse_args()
+
+    if args.output_path is None:
+        args.output_path = str(Path(args.model_path).with_suffix(".fcnn"))
+
+    model = load_model(args.model_path)
+    if not isinstance(model, ChessEvalModel):
+        raise ValueError("Only models trained with --model-type cnn can be exported")
+    export_native(model, args.output_path)
+
+
+if __name__ == "__main__":
+    main()
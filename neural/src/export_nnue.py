@@ -0,0 +1,83 @@
+"""
+Export a trained NNUEModel to the engine's quantized binary format.
+
+Layout (little endian), mirrored in engine/include/nnue.hpp:
+    char[4]  magic "FNNU"
+    uint32   version, inputs, hidden, l1, l2
+    int32    output_scale
+    int16    ft_weights[inputs][hidden], ft_bias[hidden]
+    int8     l1_weights[l1][2 * hidden], int32 l1_bias[l1]
+    int8     l2_weights[l2][l1],         int32 l2_bias[l2]
+    int8     out_weights[l2],            int32 out_bias
+"""
+
+import argparse
+import struct
+from pathlib import Path
+
+import numpy as np
+import torch
+
+from model import NNUEModel, load_model
+
+FILE_MAGIC = b"FNNU"
+FILE_VERSION = 1
+
+# Quantization scales, must match engine/include/nnue.hpp
+ACTIVATION_MAX = 127  # Float activation 1.0
+WEIGHT_SCALE = 64     # Float weight 1.0 in hidden layers
+
+
+def _quantize(values: torch.Tensor, scale: float, dtype, limit: int) -> np.ndarray:
+    array = values.detach().cpu().numpy() * scale
+    return np.clip(np.round(array), -limit, limit).astype(dtype)
+
+
+def export_nnue(model: NNUEModel, output_path: str):
+    """
+    Quantize and write an NNUEModel. Clipping of int8 weights means hidden
+    layer weights should stay within [-127/64, 127/64] during training.
+    """
+    model.eval()
+    hidden = model.ft.out_features
+    l1 = model.l1.out_features
+    l2 = model.l2.out_features
+    hidden_bias_scale = ACTIVATION_MAX * WEIGHT_SCALE
+
+    with open(output_path, "wb") as f:
+        f.write(FILE_MAGIC)
+        f.write(struct.pack("<5I", FILE_VERSION, NNUEModel.INPUTS, hidden, l1, l2))
+        f.write(struct.pack("<i", NNUEModel.OUTPUT_SCALE))
+
+        # Feature transformer, stored feature-major so one feature is one column
+        f.write(_quantize(model.ft.weight.t(), ACTIVATION_MAX, "<i2", 32767).tobytes())
+        f.write(_quantize(model.ft.bias, ACTIVATION_MAX, "<i2", 32767).tobytes())
+
+        for layer in (model.l1, model.l2):
+            f.write(_quantize(layer.weight, WEIGHT_SCALE, "<i1", 127).tobytes())
+            f.write(_quantize(layer.bias, hidden_bias_scale, "<i4", 2**31 - 1).tobytes())
+
+        f.write(_quantize(model.out.weight.reshape(-1), WEIGHT_SCALE, "<i1", 127).tobytes())
+        f.write(_quantize(model.out.bias, hidden_bias_scale, "<i4", 2**31 - 1).tobytes())
+
+    print(f"NNUE weights exported to {output_path}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Export NNUE model to engine format")
+    parser.add_argument("--model-path", type=str, required=True)
+    parser.add_argument("--output-path", type=str, default=None)
+
+    args = parser.parse_args()
+
+    if args.output_path is None:
+        args.output_path = str(Path(args.model_path).with_suffix(".nnue"))
+
+    model = load_model(args.model_path)
+    if not isinstance(model, NNUEModel):
+        raise ValueError("Only models trained with --model-type nnue can be exported")
+    export_nnue(model, args.output_path)
+
+
+if __name__ == "__main__":
+    main()
@@ -73,18 +73,62 @@ class SimpleMLP(nn.Module):
         return x.squeeze(-1)
 
 
+class NNUEModel(nn.Module):
+    """
+    Efficiently updatable network evaluated in-process by the engine
+    (engine/src/nnue.cpp). Input: (batch, 12, 8, 8) planes.
+
+    Each perspective sees 768 piece-square features: its own pieces first,
+    with the board mirrored for black. A shared feature transformer maps both
+    to 256 neurons; the [white, black] halves go through a 32-32-1 head with
+    clipped ReLUs. Output is centipawns from white's perspective.
+    """
+
+    INPUTS = 768
+    OUTPUT_SCALE = 100  # Centipawns per unit of the final layer
+
+    def __init__(self, hidden_dim=256, l1_dim=32, l2_dim=32):
+        super().__init__()
+        self.ft = nn.Linear(self.INPUTS, hidden_dim)
+        self.l1 = nn.Linear(2 * hidden_dim, l1_dim)
+        self.l2 = nn.Linear(l1_dim, l2_dim)
+        self.out = nn.Linear(l2_dim, 1)
+
+    @staticmethod
+    def perspective_features(x):
+        """
+        Planes store rank 8 in row 0. Feature index is plane * 64 + square
+        (a1 = 0) for white; black swaps the color blocks and mirrors ranks,
+        which is exactly the plane row order.
+        """
+        white = x.flip(2).reshape(x.size(0), -1)
+        black = torch.cat([x[:, 6:], x[:, :6]], dim=1).reshape(x.size(0), -1)
+        return white, black
+
+    def forward(self, x):
+        white, black = self.perspective_features(x)
+        acc = torch.cat([self.ft(white), self.ft(black)], dim=1)
+        x = torch.clamp(acc, 0.0, 1.0)
+        x = torch.clamp(self.l1(x), 0.0, 1.0)
+        x = torch.clamp(self.l2(x), 0.0, 1.0)
+        x = self.out(x) * self.OUTPUT_SCALE
+        return x.squeeze(-1)
+
+
 def create_model(model_type: str = "cnn", **kwargs) -> nn.Module:
     """
     Factory function to create a model.
     
     Args:
-        model_type: "cnn" or "mlp"
+        model_type: "cnn", "mlp" or "nnue"
         **kwargs: Model-specific parameters
     """
     if model_type == "cnn":
         return ChessEvalModel(**kwargs)
     elif model_type == "mlp":
         return SimpleMLP(**kwargs)
+    elif model_type == "nnue":
+        return NNUEModel(**kwargs)
     else:
         raise ValueError(f"Unknown model type: {model_type}")
 
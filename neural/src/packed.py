@@ -0,0 +1,112 @@
+"""
+Reader for the engine's packed training positions (fianchetto_selfplay output).
+
+Each record is 32 bytes (see engine/include/training_data.hpp):
+
+    occupancy   uint64   occupied squares, a1 = bit 0
+    pieces      16 x u8  4-bit piece code per occupied square in square
+                         order, low nibble first; code = color * 6 + type
+                         (white pawn 0 .. black king 11)
+    score       int16    centipawns, white's point of view
+    fullmove    uint16
+    halfmove    uint8
+    ep_square   uint8    64 if none
+    flags       uint8    bit 0 black to move, bits 1-4 castling KQkq
+    result      int8     1 / 0 / -1 for white
+
+Files are mapped with numpy.memmap, so nothing is read until a batch is
+decoded, and decoding works on whole batches with array operations.
+"""
+
+from typing import Optional
+
+import numpy as np
+import torch
+from torch.utils.data import BatchSampler, DataLoader, Dataset, RandomSampler, SequentialSampler
+
+
+PACKED_DTYPE = np.dtype([
+    ("occupancy", "<u8"),
+    ("pieces", "u1", (16,)),
+    ("score", "<i2"),
+    ("fullmove", "<u2"),
+    ("halfmove", "u1"),
+    ("ep_square", "u1"),
+    ("flags", "u1"),
+    ("result", "i1"),
+])
+
+assert PACKED_DTYPE.itemsize == 32
+
+
+def open_packed(path: str) -> np.memmap:
+    """Map a file of packed records (read-only)."""
+    return np.memmap(path, dtype=PACKED_DTYPE, mode="r")
+
+
+def decode_planes(records: np.ndarray) -> np.ndarray:
+    """
+    Decode records to (N, 12, 8, 8) float32 planes, laid out like
+    encode.fen_to_planes (plane = color * 6 + piece type, row 0 = rank 8).
+    """
+    n = len(records)
+
+    # (N, 64) occupancy bits, a1 first
+    occupancy = np.ascontiguousarray(records["occupancy"]).astype("<u8", copy=False)
+    bits = np.unpackbits(occupancy.view(np.uint8).reshape(n, 8), axis=1, bitorder="little").astype(bool)
+
+    # (N, 32) piece codes in occupancy order
+    pieces = np.asarray(records["pieces"])
+    codes = np.empty((n, 32), dtype=np.uint8)
+    codes[:, 0::2] = pieces & 0x0F
+    codes[:, 1::2] = pieces >> 4
+
+    # The k-th occupied square holds the k-th code
+    order = np.clip(np.cumsum(bits, axis=1) - 1, 0, 31)
+    square_codes = np.take_along_axis(codes, order, axis=1)
+
+    planes = np.zeros((n, 12, 64), dtype=np.float32)
+    rows, squares = np.nonzero(bits)
+    planes[rows, square_codes[rows, squares], squares] = 1.0
+
+    # Square = rank * 8 + file; flip ranks so rank 8 is row 0
+    return planes.reshape(n, 12, 8, 8)[:, :, ::-1, :].copy()
+
+
+class PackedDataset(Dataset):
+    """
+    Dataset over a packed file. Indexing with a list of indices (as a
+    BatchSampler does) decodes the whole batch at once.
+    """
+
+    def __init__(self, path: str, start: int = 0, stop: Optional[int] = None):
+        self.records = open_packed(path)[start:stop]
+
+    def __len__(self):
+        return len(self.records)
+
+    def __getitem__(self, idx):
+        single = np.isscalar(idx)
+        indices = np.sort(np.atleast_1d(np.asarray(idx, dtype=np.int64)))
+        batch = self.records[indices]
+        planes = torch.from_numpy(decode_planes(batch))
+        scores = torch.from_numpy(batch["score"].astype(np.float32))
+        if single:
+            return planes[0], scores[0]
+        return planes, scores
+
+
+def create_packed_dataloader(
+    path: str,
+    batch_size: int = 32,
+    shuffle: bool = True,
+    start: int = 0,
+    stop: Optional[int] = None
+) -> DataLoader:
+    """
+    DataLoader yielding (planes, scores) batches of records [start, stop),
+    decoded straight from the memory-mapped file.
+    """
+    dataset = PackedDataset(path, start, stop)
+    sampler = RandomSampler(dataset) if shuffle else SequentialSampler(dataset)
+    return DataLoader(dataset, sampler=BatchSampler(sampler, batch_size, drop_last=False), batch_size=None)
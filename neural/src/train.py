@@ -10,8 +10,10 @@ import argparse
 import os
 from pathlib import Path
 
-from model import create_model
-from dataset import generate_synthetic_dataset, create_dataloader
+from model import create_model, load_model
+from dataset import generate_synthetic_dataset, load_engine_labels, create_dataloader
+from export_nnue import export_nnue
+from packed import create_packed_dataloader, open_packed
 
 
 def train_epoch(model, dataloader, criterion, optimizer, device):
@@ -58,13 +60,19 @@ def validate(model, dataloader, criterion, device):
 
 def main():
     parser = argparse.ArgumentParser(description="Train chess evaluation model")
-    parser.add_argument("--model-type", choices=["cnn", "mlp"], default="cnn")
+    parser.add_argument("--model-type", choices=["cnn", "mlp", "nnue"], default="cnn")
     parser.add_argument("--epochs", type=int, default=10)
     parser.add_argument("--batch-size", type=int, default=32)
     parser.add_argument("--learning-rate", type=float, default=0.001)
     parser.add_argument("--num-positions", type=int, default=10000)
     parser.add_argument("--output-dir", type=str, default="models")
     parser.add_argument("--device", type=str, default="cpu")
+    parser.add_argument("--export-nnue", type=str, default=None,
+                        help="Write the best nnue model to this path in the engine's binary format")
+    parser.add_argument("--labels", type=str, default=None,
+                        help="Train on positions labeled by fianchetto_analyse instead of synthetic data")
+    parser.add_argument("--packed", type=str, default=None,
+                        help="Train on a packed position file from fianchetto_selfplay (streamed, not loaded)")
     
     args = parser.parse_args()
     
@@ -74,22 +82,36 @@ def main():
     # Create output directory
     os.makedirs(args.output_dir, exist_ok=True)
     
-    # Generate dataset
-    print("Generating dataset...")
-    positions, evaluations = generate_synthetic_dataset(args.num_positions)
-    
-    # Split train/val
-    split_idx = int(0.8 * len(positions))
-    train_positions = positions[:split_idx]
-    train_evaluations = evaluations[:split_idx]
-    val_positions = positions[split_idx:]
-    val_evaluations = evaluations[split_idx:]
-    
-    # Create dataloaders
-    train_loader = create_dataloader(train_positions, train_evaluations, 
-                                     batch_size=args.batch_size, shuffle=True)
-    val_loader = create_dataloader(val_positions, val_evaluations,
-                                   batch_size=args.batch_size, shuffle=False)
+    if args.packed:
+        # Whole file, split train/val by position in the file
+        count = len(open_packed(args.packed))
+        split_idx = int(0.8 * count)
+        print(f"Streaming {count} positions from {args.packed}")
+        train_loader = create_packed_dataloader(args.packed, batch_size=args.batch_size,
+                                                shuffle=True, stop=split_idx)
+        val_loader = create_packed_dataloader(args.packed, batch_size=args.batch_size,
+                                              shuffle=False, start=split_idx)
+    else:
+        # Load or generate dataset
+        if args.labels:
+            print(f"Loading labels from {args.labels}...")
+            positions, evaluations = load_engine_labels(args.labels, args.num_positions)
+        else:
+            print("Generating dataset...")
+            positions, evaluations = generate_synthetic_dataset(args.num_positions)
+
+        # Split train/val
+        split_idx = int(0.8 * len(positions))
+        train_positions = positions[:split_idx]
+        train_evaluations = evaluations[:split_idx]
+        val_positions = positions[split_idx:]
+        val_evaluations = evaluations[split_idx:]
+
+        # Create dataloaders
+        train_loader = create_dataloader(train_positions, train_evaluations,
+                                         batch_size=args.batch_size, shuffle=True)
+        val_loader = create_dataloader(val_positions, val_evaluations,
+                                       batch_size=args.batch_size, shuffle=False)
     
     # Create model
     model = create_model(args.model_type).to(device)
@@ -121,6 +143,12 @@ def main():
     
     print("Training complete!")
 
+    if args.export_nnue:
+        if args.model_type != "nnue":
+            raise ValueError("--export-nnue requires --model-type nnue")
+        best_model = load_model(str(Path(args.output_dir) / "best_nnue.pt"))
+        export_nnue(best_model, args.export_nnue)
+
 
 if __name__ == "__main__":
     main()
@@ -6,7 +6,7 @@ const ENGINE_URL = process.env.ENGINE_URL || 'http://localhost:8080'
 export async function POST(request: NextRequest) {
   try {
     const body = await request.json()
-    const { fen, depth = 5 } = body
+    const { fen, depth = 5, session } = body
 
     if (!fen) {
       return NextResponse.json(
@@ -15,18 +15,12 @@ export async function POST(request: NextRequest) {
       )
     }
 
-    // Call engine service (simplified - in production would use UCI protocol)
-    // For now, return a placeholder
-    // In a real implementation, you would:
-    // 1. Start UCI engine process
-    // 2. Send "position fen <fen>"
-    // 3. Send "go depth <depth>"
-    // 4. Parse "bestmove" response
-
-    // Placeholder: return a random legal move
+    // Ask fianchetto_server for a move; fall back to a random legal move
+    // if the engine is unreachable
     const response = await axios.post(`${ENGINE_URL}/move`, {
       fen,
       depth,
+      ...(session ? { session } : {}),
     }).catch(() => {
       // Fallback: use chess.js to get a random move
       const { Chess } = require('chess.js')